@@ -0,0 +1,40 @@
+#ifndef HMDEV_MESSAGING_BENCHMARK_UTILS_H
+#define HMDEV_MESSAGING_BENCHMARK_UTILS_H
+
+#include <vector>
+#include <algorithm>
+#include <chrono>
+
+namespace hmdev {
+namespace messaging {
+namespace bench {
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * Microseconds elapsed since start
+ */
+inline double elapsedUs(Clock::time_point start) {
+    return std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+}
+
+/**
+ * Percentile of a sample set (nearest rank)
+ * @param samples Samples (sorted in place)
+ * @param p Percentile in [0, 100]
+ * @return Percentile value or 0 for an empty set
+ */
+inline double percentile(std::vector<double>& samples, double p) {
+    if (samples.empty()) {
+        return 0.0;
+    }
+    std::sort(samples.begin(), samples.end());
+    size_t rank = static_cast<size_t>(p / 100.0 * (samples.size() - 1) + 0.5);
+    return samples[std::min(rank, samples.size() - 1)];
+}
+
+} // namespace bench
+} // namespace messaging
+} // namespace hmdev
+
+#endif // HMDEV_MESSAGING_BENCHMARK_UTILS_H
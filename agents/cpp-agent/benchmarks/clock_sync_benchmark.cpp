@@ -0,0 +1,165 @@
+/**
+ * Clock Sync Benchmark
+ * UdpClient::serverNow() against a loopback time server whose clock is
+ * offset and drifting, with random queueing delay on the request path:
+ * error of the filtered estimate vs the latest raw sample over time
+ */
+
+#include "hmdev/messaging/api/udp_client.h"
+#include "hmdev/messaging/util/udp_codec.h"
+#include "benchmark_utils.h"
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <unistd.h>
+#include <cstring>
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+#include <thread>
+#include <atomic>
+#include <random>
+
+using namespace hmdev::messaging;
+using namespace hmdev::messaging::bench;
+
+/**
+ * Server clock: the local wall clock shifted by offsetUs and running driftPpm fast
+ */
+struct SkewedClock {
+    Clock::time_point start;
+    int64_t startUs;
+    int64_t offsetUs;
+    double driftPpm;
+
+    int64_t now() const {
+        double elapsedUs = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+        return startUs + offsetUs + static_cast<int64_t>(elapsedUs * (1.0 + driftPpm / 1e6));
+    }
+};
+
+static int bindLoopback(int& port) {
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    struct sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t addrLen = sizeof(addr);
+    if (fd < 0 || bind(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        getsockname(fd, reinterpret_cast<struct sockaddr*>(&addr), &addrLen) != 0) {
+        return -1;
+    }
+    port = ntohs(addr.sin_port);
+    return fd;
+}
+
+/**
+ * Answer "time" requests; each request is held for a random delay before it is stamped
+ */
+static void runTimeServer(int fd, const SkewedClock& clock, int jitterUs, std::atomic<bool>& running) {
+    std::mt19937 random(42);
+    std::uniform_int_distribution<int> jitter(0, std::max(0, jitterUs));
+    char buffer[2048];
+
+    while (running) {
+        struct pollfd pfd = {fd, POLLIN, 0};
+        if (poll(&pfd, 1, 50) <= 0) {
+            continue;
+        }
+        struct sockaddr_storage peer;
+        socklen_t peerLen = sizeof(peer);
+        ssize_t length = recvfrom(fd, buffer, sizeof(buffer), 0, reinterpret_cast<struct sockaddr*>(&peer), &peerLen);
+        if (length <= 0) {
+            continue;
+        }
+
+        json request = UdpCodec::decode(buffer, static_cast<size_t>(length));
+        if (request.is_discarded() || request.value("action", "") != "time") {
+            continue;
+        }
+
+        std::this_thread::sleep_for(std::chrono::microseconds(jitter(random)));  // Request path queueing
+        int64_t t1 = clock.now();
+        json reply = {{"action", "time"}, {"t0", request["payload"]["t0"]}, {"t1", t1}, {"t2", clock.now()}};
+        std::string datagram = reply.dump();
+        sendto(fd, datagram.data(), datagram.size(), 0, reinterpret_cast<struct sockaddr*>(&peer), peerLen);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    int seconds = 10;
+    int jitterUs = 4000;
+    int intervalMs = 200;
+
+    if (argc >= 2) seconds = std::stoi(argv[1]);
+    if (argc >= 3) jitterUs = std::stoi(argv[2]);
+    if (argc >= 4) intervalMs = std::stoi(argv[3]);
+
+    SkewedClock clock;
+    clock.start = Clock::now();
+    clock.startUs = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    clock.offsetUs = 2500000;
+    clock.driftPpm = 200.0;
+
+    int port = 0;
+    int server = bindLoopback(port);
+    if (server < 0) {
+        std::cerr << "Failed to bind time server" << std::endl;
+        return 1;
+    }
+    std::atomic<bool> running(true);
+    std::thread serverThread(runTimeServer, server, std::cref(clock), jitterUs, std::ref(running));
+
+    UdpClientConfig config;
+    config.addressFamily = AF_INET;
+    config.clockSync.intervalMs = intervalMs;
+    config.clockSync.fastIntervalMs = 20;
+    UdpClient client("127.0.0.1", port, config);
+
+    std::cout << "=== Clock Sync Benchmark ===" << std::endl;
+    std::cout << "Server clock: +" << clock.offsetUs / 1000 << " ms, " << clock.driftPpm << " ppm fast; "
+              << "request path delay 0-" << jitterUs << " us; ping every " << intervalMs << " ms" << std::endl;
+    std::cout << "error = estimate - true server time (us); raw = latest sample without filtering" << std::endl;
+    std::cout << std::endl;
+    std::cout << std::setw(6) << "t (s)" << std::setw(9) << "samples" << std::setw(10) << "rtt (us)"
+              << std::setw(12) << "error" << std::setw(12) << "raw error" << std::setw(12) << "drift ppm" << std::endl;
+
+    client.startClockSync();
+    std::vector<double> errors;
+    std::vector<double> rawErrors;
+    for (int tick = 1; tick <= seconds * 2; tick++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        int64_t estimate = client.serverNow();
+        int64_t truth = clock.now();
+        UdpClientStats stats = client.getStats();
+        int64_t localUs = std::chrono::duration_cast<std::chrono::microseconds>(
+            Clock::now().time_since_epoch()).count();
+        int64_t rawError = localUs + stats.clockSync.lastOffsetUs - clock.now();
+        int64_t error = estimate - truth;
+
+        // Skip convergence when summarizing
+        if (tick > 2) {
+            errors.push_back(static_cast<double>(std::llabs(error)));
+            rawErrors.push_back(static_cast<double>(std::llabs(rawError)));
+        }
+        if (tick % 2 == 0) {
+            std::cout << std::setw(6) << tick / 2 << std::setw(9) << stats.clockSync.samples
+                      << std::setw(10) << stats.clockSync.rttUs << std::setw(12) << error
+                      << std::setw(12) << rawError << std::fixed << std::setprecision(1)
+                      << std::setw(12) << stats.clockSync.driftPpm << std::endl;
+        }
+    }
+
+    client.stopClockSync();
+    client.stopReceiver();
+    running = false;
+    serverThread.join();
+    close(server);
+
+    std::cout << std::endl;
+    std::cout << std::fixed << std::setprecision(0)
+              << "|error| p50/p99 (us): filtered " << percentile(errors, 50) << " / " << percentile(errors, 99)
+              << ", raw " << percentile(rawErrors, 50) << " / " << percentile(rawErrors, 99) << std::endl;
+    return 0;
+}
@@ -0,0 +1,120 @@
+/**
+ * HTTP/2 Multiplexing Benchmark
+ * Compares push latency under an active long-poll for HTTP/1.1 and HTTP/2
+ */
+
+#include "hmdev/messaging/api/messaging_channel_api.h"
+#include "benchmark_utils.h"
+#include <iostream>
+#include <iomanip>
+#include <atomic>
+#include <memory>
+
+using namespace hmdev::messaging;
+using namespace hmdev::messaging::bench;
+
+// Keeps exactly one pull outstanding until stopped
+static void armLongPoll(MessagingChannelApi& api,
+                        const std::string& sessionId,
+                        const ReceiveConfig& config,
+                        std::shared_ptr<std::atomic<bool>> stopped) {
+    api.receiveAsync(sessionId, config, [&api, sessionId, config, stopped](const EventMessageResult& result) {
+        if (*stopped) {
+            return;
+        }
+        ReceiveConfig next = config;
+        if (result.globalOffset >= 0) next.globalOffset = result.globalOffset;
+        if (result.localOffset >= 0) next.localOffset = result.localOffset;
+        armLongPoll(api, sessionId, next, stopped);
+    });
+}
+
+static bool runMode(const std::string& label,
+                    HttpVersion version,
+                    const std::string& apiUrl,
+                    const std::string& apiKey,
+                    const std::string& channelName,
+                    const std::string& channelPassword,
+                    int pushCount) {
+    HttpClientConfig httpConfig;
+    httpConfig.httpVersion = version;
+
+    MessagingChannelApi api(apiUrl, apiKey, httpConfig);
+    ConnectResponse connectResp = api.connect(channelName, channelPassword, "http2-bench-" + label);
+    if (!connectResp.success) {
+        std::cerr << label << ": failed to connect" << std::endl;
+        return false;
+    }
+
+    ReceiveConfig config;
+    config.globalOffset = connectResp.globalOffset;
+    config.localOffset = connectResp.localOffset;
+    config.limit = 100;
+
+    auto stopped = std::make_shared<std::atomic<bool>>(false);
+    armLongPoll(api, connectResp.sessionId, config, stopped);
+
+    // Warm up connections before measuring
+    api.send(EventType::CUSTOM, "warmup", "*", connectResp.sessionId, false);
+
+    std::vector<double> latencies;
+    latencies.reserve(pushCount);
+    int failures = 0;
+
+    for (int i = 0; i < pushCount; i++) {
+        auto start = Clock::now();
+        bool sent = api.send(EventType::CUSTOM, "bench #" + std::to_string(i), "*",
+                             connectResp.sessionId, false);
+        double us = elapsedUs(start);
+        if (sent) {
+            latencies.push_back(us);
+        } else {
+            failures++;
+        }
+    }
+
+    *stopped = true;
+    api.disconnect(connectResp.sessionId);
+
+    std::cout << std::left << std::setw(10) << label
+              << std::right << std::fixed << std::setprecision(1)
+              << std::setw(12) << percentile(latencies, 50) / 1000.0
+              << std::setw(12) << percentile(latencies, 99) / 1000.0
+              << std::setw(10) << failures << std::endl;
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    // Default messaging service URL (production)
+    std::string apiUrl = "https://hmdevonline.com/messaging-platform/api/v1/messaging-service";
+    std::string apiKey = "your_api_key_here";
+    std::string channelName = "http2-bench";
+    std::string channelPassword = "benchpass";
+    int pushCount = 200;
+
+    if (argc >= 2) apiUrl = argv[1];
+    if (argc >= 3) apiKey = argv[2];
+    if (argc >= 4) channelName = argv[3];
+    if (argc >= 5) channelPassword = argv[4];
+    if (argc >= 6) pushCount = std::stoi(argv[5]);
+
+    std::cout << "=== HTTP/2 Multiplexing Benchmark ===" << std::endl;
+    std::cout << "API URL: " << apiUrl << std::endl;
+    std::cout << "Pushes per mode: " << pushCount << " (with one long-poll in flight)" << std::endl;
+    std::cout << std::endl;
+
+    std::cout << std::left << std::setw(10) << "mode"
+              << std::right << std::setw(12) << "p50 (ms)"
+              << std::setw(12) << "p99 (ms)"
+              << std::setw(10) << "failed" << std::endl;
+
+    try {
+        runMode("HTTP/1.1", HttpVersion::HTTP_1_1, apiUrl, apiKey, channelName, channelPassword, pushCount);
+        runMode("HTTP/2", HttpVersion::HTTP_2, apiUrl, apiKey, channelName, channelPassword, pushCount);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,189 @@
+/**
+ * Input Redundancy Benchmark
+ * 60 Hz GAME_INPUT over a simulated 40 ms one-way path with random and
+ * bursty loss: inputs lost, delivery delay and bytes per datagram of
+ * RedundantInputSender at several depths vs retransmitting lost inputs
+ * after a round trip
+ */
+
+#include "hmdev/messaging/util/input_redundancy.h"
+#include "benchmark_utils.h"
+#include <iostream>
+#include <iomanip>
+#include <queue>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace hmdev::messaging;
+using namespace hmdev::messaging::bench;
+
+static constexpr double TICK_MS = 1000.0 / 60.0;
+static constexpr double ONE_WAY_MS = 40.0;
+static constexpr double JITTER_MS = 5.0;
+static constexpr double RETRANSMIT_MS = 2 * ONE_WAY_MS + 20.0;  // RTT plus timer slack
+
+/**
+ * Random loss, or Gilbert-Elliott bursts averaging the same rate
+ */
+class LossModel {
+public:
+    LossModel(double lossPct, bool bursty) : random_(3), lossPct_(lossPct), bursty_(bursty), bad_(false) {}
+
+    bool lost() {
+        std::uniform_real_distribution<double> percent(0.0, 100.0);
+        if (!bursty_) {
+            return percent(random_) < lossPct_;
+        }
+        // Bursts of 4 datagrams on average, half of them lost
+        double enterBad = lossPct_ / (50.0 - lossPct_) * 25.0;
+        bad_ = bad_ ? percent(random_) >= 25.0 : percent(random_) < enterBad;
+        return bad_ && percent(random_) < 50.0;
+    }
+
+    double delay() {
+        std::uniform_real_distribution<double> jitter(0.0, JITTER_MS);
+        return ONE_WAY_MS + jitter(random_);
+    }
+
+private:
+    std::mt19937 random_;
+    double lossPct_;
+    bool bursty_;
+    bool bad_;
+};
+
+struct Result {
+    double lostPct;
+    double p50DelayMs;
+    double p99DelayMs;
+    double bytesPerDatagram;
+};
+
+static json makeInput(int tick) {
+    return json{{"t", tick}, {"move", {0.7, -0.2}}, {"buttons", tick % 4}};
+}
+
+/**
+ * Each lost transmission of an input is repeated a timer later
+ */
+static Result runRetransmit(int inputs, double lossPct, bool bursty) {
+    LossModel path(lossPct, bursty);
+    std::vector<double> delays;
+    size_t bytes = 0;
+    size_t datagrams = 0;
+    for (int tick = 1; tick <= inputs; tick++) {
+        std::string content = makeInput(tick).dump();
+        double waited = 0.0;
+        for (int attempt = 0; attempt < 10; attempt++) {
+            bytes += content.size() + 12;  // Sequence and acknowledgement header
+            datagrams++;
+            if (!path.lost()) {
+                delays.push_back(waited + path.delay());
+                break;
+            }
+            waited += RETRANSMIT_MS;
+        }
+    }
+    Result result;
+    result.lostPct = 100.0 * (inputs - delays.size()) / inputs;
+    result.p50DelayMs = percentile(delays, 50);
+    result.p99DelayMs = percentile(delays, 99);
+    result.bytesPerDatagram = static_cast<double>(bytes) / datagrams;
+    return result;
+}
+
+struct Event {
+    double time;
+    bool ack;
+    std::string content;
+
+    bool operator>(const Event& other) const { return time > other.time; }
+};
+
+static Result runRedundant(int inputs, double lossPct, bool bursty, size_t depth) {
+    LossModel path(lossPct, bursty);
+    InputRedundancyConfig config;
+    config.depth = depth;
+    RedundantInputSender sender(config);
+    RedundantInputReceiver receiver;
+    std::priority_queue<Event, std::vector<Event>, std::greater<Event>> events;
+    std::vector<double> delays;
+
+    for (int tick = 1; tick <= inputs; tick++) {
+        double now = tick * TICK_MS;
+        for (; !events.empty() && events.top().time <= now; events.pop()) {
+            const Event& event = events.top();
+            if (event.ack) {
+                sender.acknowledge(event.content);
+                continue;
+            }
+            std::vector<json> delivered;
+            receiver.receive(event.content, delivered);
+            for (const json& input : delivered) {
+                delays.push_back(event.time - input["t"].get<int>() * TICK_MS);
+            }
+            if (!path.lost()) {
+                events.push(Event{event.time + path.delay(), true, receiver.ack()});
+            }
+        }
+
+        std::string content = sender.encode(makeInput(tick));
+        if (!path.lost()) {
+            events.push(Event{now + path.delay(), false, content});
+        }
+    }
+    for (; !events.empty(); events.pop()) {
+        std::vector<json> delivered;
+        if (!events.top().ack) {
+            receiver.receive(events.top().content, delivered);
+            for (const json& input : delivered) {
+                delays.push_back(events.top().time - input["t"].get<int>() * TICK_MS);
+            }
+        }
+    }
+
+    InputRedundancySenderStats stats = sender.getStats();
+    Result result;
+    result.lostPct = 100.0 * receiver.getStats().lost / inputs;
+    result.p50DelayMs = percentile(delays, 50);
+    result.p99DelayMs = percentile(delays, 99);
+    result.bytesPerDatagram = static_cast<double>(stats.bytes) / stats.inputs;
+    return result;
+}
+
+static void print(const std::string& loss, const std::string& mode, const Result& result) {
+    std::cout << std::fixed << std::setprecision(1)
+              << std::setw(14) << loss << std::setw(14) << mode
+              << std::setw(10) << result.lostPct << std::setw(12) << result.p50DelayMs
+              << std::setw(12) << result.p99DelayMs << std::setprecision(0)
+              << std::setw(10) << result.bytesPerDatagram
+              << std::setw(10) << result.bytesPerDatagram * 8 * 60 / 1000.0 << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    int inputs = 36000;
+
+    if (argc >= 2) inputs = std::stoi(argv[1]);
+
+    std::cout << "=== Input Redundancy Benchmark ===" << std::endl;
+    std::cout << inputs << " inputs at 60 Hz, " << ONE_WAY_MS << "-" << ONE_WAY_MS + JITTER_MS
+              << " ms one way, acknowledgements on the same path; retransmit after "
+              << RETRANSMIT_MS << " ms" << std::endl;
+    std::cout << "lost = never delivered; delay = first send to delivery" << std::endl;
+    std::cout << std::endl;
+    std::cout << std::setw(14) << "loss" << std::setw(14) << "mode" << std::setw(10) << "lost %"
+              << std::setw(12) << "p50 (ms)" << std::setw(12) << "p99 (ms)" << std::setw(10) << "bytes"
+              << std::setw(10) << "kbit/s" << std::endl;
+
+    for (bool bursty : {false, true}) {
+        for (double lossPct : {1.0, 5.0, 20.0}) {
+            std::string loss = std::to_string(static_cast<int>(lossPct)) + "% " + (bursty ? "bursty" : "random");
+            print(loss, "retransmit", runRetransmit(inputs, lossPct, bursty));
+            for (size_t depth : {1, 2, 3, 4, 8}) {
+                print(loss, "depth " + std::to_string(depth), runRedundant(inputs, lossPct, bursty, depth));
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,174 @@
+/**
+ * Jitter Buffer Benchmark
+ * A 20 Hz GAME_STATE stream of a moving object over a simulated path with
+ * random delay and loss, rendered at 60 fps: latest snapshot as received vs
+ * SnapshotJitterBuffer interpolation with a fixed and an adaptive delay
+ */
+
+#include "hmdev/messaging/util/jitter_buffer.h"
+#include "benchmark_utils.h"
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <random>
+#include <string>
+#include <cmath>
+
+using namespace hmdev::messaging;
+using namespace hmdev::messaging::bench;
+
+static constexpr double PI = 3.14159265358979323846;
+
+/**
+ * Position of the simulated object at a sender time
+ */
+static double truth(double timeMs) {
+    return 100.0 * std::sin(2.0 * PI * timeMs / 2000.0);
+}
+
+struct Arrival {
+    double arrivalMs;
+    EventMessage message;
+};
+
+struct Result {
+    double latencyMs;    // Mean of now - rendered sender time
+    double frozenPct;    // Frames that did not move
+    double stepError;    // p99 |displayed step - true step|
+    uint64_t underruns;
+};
+
+static Clock::time_point at(double ms) {
+    return Clock::time_point(std::chrono::microseconds(static_cast<int64_t>(ms * 1000.0)));
+}
+
+/**
+ * Snapshots every intervalMs with delay baseMs + exponential(jitterMs), lossPct lost
+ */
+static std::vector<Arrival> simulate(int seconds, int intervalMs, double baseMs, double jitterMs, double lossPct) {
+    std::mt19937 random(7);
+    std::exponential_distribution<double> jitter(jitterMs > 0.0 ? 1.0 / jitterMs : 1.0);
+    std::uniform_real_distribution<double> loss(0.0, 100.0);
+    std::vector<Arrival> arrivals;
+    long long offset = 0;
+
+    // Start late enough that steady_clock time points stay positive
+    for (double sent = 10000.0; sent < 10000.0 + seconds * 1000.0; sent += intervalMs) {
+        offset++;
+        if (loss(random) < lossPct) {
+            continue;
+        }
+        Arrival arrival;
+        arrival.arrivalMs = sent + baseMs + (jitterMs > 0.0 ? jitter(random) : 0.0);
+        arrival.message.timestamp = static_cast<long long>(sent);
+        arrival.message.from = "player-1";
+        arrival.message.type = EventType::GAME_STATE;
+        arrival.message.content = std::to_string(truth(sent));
+        arrival.message.localOffset = offset;
+        arrivals.push_back(arrival);
+    }
+    std::sort(arrivals.begin(), arrivals.end(),
+              [](const Arrival& a, const Arrival& b) { return a.arrivalMs < b.arrivalMs; });
+    return arrivals;
+}
+
+/**
+ * Render at 60 fps; a null buffer shows the newest snapshot received so far
+ */
+static Result render(const std::vector<Arrival>& arrivals, SnapshotJitterBuffer* buffer) {
+    const double frameMs = 1000.0 / 60.0;
+    size_t next = 0;
+    long long newest = -1;
+    double shown = 0.0;
+    double previous = 0.0;
+    double latency = 0.0;
+    size_t frames = 0;
+    size_t frozen = 0;
+    std::vector<double> stepErrors;
+
+    double end = arrivals.back().arrivalMs;
+    for (double now = arrivals.front().arrivalMs + 500.0; now < end; now += frameMs) {
+        for (; next < arrivals.size() && arrivals[next].arrivalMs <= now; next++) {
+            const EventMessage& message = arrivals[next].message;
+            if (buffer) {
+                buffer->push(message, at(arrivals[next].arrivalMs));
+            } else if (message.timestamp > newest) {
+                newest = message.timestamp;
+                shown = std::stod(message.content);
+            }
+        }
+
+        double renderedMs = static_cast<double>(newest);
+        if (buffer) {
+            SnapshotPair pair;
+            if (!buffer->sample("player-1", at(now), pair)) {
+                continue;
+            }
+            double from = std::stod(pair.from->content);
+            shown = from + pair.alpha * (std::stod(pair.to->content) - from);
+            renderedMs = pair.renderTimestampMs;
+        }
+
+        // Skip the warm-up
+        if (now > arrivals.front().arrivalMs + 2000.0) {
+            frames++;
+            latency += now - renderedMs;
+            frozen += shown == previous ? 1 : 0;
+            stepErrors.push_back(std::fabs((shown - previous) - (truth(now) - truth(now - frameMs))));
+        }
+        previous = shown;
+    }
+
+    Result result;
+    result.latencyMs = latency / frames;
+    result.frozenPct = 100.0 * frozen / frames;
+    result.stepError = percentile(stepErrors, 99);
+    result.underruns = buffer ? buffer->getStats().underruns : 0;
+    return result;
+}
+
+int main(int argc, char* argv[]) {
+    int seconds = 60;
+    int intervalMs = 50;
+    double lossPct = 2.0;
+
+    if (argc >= 2) seconds = std::stoi(argv[1]);
+    if (argc >= 3) intervalMs = std::stoi(argv[2]);
+    if (argc >= 4) lossPct = std::stod(argv[3]);
+
+    std::cout << "=== Jitter Buffer Benchmark ===" << std::endl;
+    std::cout << seconds << " s of snapshots every " << intervalMs << " ms, 30 ms + exponential jitter, "
+              << lossPct << "% loss, rendered at 60 fps" << std::endl;
+    std::cout << "step error = p99 |displayed frame step - true frame step| (object amplitude 100)" << std::endl;
+    std::cout << std::endl;
+    std::cout << std::setw(12) << "jitter (ms)" << std::setw(16) << "mode" << std::setw(14) << "latency (ms)"
+              << std::setw(12) << "frozen %" << std::setw(12) << "step error" << std::setw(11) << "underruns"
+              << std::setw(11) << "delay (ms)" << std::endl;
+
+    for (double jitterMs : {0.0, 5.0, 20.0, 50.0}) {
+        std::vector<Arrival> arrivals = simulate(seconds, intervalMs, 30.0, jitterMs, lossPct);
+
+        JitterBufferConfig fixedConfig;
+        fixedConfig.minDelayMs = intervalMs;
+        fixedConfig.maxDelayMs = intervalMs;
+        SnapshotJitterBuffer fixed(fixedConfig);
+        SnapshotJitterBuffer adaptive;
+
+        struct Mode { const char* name; SnapshotJitterBuffer* buffer; };
+        for (const Mode& mode : {Mode{"latest", nullptr}, Mode{"fixed delay", &fixed}, Mode{"adaptive", &adaptive}}) {
+            Result result = render(arrivals, mode.buffer);
+            std::cout << std::fixed << std::setprecision(1)
+                      << std::setw(12) << jitterMs << std::setw(16) << mode.name
+                      << std::setw(14) << result.latencyMs << std::setw(12) << result.frozenPct
+                      << std::setw(12) << std::setprecision(2) << result.stepError
+                      << std::setw(11) << result.underruns << std::setprecision(1) << std::setw(11);
+            if (mode.buffer) {
+                std::cout << mode.buffer->getSenderStats("player-1").delayMs;
+            } else {
+                std::cout << "-";
+            }
+            std::cout << std::endl;
+        }
+    }
+    return 0;
+}
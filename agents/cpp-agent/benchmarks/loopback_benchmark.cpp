@@ -0,0 +1,134 @@
+/**
+ * Loopback Benchmark
+ * Measures client-stack push latency and receive throughput against the
+ * in-process LoopbackServer (no network, deterministic)
+ */
+
+#include "hmdev/messaging/api/messaging_channel_api.h"
+#include "hmdev/messaging/api/loopback_server.h"
+#include "hmdev/messaging/api/receive_pipeline.h"
+#include "benchmark_utils.h"
+#include <iostream>
+#include <iomanip>
+#include <memory>
+#include <thread>
+
+using namespace hmdev::messaging;
+using namespace hmdev::messaging::bench;
+
+static std::unique_ptr<MessagingChannelApi> createAgent(const std::shared_ptr<LoopbackServer>& server) {
+    return std::make_unique<MessagingChannelApi>(server->createHttpTransport(),
+                                                 server->createUdpTransport());
+}
+
+// Latency columns are left blank for throughput-only rows (negative values)
+static void printRow(const std::string& label, double p50Us, double p99Us, double perSecond) {
+    std::cout << std::left << std::setw(16) << label
+              << std::right << std::fixed << std::setprecision(1);
+    if (p50Us >= 0) {
+        std::cout << std::setw(12) << p50Us << std::setw(12) << p99Us;
+    } else {
+        std::cout << std::setw(12) << "-" << std::setw(12) << "-";
+    }
+    std::cout << std::setw(14) << perSecond << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    int messageCount = 100000;
+    int batchLimit = 100;
+
+    if (argc >= 2) messageCount = std::stoi(argv[1]);
+    if (argc >= 3) batchLimit = std::stoi(argv[2]);
+
+    std::cout << "=== Loopback Benchmark ===" << std::endl;
+    std::cout << "Messages: " << messageCount << ", batch limit: " << batchLimit << std::endl;
+    std::cout << std::endl;
+
+    auto server = std::make_shared<LoopbackServer>(100);
+    auto sender = createAgent(server);
+    auto receiver = createAgent(server);
+
+    ConnectResponse senderResp = sender->connect("loopback-bench", "benchpass", "sender");
+    ConnectResponse receiverResp = receiver->connect("loopback-bench", "benchpass", "receiver");
+    if (!senderResp.success || !receiverResp.success) {
+        std::cerr << "Failed to connect to loopback server" << std::endl;
+        return 1;
+    }
+
+    std::cout << std::left << std::setw(16) << "operation"
+              << std::right << std::setw(12) << "p50 (us)"
+              << std::setw(12) << "p99 (us)"
+              << std::setw(14) << "ops/s" << std::endl;
+
+    // Synchronous push latency
+    std::vector<double> latencies;
+    latencies.reserve(messageCount);
+    auto start = Clock::now();
+    for (int i = 0; i < messageCount; i++) {
+        auto pushStart = Clock::now();
+        sender->send(EventType::CUSTOM, "sync #" + std::to_string(i), "*", senderResp.sessionId, false);
+        latencies.push_back(elapsedUs(pushStart));
+    }
+    double seconds = elapsedUs(start) / 1e6;
+    printRow("push", percentile(latencies, 50), percentile(latencies, 99), messageCount / seconds);
+
+    // Asynchronous push throughput
+    start = Clock::now();
+    std::vector<std::future<bool>> pending;
+    pending.reserve(messageCount);
+    for (int i = 0; i < messageCount; i++) {
+        pending.push_back(sender->sendAsync(EventType::CUSTOM, "async #" + std::to_string(i), "*",
+                                            senderResp.sessionId, false));
+    }
+    for (auto& sent : pending) {
+        sent.get();
+    }
+    seconds = elapsedUs(start) / 1e6;
+    printRow("pushAsync", -1, -1, messageCount / seconds);
+
+    // Drain both rounds with a plain loop, then push again and drain with the pipeline
+    size_t total = static_cast<size_t>(messageCount) * 2;
+    ReceiveConfig config(receiverResp.globalOffset, receiverResp.localOffset, batchLimit);
+
+    latencies.clear();
+    size_t received = 0;
+    start = Clock::now();
+    while (received < total) {
+        auto pullStart = Clock::now();
+        EventMessageResult result = receiver->receive(receiverResp.sessionId, config);
+        latencies.push_back(elapsedUs(pullStart));
+        if (result.messages.empty()) break;
+        config.globalOffset = result.globalOffset;
+        config.localOffset = result.localOffset;
+        received += result.messages.size();
+    }
+    seconds = elapsedUs(start) / 1e6;
+    printRow("pull", percentile(latencies, 50), percentile(latencies, 99), received / seconds);
+
+    for (int i = 0; i < messageCount; i++) {
+        sender->sendAsync(EventType::CUSTOM, "pipeline #" + std::to_string(i), "*",
+                          senderResp.sessionId, false, nullptr);
+    }
+    while (server->getStats().messages < static_cast<uint64_t>(messageCount) * 3) {
+        std::this_thread::yield();
+    }
+
+    received = 0;
+    {
+        ReceivePipeline pipeline(*receiver, receiverResp.sessionId, config);
+        while (received < static_cast<size_t>(messageCount)) {
+            EventMessageResult result = pipeline.next();
+            if (result.messages.empty()) break;
+            received += result.messages.size();
+        }
+        printRow("pull (pipeline)", -1, -1, pipeline.getStats().messagesPerSecond());
+    }
+
+    receiver->disconnect(receiverResp.sessionId);
+    sender->disconnect(senderResp.sessionId);
+
+    LoopbackServerStats stats = server->getStats();
+    std::cout << std::endl << "Server handled " << stats.requests << " requests, stored "
+              << stats.messages << " messages" << std::endl;
+    return 0;
+}
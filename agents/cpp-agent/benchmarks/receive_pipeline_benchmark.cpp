@@ -0,0 +1,154 @@
+/**
+ * Receive Pipeline Benchmark
+ * Compares drain throughput of a plain receive() loop and a ReceivePipeline
+ */
+
+#include "hmdev/messaging/api/messaging_channel_api.h"
+#include "hmdev/messaging/api/receive_pipeline.h"
+#include "benchmark_utils.h"
+#include <iostream>
+#include <iomanip>
+#include <thread>
+
+using namespace hmdev::messaging;
+using namespace hmdev::messaging::bench;
+
+// Stand-in for application work on each batch
+static void processBatch(const EventMessageResult& result, int processMs) {
+    if (!result.messages.empty() && processMs > 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(processMs));
+    }
+}
+
+// Pushes messageCount messages from a second agent, then returns
+static bool fillChannel(const std::string& apiUrl,
+                        const std::string& apiKey,
+                        const std::string& channelName,
+                        const std::string& channelPassword,
+                        int messageCount) {
+    MessagingChannelApi sender(apiUrl, apiKey);
+    ConnectResponse resp = sender.connect(channelName, channelPassword, "pipeline-bench-sender");
+    if (!resp.success) {
+        std::cerr << "Sender failed to connect" << std::endl;
+        return false;
+    }
+
+    std::vector<std::future<bool>> pending;
+    pending.reserve(messageCount);
+    for (int i = 0; i < messageCount; i++) {
+        pending.push_back(sender.sendAsync(EventType::CUSTOM, "bench #" + std::to_string(i),
+                                           "*", resp.sessionId, false));
+    }
+    for (auto& sent : pending) {
+        sent.get();
+    }
+
+    sender.disconnect(resp.sessionId);
+    return true;
+}
+
+static void runMode(const std::string& label,
+                    bool pipelined,
+                    const std::string& apiUrl,
+                    const std::string& apiKey,
+                    const std::string& channelName,
+                    const std::string& channelPassword,
+                    int messageCount,
+                    int batchLimit,
+                    int processMs) {
+    MessagingChannelApi api(apiUrl, apiKey);
+    ConnectResponse resp = api.connect(channelName, channelPassword, "pipeline-bench-" + label);
+    if (!resp.success) {
+        std::cerr << label << ": failed to connect" << std::endl;
+        return;
+    }
+
+    ReceiveConfig config(resp.globalOffset, resp.localOffset, batchLimit);
+
+    if (!fillChannel(apiUrl, apiKey, channelName, channelPassword, messageCount)) {
+        api.disconnect(resp.sessionId);
+        return;
+    }
+
+    size_t received = 0;
+    uint64_t batches = 0;
+    auto start = Clock::now();
+
+    if (pipelined) {
+        ReceivePipeline pipeline(api, resp.sessionId, config);
+        while (received < static_cast<size_t>(messageCount)) {
+            EventMessageResult result = pipeline.next();
+            if (result.globalOffset < 0) {
+                std::cerr << label << ": pull failed" << std::endl;
+                break;
+            }
+            received += result.messages.size();
+            batches++;
+            processBatch(result, processMs);
+        }
+    } else {
+        while (received < static_cast<size_t>(messageCount)) {
+            EventMessageResult result = api.receive(resp.sessionId, config);
+            if (result.globalOffset < 0) {
+                std::cerr << label << ": pull failed" << std::endl;
+                break;
+            }
+            config.globalOffset = result.globalOffset;
+            if (result.localOffset >= 0) config.localOffset = result.localOffset;
+            received += result.messages.size();
+            batches++;
+            processBatch(result, processMs);
+        }
+    }
+
+    double seconds = elapsedUs(start) / 1e6;
+    api.disconnect(resp.sessionId);
+
+    std::cout << std::left << std::setw(10) << label
+              << std::right << std::fixed << std::setprecision(1)
+              << std::setw(12) << received
+              << std::setw(10) << batches
+              << std::setw(14) << (seconds > 0 ? received / seconds : 0.0) << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    // Default messaging service URL (production)
+    std::string apiUrl = "https://hmdevonline.com/messaging-platform/api/v1/messaging-service";
+    std::string apiKey = "your_api_key_here";
+    std::string channelName = "pipeline-bench";
+    std::string channelPassword = "benchpass";
+    int messageCount = 1000;
+    int batchLimit = 20;
+    int processMs = 5;
+
+    if (argc >= 2) apiUrl = argv[1];
+    if (argc >= 3) apiKey = argv[2];
+    if (argc >= 4) channelName = argv[3];
+    if (argc >= 5) channelPassword = argv[4];
+    if (argc >= 6) messageCount = std::stoi(argv[5]);
+    if (argc >= 7) batchLimit = std::stoi(argv[6]);
+    if (argc >= 8) processMs = std::stoi(argv[7]);
+
+    std::cout << "=== Receive Pipeline Benchmark ===" << std::endl;
+    std::cout << "API URL: " << apiUrl << std::endl;
+    std::cout << "Messages: " << messageCount << ", batch limit: " << batchLimit
+              << ", processing: " << processMs << " ms/batch" << std::endl;
+    std::cout << std::endl;
+
+    std::cout << std::left << std::setw(10) << "mode"
+              << std::right << std::setw(12) << "messages"
+              << std::setw(10) << "batches"
+              << std::setw(14) << "msgs/s" << std::endl;
+
+    try {
+        runMode("plain", false, apiUrl, apiKey, channelName, channelPassword,
+                messageCount, batchLimit, processMs);
+        runMode("pipeline", true, apiUrl, apiKey, channelName, channelPassword,
+                messageCount, batchLimit, processMs);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
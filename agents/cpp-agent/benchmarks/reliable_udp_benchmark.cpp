@@ -0,0 +1,235 @@
+/**
+ * Reliable UDP Benchmark
+ * Goodput and delivery latency of unreliable, reliable and reliable-ordered
+ * UDP messages between two UdpClients through a lossy loopback relay
+ */
+
+#include "hmdev/messaging/api/udp_client.h"
+#include "benchmark_utils.h"
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <unistd.h>
+#include <cstring>
+#include <iostream>
+#include <iomanip>
+#include <thread>
+#include <atomic>
+#include <random>
+#include <deque>
+
+using namespace hmdev::messaging;
+using namespace hmdev::messaging::bench;
+
+/**
+ * Relay between the first two peers that send to it; drops each datagram
+ * with the given probability and delays the rest by a fixed one-way delay
+ */
+class LossyRelay {
+public:
+    LossyRelay(double lossRate, int delayMs)
+        : lossRate_(lossRate), delay_(std::chrono::milliseconds(delayMs)), running_(true),
+          fd_(socket(AF_INET, SOCK_DGRAM, 0)), port_(0) {
+        struct sockaddr_in addr;
+        std::memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t addrLen = sizeof(addr);
+        if (fd_ >= 0 && bind(fd_, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) == 0 &&
+            getsockname(fd_, reinterpret_cast<struct sockaddr*>(&addr), &addrLen) == 0) {
+            port_ = ntohs(addr.sin_port);
+        }
+        thread_ = std::thread(&LossyRelay::run, this);
+    }
+
+    ~LossyRelay() {
+        running_ = false;
+        thread_.join();
+        if (fd_ >= 0) {
+            ::close(fd_);
+        }
+    }
+
+    int port() const { return port_; }
+
+private:
+    struct Delayed {
+        Clock::time_point due;
+        std::string data;
+        int peer;
+    };
+
+    const double lossRate_;
+    const Clock::duration delay_;
+    std::atomic<bool> running_;
+    int fd_;
+    int port_;
+    std::thread thread_;
+
+    void run() {
+        std::mt19937 rng(7);
+        std::uniform_real_distribution<double> roll(0.0, 1.0);
+        struct sockaddr_in peers[2];
+        int peerCount = 0;
+        std::deque<Delayed> queue;
+        char buffer[65536];
+
+        while (running_) {
+            int waitMs = queue.empty() ? 5 : 0;
+            struct pollfd pfd = {fd_, POLLIN, 0};
+            poll(&pfd, 1, waitMs);
+
+            auto now = Clock::now();
+            while (!queue.empty() && queue.front().due <= now) {
+                const Delayed& item = queue.front();
+                sendto(fd_, item.data.data(), item.data.size(), 0,
+                       reinterpret_cast<const struct sockaddr*>(&peers[item.peer]), sizeof(peers[0]));
+                queue.pop_front();
+            }
+
+            while (true) {
+                struct sockaddr_in from;
+                socklen_t fromLen = sizeof(from);
+                ssize_t received = recvfrom(fd_, buffer, sizeof(buffer), MSG_DONTWAIT,
+                                            reinterpret_cast<struct sockaddr*>(&from), &fromLen);
+                if (received <= 0) {
+                    break;
+                }
+
+                int sender = -1;
+                for (int i = 0; i < peerCount; i++) {
+                    if (peers[i].sin_port == from.sin_port && peers[i].sin_addr.s_addr == from.sin_addr.s_addr) {
+                        sender = i;
+                    }
+                }
+                if (sender < 0) {
+                    if (peerCount < 2) {
+                        peers[peerCount++] = from;
+                    }
+                    continue;  // Registration datagram
+                }
+                if (peerCount < 2 || roll(rng) < lossRate_) {
+                    continue;
+                }
+                queue.push_back(Delayed{now + delay_, std::string(buffer, received), 1 - sender});
+            }
+        }
+    }
+};
+
+static void runCase(const std::string& mode, UdpDelivery delivery, double lossRate,
+                    int messages, int rate, int payloadBytes, int delayMs) {
+    LossyRelay relay(lossRate, delayMs);
+
+    UdpClientConfig config;
+    config.addressFamily = AF_INET;
+    UdpClient sender("127.0.0.1", relay.port(), config);
+    UdpClient receiver("127.0.0.1", relay.port(), config);
+
+    std::vector<std::atomic<int64_t>> sentAtUs(messages);
+    std::vector<double> latencies;
+    latencies.reserve(messages);
+    std::atomic<int> delivered(0);
+    std::atomic<int64_t> lastDeliveryUs(0);
+    int outOfOrder = 0;
+    int lastId = -1;
+    auto start = Clock::now();
+
+    // Callback runs on the receiver's thread only
+    receiver.startReceiver([&](const json& message) {
+        int id = message["payload"]["id"].get<int>();
+        int64_t nowUs = static_cast<int64_t>(elapsedUs(start));
+        latencies.push_back(static_cast<double>(nowUs - sentAtUs[id].load()));
+        if (id < lastId) {
+            outOfOrder++;
+        }
+        lastId = id;
+        lastDeliveryUs = nowUs;
+        delivered++;
+    });
+
+    // Register sender first, then receiver, with the relay
+    sender.send(UdpEnvelope("hello", json::object()));
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    receiver.send(UdpEnvelope("hello", json::object()));
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    std::string content(payloadBytes, 'x');
+    start = Clock::now();
+    auto interval = std::chrono::nanoseconds(1000000000LL / rate);
+    for (int i = 0; i < messages; i++) {
+        std::this_thread::sleep_until(start + interval * i);
+        UdpEnvelope envelope("push", json{{"id", i}, {"content", content}});
+        sentAtUs[i] = static_cast<int64_t>(elapsedUs(start));
+        if (delivery == UdpDelivery::UNRELIABLE) {
+            sender.send(envelope);
+        } else {
+            sender.sendReliable(envelope, 0, delivery == UdpDelivery::RELIABLE_ORDERED);
+        }
+    }
+
+    // Wait for all messages, or until nothing has arrived for a while
+    int lastCount = -1;
+    auto idleSince = Clock::now();
+    while (delivered < messages) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        if (delivered != lastCount) {
+            lastCount = delivered;
+            idleSince = Clock::now();
+        } else if (Clock::now() - idleSince > std::chrono::seconds(3)) {
+            break;
+        }
+    }
+    receiver.stopReceiver();
+
+    double goodputKBps = delivered * static_cast<double>(payloadBytes) / 1024.0 /
+                         (std::max<int64_t>(1, lastDeliveryUs.load()) / 1e6);
+    ReliableUdpStats stats = sender.getStats().reliability;
+
+    std::cout << std::left << std::setw(10) << mode
+              << std::right << std::fixed << std::setprecision(1)
+              << std::setw(7) << lossRate * 100
+              << std::setw(10) << delivered.load()
+              << std::setw(10) << percentile(latencies, 50) / 1000.0
+              << std::setw(10) << percentile(latencies, 99) / 1000.0
+              << std::setw(10) << percentile(latencies, 99.9) / 1000.0
+              << std::setw(10) << percentile(latencies, 100) / 1000.0
+              << std::setw(12) << goodputKBps
+              << std::setw(8) << stats.retransmits
+              << std::setw(8) << outOfOrder << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    int messages = 2000;
+    int rate = 5000;
+    int payloadBytes = 200;
+    int delayMs = 2;
+
+    if (argc >= 2) messages = std::stoi(argv[1]);
+    if (argc >= 3) rate = std::stoi(argv[2]);
+    if (argc >= 4) payloadBytes = std::stoi(argv[3]);
+    if (argc >= 5) delayMs = std::stoi(argv[4]);
+
+    std::cout << "=== Reliable UDP Benchmark ===" << std::endl;
+    std::cout << "Messages: " << messages << " at " << rate << "/s, payload " << payloadBytes
+              << " bytes, one-way delay " << delayMs << " ms, loss in both directions" << std::endl;
+    std::cout << std::endl;
+    std::cout << std::left << std::setw(10) << "mode"
+              << std::right << std::setw(7) << "loss%"
+              << std::setw(10) << "delivered"
+              << std::setw(10) << "p50 ms"
+              << std::setw(10) << "p99 ms"
+              << std::setw(10) << "p99.9 ms"
+              << std::setw(10) << "max ms"
+              << std::setw(12) << "goodput KB/s"
+              << std::setw(8) << "rexmit"
+              << std::setw(8) << "reorder" << std::endl;
+
+    for (double lossRate : {0.0, 0.01, 0.05, 0.10}) {
+        runCase("none", UdpDelivery::UNRELIABLE, lossRate, messages, rate, payloadBytes, delayMs);
+        runCase("reliable", UdpDelivery::RELIABLE, lossRate, messages, rate, payloadBytes, delayMs);
+        runCase("ordered", UdpDelivery::RELIABLE_ORDERED, lossRate, messages, rate, payloadBytes, delayMs);
+    }
+
+    return 0;
+}
@@ -0,0 +1,116 @@
+/**
+ * Startup Benchmark
+ * Measures time-to-first-connect for N agents with and without a shared transport context
+ */
+
+#include "hmdev/messaging/api/messaging_channel_api.h"
+#include "benchmark_utils.h"
+#include <iostream>
+#include <iomanip>
+#include <thread>
+#include <atomic>
+#include <memory>
+
+using namespace hmdev::messaging;
+using namespace hmdev::messaging::bench;
+
+static void runMode(const std::string& label,
+                    std::shared_ptr<HttpTransportContext> context,
+                    const std::string& apiUrl,
+                    const std::string& apiKey,
+                    const std::string& channelName,
+                    const std::string& channelPassword,
+                    int agentCount,
+                    int threadCount) {
+    HttpClientConfig httpConfig;
+    httpConfig.transportContext = context;
+
+    std::vector<std::unique_ptr<MessagingChannelApi>> agents(agentCount);
+    std::vector<std::string> sessions(agentCount);
+    std::vector<double> connectUs(agentCount, -1.0);
+    std::atomic<int> next(0);
+
+    auto start = Clock::now();
+
+    // Each worker constructs and connects agents until all N are done
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threadCount; t++) {
+        workers.emplace_back([&]() {
+            int i;
+            while ((i = next++) < agentCount) {
+                auto agentStart = Clock::now();
+                agents[i] = std::make_unique<MessagingChannelApi>(apiUrl, apiKey, httpConfig);
+                ConnectResponse resp = agents[i]->connect(channelName, channelPassword,
+                                                          "startup-bench-" + std::to_string(i));
+                if (resp.success) {
+                    connectUs[i] = elapsedUs(agentStart);
+                    sessions[i] = resp.sessionId;
+                }
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    double totalMs = elapsedUs(start) / 1000.0;
+
+    std::vector<double> latencies;
+    for (double us : connectUs) {
+        if (us >= 0) latencies.push_back(us);
+    }
+    int failures = agentCount - static_cast<int>(latencies.size());
+
+    for (int i = 0; i < agentCount; i++) {
+        if (!sessions[i].empty()) {
+            agents[i]->disconnect(sessions[i]);
+        }
+    }
+
+    std::cout << std::left << std::setw(10) << label
+              << std::right << std::fixed << std::setprecision(1)
+              << std::setw(12) << percentile(latencies, 50) / 1000.0
+              << std::setw(12) << percentile(latencies, 99) / 1000.0
+              << std::setw(12) << totalMs
+              << std::setw(10) << failures << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    // Default messaging service URL (production)
+    std::string apiUrl = "https://hmdevonline.com/messaging-platform/api/v1/messaging-service";
+    std::string apiKey = "your_api_key_here";
+    std::string channelName = "startup-bench";
+    std::string channelPassword = "benchpass";
+    int agentCount = 100;
+    int threadCount = 16;
+
+    if (argc >= 2) apiUrl = argv[1];
+    if (argc >= 3) apiKey = argv[2];
+    if (argc >= 4) channelName = argv[3];
+    if (argc >= 5) channelPassword = argv[4];
+    if (argc >= 6) agentCount = std::stoi(argv[5]);
+    if (argc >= 7) threadCount = std::stoi(argv[6]);
+
+    std::cout << "=== Startup Benchmark ===" << std::endl;
+    std::cout << "API URL: " << apiUrl << std::endl;
+    std::cout << "Agents: " << agentCount << " on " << threadCount << " threads" << std::endl;
+    std::cout << std::endl;
+
+    std::cout << std::left << std::setw(10) << "mode"
+              << std::right << std::setw(12) << "p50 (ms)"
+              << std::setw(12) << "p99 (ms)"
+              << std::setw(12) << "total (ms)"
+              << std::setw(10) << "failed" << std::endl;
+
+    try {
+        runMode("isolated", nullptr, apiUrl, apiKey, channelName, channelPassword,
+                agentCount, threadCount);
+        runMode("shared", std::make_shared<HttpTransportContext>(), apiUrl, apiKey,
+                channelName, channelPassword, agentCount, threadCount);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,159 @@
+/**
+ * State Delta Benchmark
+ * A 64-player room state encoded every tick at 20 Hz for 64 receivers that
+ * lose states and acknowledgements at random and acknowledge two ticks
+ * late: bytes per receiver, compression ratio, encode cost per tick and
+ * decode correctness of one broadcast encoding vs per-receiver encodings
+ */
+
+#include "hmdev/messaging/util/state_delta.h"
+#include "benchmark_utils.h"
+#include <iostream>
+#include <iomanip>
+#include <deque>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace hmdev::messaging;
+using namespace hmdev::messaging::bench;
+
+static constexpr int PLAYERS = 64;
+static constexpr int RECEIVERS = 64;
+static constexpr int TICK_HZ = 20;
+static constexpr int ACK_DELAY_TICKS = 2;
+
+struct Ack {
+    int due;
+    int receiver;
+    std::string content;
+};
+
+struct Result {
+    double rawBytes;
+    double sentBytes;
+    double ratio;
+    double fullPct;
+    double meanEncodeUs;
+    double p99EncodeUs;
+    uint64_t decoded;
+    uint64_t mismatches;
+};
+
+static json makeRoom() {
+    json state = {{"tick", 0}, {"players", json::object()}};
+    for (int i = 0; i < PLAYERS; i++) {
+        state["players"]["player-" + std::to_string(i)] = {
+            {"x", 10.0 * i}, {"y", 5.0 * i}, {"hp", 100}, {"score", 0}, {"anim", "idle"}};
+    }
+    return state;
+}
+
+static Result run(int ticks, double movingPct, double lossPct, bool perReceiver) {
+    std::mt19937 random(11);
+    std::uniform_real_distribution<double> percent(0.0, 100.0);
+    std::uniform_real_distribution<double> step(-1.0, 1.0);
+
+    StateDeltaEncoder encoder;
+    std::vector<StateDeltaDecoder> decoders(RECEIVERS);
+    std::deque<Ack> acks;
+    std::vector<double> encodeUs;
+    json state = makeRoom();
+    Result result = Result();
+    Clock::time_point now = Clock::now();
+
+    for (int tick = 1; tick <= ticks; tick++) {
+        now += std::chrono::milliseconds(1000 / TICK_HZ);
+        for (; !acks.empty() && acks.front().due <= tick; acks.pop_front()) {
+            encoder.acknowledge("receiver-" + std::to_string(acks.front().receiver), acks.front().content, now);
+        }
+
+        state["tick"] = tick;
+        for (auto& player : state["players"]) {
+            if (percent(random) < movingPct) {
+                player["x"] = player["x"].get<double>() + step(random);
+                player["y"] = player["y"].get<double>() + step(random);
+                player["anim"] = "run";
+            } else {
+                player["anim"] = "idle";
+            }
+            if (percent(random) < 2.0) {
+                player["hp"] = std::max(0, player["hp"].get<int>() - 10);
+                player["score"] = player["score"].get<int>() + 1;
+            }
+        }
+
+        std::vector<std::string> contents;
+        if (perReceiver) {
+            encoder.commit(state);
+            for (int r = 0; r < RECEIVERS; r++) {
+                contents.push_back(encoder.encodeFor("receiver-" + std::to_string(r), now));
+            }
+        } else {
+            contents.assign(RECEIVERS, encoder.encode(state, now));
+        }
+        encodeUs.push_back(encoder.getStats(now).lastEncodeUs);
+
+        for (int r = 0; r < RECEIVERS; r++) {
+            const std::string& content = contents[r];
+            if (percent(random) >= lossPct) {
+                json decoded;
+                if (decoders[r].decode(content, decoded)) {
+                    result.decoded++;
+                    result.mismatches += decoded == state ? 0 : 1;
+                }
+            }
+            if (percent(random) >= lossPct) {
+                acks.push_back(Ack{tick + ACK_DELAY_TICKS, r, decoders[r].ack()});
+            }
+        }
+    }
+
+    StateDeltaStats stats = encoder.getStats(now);
+    uint64_t encodings = stats.fullSnapshots + stats.deltas;
+    result.rawBytes = static_cast<double>(stats.rawBytes) / encodings;
+    result.sentBytes = static_cast<double>(stats.encodedBytes) / encodings;
+    result.ratio = stats.compressionRatio;
+    result.fullPct = 100.0 * stats.fullSnapshots / encodings;
+    result.meanEncodeUs = stats.meanEncodeUs;
+    result.p99EncodeUs = percentile(encodeUs, 99);
+    return result;
+}
+
+int main(int argc, char* argv[]) {
+    int ticks = 400;
+
+    if (argc >= 2) ticks = std::stoi(argv[1]);
+
+    std::cout << "=== State Delta Benchmark ===" << std::endl;
+    std::cout << PLAYERS << " players, " << RECEIVERS << " receivers, " << ticks << " ticks at " << TICK_HZ
+              << " Hz, acknowledgements " << ACK_DELAY_TICKS << " ticks late" << std::endl;
+    std::cout << "kbit/s = bytes per receiver at " << TICK_HZ << " Hz (full: sending the whole state); "
+              << "encode = all encodings of a tick; bad = decoded states that differ" << std::endl;
+    std::cout << std::endl;
+    std::cout << std::setw(14) << "mode" << std::setw(9) << "moving %" << std::setw(8) << "loss %"
+              << std::setw(10) << "full (B)" << std::setw(10) << "sent (B)" << std::setw(8) << "ratio"
+              << std::setw(9) << "fulls %"
+              << std::setw(14) << "encode (us)" << std::setw(10) << "p99 (us)" << std::setw(12) << "kbit/s"
+              << std::setw(14) << "full kbit/s" << std::setw(6) << "bad" << std::endl;
+
+    for (bool perReceiver : {false, true}) {
+        for (double movingPct : {10.0, 100.0}) {
+            for (double lossPct : {0.0, 5.0, 20.0}) {
+                Result result = run(ticks, movingPct, lossPct, perReceiver);
+                std::cout << std::fixed << std::setprecision(0)
+                          << std::setw(14) << (perReceiver ? "per-receiver" : "broadcast")
+                          << std::setw(9) << movingPct << std::setw(8) << lossPct
+                          << std::setw(10) << result.rawBytes << std::setw(10) << result.sentBytes
+                          << std::setprecision(1) << std::setw(8) << result.ratio
+                          << std::setw(9) << result.fullPct
+                          << std::setw(14) << result.meanEncodeUs << std::setw(10) << result.p99EncodeUs
+                          << std::setprecision(0)
+                          << std::setw(12) << result.sentBytes * 8 * TICK_HZ / 1000.0
+                          << std::setw(14) << result.rawBytes * 8 * TICK_HZ / 1000.0
+                          << std::setw(6) << result.mismatches << std::endl;
+            }
+        }
+    }
+    return 0;
+}
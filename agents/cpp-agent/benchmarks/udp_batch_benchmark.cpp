@@ -0,0 +1,126 @@
+/**
+ * UDP Batch Benchmark
+ * Per-frame cost of pushing one datagram per entity with send() versus
+ * sendmmsg, and recvmmsg drain rate
+ */
+
+#include "hmdev/messaging/api/udp_client.h"
+#include "benchmark_utils.h"
+#include <sys/socket.h>
+#include <sys/resource.h>
+#include <netinet/in.h>
+#include <unistd.h>
+#include <cstring>
+#include <iostream>
+#include <iomanip>
+
+using namespace hmdev::messaging;
+using namespace hmdev::messaging::bench;
+
+static double cpuTimeUs() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_utime.tv_sec * 1e6 + usage.ru_utime.tv_usec +
+           usage.ru_stime.tv_sec * 1e6 + usage.ru_stime.tv_usec;
+}
+
+static void printRow(const std::string& label, double wallUs, double cpuUs, int frames, size_t datagrams) {
+    std::cout << std::left << std::setw(12) << label
+              << std::right << std::fixed << std::setprecision(1)
+              << std::setw(16) << wallUs / frames
+              << std::setw(16) << cpuUs / frames
+              << std::setw(16) << datagrams / (wallUs / 1e6) << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    int entities = 500;
+    int frames = 600;
+
+    if (argc >= 2) entities = std::stoi(argv[1]);
+    if (argc >= 3) frames = std::stoi(argv[2]);
+
+    // Local server socket; sends are dropped once its buffer fills
+    int server = socket(AF_INET, SOCK_DGRAM, 0);
+    struct sockaddr_in serverAddr;
+    std::memset(&serverAddr, 0, sizeof(serverAddr));
+    serverAddr.sin_family = AF_INET;
+    serverAddr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t addrLen = sizeof(serverAddr);
+    if (server < 0 || bind(server, reinterpret_cast<struct sockaddr*>(&serverAddr), sizeof(serverAddr)) != 0 ||
+        getsockname(server, reinterpret_cast<struct sockaddr*>(&serverAddr), &addrLen) != 0) {
+        std::cerr << "Failed to bind server socket" << std::endl;
+        return 1;
+    }
+
+    UdpClientConfig config;
+    config.addressFamily = AF_INET;
+    UdpClient client("127.0.0.1", ntohs(serverAddr.sin_port), config);
+
+    std::vector<UdpEnvelope> frame;
+    for (int e = 0; e < entities; e++) {
+        frame.emplace_back("push", json{
+            {"sessionId", "bench-session"}, {"type", "GAME_STATE"}, {"to", "*"},
+            {"content", "{\"id\":" + std::to_string(e) + ",\"x\":1.5,\"y\":2.5}"}, {"encrypted", false}
+        });
+    }
+
+    std::cout << "=== UDP Batch Benchmark ===" << std::endl;
+    std::cout << "Entities: " << entities << ", frames: " << frames << std::endl;
+    std::cout << std::endl;
+    std::cout << std::left << std::setw(12) << "path"
+              << std::right << std::setw(16) << "wall us/frame"
+              << std::setw(16) << "cpu us/frame"
+              << std::setw(16) << "datagrams/s" << std::endl;
+
+    size_t sent = 0;
+    double cpuStart = cpuTimeUs();
+    auto start = Clock::now();
+    for (int f = 0; f < frames; f++) {
+        for (const auto& envelope : frame) {
+            sent += client.send(envelope) ? 1 : 0;
+        }
+    }
+    printRow("send", elapsedUs(start), cpuTimeUs() - cpuStart, frames, sent);
+
+    sent = 0;
+    cpuStart = cpuTimeUs();
+    start = Clock::now();
+    for (int f = 0; f < frames; f++) {
+        sent += client.sendBatch(frame);
+    }
+    printRow("sendmmsg", elapsedUs(start), cpuTimeUs() - cpuStart, frames, sent);
+
+    // Empty the server socket, then learn a fresh client's address from its first datagram
+    char buffer[65536];
+    while (recv(server, buffer, sizeof(buffer), MSG_DONTWAIT) > 0) {
+    }
+    UdpClient receiver("127.0.0.1", ntohs(serverAddr.sin_port), config);
+    receiver.send(UdpEnvelope("hello", json::object()));
+    struct sockaddr_storage clientAddr;
+    socklen_t clientLen = sizeof(clientAddr);
+    recvfrom(server, buffer, sizeof(buffer), 0, reinterpret_cast<struct sockaddr*>(&clientAddr), &clientLen);
+
+    std::string reply = json{{"status", "ok"}, {"result", {{"status", "success"}}}}.dump();
+    int replies = entities;
+    size_t received = 0;
+    std::vector<json> messages;
+    double drainUs = 0;
+    for (int f = 0; f < frames; f++) {
+        for (int r = 0; r < replies; r++) {
+            sendto(server, reply.data(), reply.size(), 0,
+                   reinterpret_cast<struct sockaddr*>(&clientAddr), clientLen);
+        }
+        auto drainStart = Clock::now();
+        size_t n;
+        while ((n = receiver.receiveBatch(messages, 0)) > 0) {
+            received += n;
+            messages.clear();
+        }
+        drainUs += elapsedUs(drainStart);
+    }
+    std::cout << std::endl << "recvmmsg drained " << received << " datagrams at "
+              << std::fixed << std::setprecision(0) << received / (drainUs / 1e6) << " datagrams/s" << std::endl;
+
+    close(server);
+    return 0;
+}
@@ -0,0 +1,201 @@
+/**
+ * UDP Coalescing Benchmark
+ * Per-frame cost and datagram count of many small pushes: one datagram per
+ * push, sendmmsg batches, and pushes coalesced into MTU-sized datagrams
+ */
+
+#include "hmdev/messaging/api/udp_client.h"
+#include "hmdev/messaging/util/udp_codec.h"
+#include "benchmark_utils.h"
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <unistd.h>
+#include <cstring>
+#include <iostream>
+#include <iomanip>
+#include <thread>
+#include <atomic>
+
+using namespace hmdev::messaging;
+using namespace hmdev::messaging::bench;
+
+/**
+ * Loopback sink counting datagrams, bytes and the push requests inside them
+ */
+class CountingSink {
+public:
+    CountingSink() : fd_(socket(AF_INET, SOCK_DGRAM, 0)), port_(0), running_(true),
+                     datagrams_(0), bytes_(0), messages_(0) {
+        int bufferSize = 8 * 1024 * 1024;
+        setsockopt(fd_, SOL_SOCKET, SO_RCVBUF, &bufferSize, sizeof(bufferSize));
+
+        struct sockaddr_in addr;
+        std::memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t addrLen = sizeof(addr);
+        if (fd_ >= 0 && bind(fd_, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) == 0 &&
+            getsockname(fd_, reinterpret_cast<struct sockaddr*>(&addr), &addrLen) == 0) {
+            port_ = ntohs(addr.sin_port);
+        }
+        thread_ = std::thread(&CountingSink::run, this);
+    }
+
+    ~CountingSink() {
+        running_ = false;
+        thread_.join();
+        close(fd_);
+    }
+
+    int port() const { return port_; }
+
+    /**
+     * Wait until the socket has been quiet for a moment, then reset the counters
+     */
+    void drain(uint64_t& datagrams, uint64_t& bytes, uint64_t& messages) {
+        uint64_t last = ~0ULL;
+        while (datagrams_ != last) {
+            last = datagrams_;
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        }
+        datagrams = datagrams_.exchange(0);
+        bytes = bytes_.exchange(0);
+        messages = messages_.exchange(0);
+    }
+
+private:
+    int fd_;
+    int port_;
+    std::atomic<bool> running_;
+    std::atomic<uint64_t> datagrams_;
+    std::atomic<uint64_t> bytes_;
+    std::atomic<uint64_t> messages_;
+    std::thread thread_;
+
+    void run() {
+        char buffer[65536];
+        while (running_) {
+            struct pollfd pfd = {fd_, POLLIN, 0};
+            if (poll(&pfd, 1, 10) <= 0) {
+                continue;
+            }
+            ssize_t received;
+            while ((received = recv(fd_, buffer, sizeof(buffer), MSG_DONTWAIT)) > 0) {
+                json datagram = UdpCodec::decode(buffer, static_cast<size_t>(received));
+                if (datagram.is_discarded()) {
+                    continue;
+                }
+                if (datagram.value("action", "") == "push-batch") {
+                    messages_ += datagram["payload"]["messages"].size();
+                } else {
+                    messages_++;
+                }
+                datagrams_++;
+                bytes_ += static_cast<uint64_t>(received);
+            }
+        }
+    }
+};
+
+static json makeRequest(int entity, int frame) {
+    return json{
+        {"sessionId", "bench-session"}, {"type", "GAME_STATE"}, {"to", "*"},
+        {"content", "{\"id\":" + std::to_string(entity) + ",\"x\":1.5,\"y\":2.5,\"frame\":" +
+                    std::to_string(frame) + "}"},
+        {"encrypted", false}
+    };
+}
+
+static void printRow(const std::string& label, double totalUs, int frames, CountingSink& sink) {
+    uint64_t datagrams, bytes, messages;
+    sink.drain(datagrams, bytes, messages);
+
+    std::cout << std::left << std::setw(22) << label
+              << std::right << std::fixed << std::setprecision(1)
+              << std::setw(12) << totalUs / frames
+              << std::setw(12) << datagrams
+              << std::setw(12) << messages
+              << std::setw(10) << (datagrams > 0 ? static_cast<double>(messages) / datagrams : 0.0)
+              << std::setw(12) << (messages > 0 ? static_cast<double>(bytes) / messages : 0.0)
+              << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    int frames = 2000;
+    int perFrame = 20;
+    size_t budget = 1200;
+
+    if (argc >= 2) frames = std::stoi(argv[1]);
+    if (argc >= 3) perFrame = std::stoi(argv[2]);
+    if (argc >= 4) budget = static_cast<size_t>(std::stoul(argv[3]));
+
+    CountingSink sink;
+
+    UdpClientConfig config;
+    config.addressFamily = AF_INET;
+    config.coalescing.maxDatagramSize = budget;
+    UdpClient client("127.0.0.1", sink.port(), config);
+    client.resolve();
+
+    std::cout << "=== UDP Coalescing Benchmark ===" << std::endl;
+    std::cout << "Frames: " << frames << ", pushes per frame: " << perFrame
+              << ", datagram budget: " << budget << " bytes" << std::endl;
+    std::cout << std::endl;
+    std::cout << std::left << std::setw(22) << "path"
+              << std::right << std::setw(12) << "us/frame"
+              << std::setw(12) << "datagrams"
+              << std::setw(12) << "messages"
+              << std::setw(10) << "msg/dgram"
+              << std::setw(12) << "bytes/msg" << std::endl;
+
+    auto start = Clock::now();
+    for (int frame = 0; frame < frames; frame++) {
+        for (int i = 0; i < perFrame; i++) {
+            client.send(UdpEnvelope("push", makeRequest(i, frame)));
+        }
+    }
+    printRow("send per push", elapsedUs(start), frames, sink);
+
+    std::vector<UdpEnvelope> envelopes;
+    start = Clock::now();
+    for (int frame = 0; frame < frames; frame++) {
+        envelopes.clear();
+        for (int i = 0; i < perFrame; i++) {
+            envelopes.emplace_back("push", makeRequest(i, frame));
+        }
+        client.sendBatch(envelopes);
+    }
+    printRow("sendmmsg per frame", elapsedUs(start), frames, sink);
+
+    start = Clock::now();
+    for (int frame = 0; frame < frames; frame++) {
+        for (int i = 0; i < perFrame; i++) {
+            client.pushCoalesced(makeRequest(i, frame));
+        }
+        client.flush();
+    }
+    printRow("coalesced + flush()", elapsedUs(start), frames, sink);
+
+    UdpCoalescingStats stats = client.getStats().coalescing;
+    std::cout << std::endl;
+    std::cout << "Coalescer: " << stats.messages << " messages in " << stats.datagrams << " datagrams (max "
+              << stats.maxPerDatagram << " per datagram); flushes by size " << stats.sizeFlushes
+              << ", deadline " << stats.deadlineFlushes << ", explicit " << stats.explicitFlushes << std::endl;
+
+    // Without flush() a batch leaves after flushDeadlineMs at the latest
+    int deadlineFrames = 50;
+    start = Clock::now();
+    for (int frame = 0; frame < deadlineFrames; frame++) {
+        client.pushCoalesced(makeRequest(0, frame));
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    uint64_t datagrams, bytes, messages;
+    sink.drain(datagrams, bytes, messages);
+    UdpCoalescingStats after = client.getStats().coalescing;
+    std::cout << "Deadline only (" << config.coalescing.flushDeadlineMs << " ms, one push per 5 ms): "
+              << messages << "/" << deadlineFrames << " messages arrived, "
+              << after.deadlineFlushes - stats.deadlineFlushes << " deadline flushes" << std::endl;
+
+    return 0;
+}
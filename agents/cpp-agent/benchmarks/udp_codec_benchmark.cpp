@@ -0,0 +1,85 @@
+/**
+ * UDP Codec Benchmark
+ * Bytes per datagram and encode/decode cost of JSON versus MessagePack and
+ * CBOR with short field keys, for GAME_STATE and GAME_INPUT envelopes
+ */
+
+#include "hmdev/messaging/util/udp_codec.h"
+#include "hmdev/messaging/agent/data_models.h"
+#include "benchmark_utils.h"
+#include <iostream>
+#include <iomanip>
+
+using namespace hmdev::messaging;
+using namespace hmdev::messaging::bench;
+
+static json makeEnvelope(EventType type, const std::string& content) {
+    EventMessageRequest request;
+    request.sessionId = "3f2b9c4e-7d1a-4e8b-9c2f-5a6b7c8d9e0f";
+    request.type = type;
+    request.to = "*";
+    request.content = content;
+    request.encrypted = false;
+    return UdpEnvelope("push", request.toJson()).toJson();
+}
+
+static void runCase(const std::string& label, const json& envelope, UdpEncoding encoding, int iterations) {
+    std::string datagram;
+    UdpCodec::encode(envelope, encoding, datagram);
+    size_t bytes = datagram.size();
+
+    auto start = Clock::now();
+    for (int i = 0; i < iterations; i++) {
+        UdpCodec::encode(envelope, encoding, datagram);
+    }
+    double encodeNs = elapsedUs(start) * 1000.0 / iterations;
+
+    start = Clock::now();
+    for (int i = 0; i < iterations; i++) {
+        json decoded = UdpCodec::decode(datagram.data(), datagram.size());
+        if (decoded.is_discarded()) {
+            std::cerr << label << ": decode failed" << std::endl;
+            return;
+        }
+    }
+    double decodeNs = elapsedUs(start) * 1000.0 / iterations;
+
+    if (UdpCodec::decode(datagram.data(), datagram.size()) != envelope) {
+        std::cerr << label << ": round trip mismatch" << std::endl;
+    }
+
+    std::cout << std::left << std::setw(12) << label
+              << std::setw(10) << udpEncodingToString(encoding)
+              << std::right << std::fixed << std::setprecision(0)
+              << std::setw(10) << bytes
+              << std::setw(14) << encodeNs
+              << std::setw(14) << decodeNs << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    int iterations = 200000;
+
+    if (argc >= 2) iterations = std::stoi(argv[1]);
+
+    json state = makeEnvelope(EventType::GAME_STATE,
+                              "{\"id\":42,\"x\":103.25,\"y\":-7.5,\"vx\":1.0,\"vy\":0.0,\"hp\":87}");
+    json input = makeEnvelope(EventType::GAME_INPUT, "{\"seq\":1042,\"keys\":5,\"aim\":1.57}");
+
+    std::cout << "=== UDP Codec Benchmark ===" << std::endl;
+    std::cout << "Iterations: " << iterations << std::endl;
+    std::cout << std::endl;
+    std::cout << std::left << std::setw(12) << "message"
+              << std::setw(10) << "encoding"
+              << std::right << std::setw(10) << "bytes"
+              << std::setw(14) << "encode ns"
+              << std::setw(14) << "decode ns" << std::endl;
+
+    for (UdpEncoding encoding : {UdpEncoding::JSON, UdpEncoding::MSGPACK, UdpEncoding::CBOR}) {
+        runCase("GAME_STATE", state, encoding, iterations);
+    }
+    for (UdpEncoding encoding : {UdpEncoding::JSON, UdpEncoding::MSGPACK, UdpEncoding::CBOR}) {
+        runCase("GAME_INPUT", input, encoding, iterations);
+    }
+
+    return 0;
+}
@@ -0,0 +1,153 @@
+/**
+ * UDP io_uring Benchmark
+ * Packets per second per CPU core on loopback for the socket and io_uring
+ * UdpClient backends: single sends, sendBatch bursts and receiver-thread
+ * delivery
+ */
+
+#include "hmdev/messaging/api/udp_client.h"
+#include "benchmark_utils.h"
+#include <sys/socket.h>
+#include <sys/resource.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <unistd.h>
+#include <cstring>
+#include <iostream>
+#include <iomanip>
+#include <thread>
+#include <atomic>
+
+using namespace hmdev::messaging;
+using namespace hmdev::messaging::bench;
+
+static double processCpuUs() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1e6 +
+           usage.ru_utime.tv_usec + usage.ru_stime.tv_usec;
+}
+
+static int bindLoopback(int& port) {
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    struct sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t addrLen = sizeof(addr);
+    if (fd < 0 || bind(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        getsockname(fd, reinterpret_cast<struct sockaddr*>(&addr), &addrLen) != 0) {
+        return -1;
+    }
+    port = ntohs(addr.sin_port);
+    return fd;
+}
+
+static void printRow(const std::string& backend, const std::string& path, uint64_t packets,
+                     double wallUs, double cpuUs, uint64_t enters) {
+    std::cout << std::left << std::setw(10) << backend << std::setw(14) << path
+              << std::right << std::fixed << std::setprecision(0)
+              << std::setw(10) << packets
+              << std::setw(12) << packets / (wallUs / 1e6)
+              << std::setw(14) << packets / (cpuUs / 1e6)
+              << std::setw(10);
+    if (enters > 0) {
+        std::cout << std::setprecision(2) << static_cast<double>(enters) / packets;
+    } else {
+        std::cout << "-";
+    }
+    std::cout << std::endl;
+}
+
+static void runBackend(const std::string& name, UdpBackend backend, int packets, int burst, int window) {
+    int sinkPort = 0;
+    int sink = bindLoopback(sinkPort);
+    if (sink < 0) {
+        std::cerr << "Failed to bind sink socket" << std::endl;
+        return;
+    }
+
+    UdpClientConfig config;
+    config.addressFamily = AF_INET;
+    config.backend = backend;
+    UdpClient client("127.0.0.1", sinkPort, config);
+    client.resolve();
+    UdpEnvelope envelope("push", json{{"n", 1}});
+
+    // Sends: the sink never reads, so the kernel drops datagrams once its buffer is full
+    uint64_t enters = client.getStats().ioUring.enters;
+    double cpu = processCpuUs();
+    auto start = Clock::now();
+    for (int i = 0; i < packets; i++) {
+        client.send(envelope);
+    }
+    printRow(name, "send", packets, elapsedUs(start), processCpuUs() - cpu,
+             client.getStats().ioUring.enters - enters);
+
+    std::vector<UdpEnvelope> envelopes(burst, envelope);
+    enters = client.getStats().ioUring.enters;
+    cpu = processCpuUs();
+    start = Clock::now();
+    for (int i = 0; i < packets; i += burst) {
+        client.sendBatch(envelopes);
+    }
+    printRow(name, "sendBatch", packets, elapsedUs(start), processCpuUs() - cpu,
+             client.getStats().ioUring.enters - enters);
+
+    // Receives: learn the client's address from one datagram, then stream to it with a window
+    std::atomic<uint64_t> received(0);
+    client.startReceiver([&](const json&) { received++; });
+    char buffer[2048];
+    while (recv(sink, buffer, sizeof(buffer), MSG_DONTWAIT) > 0) {
+    }
+    client.send(envelope);
+    struct sockaddr_storage peer;
+    socklen_t peerLen = sizeof(peer);
+    struct pollfd pfd = {sink, POLLIN, 0};
+    poll(&pfd, 1, 1000);
+    recvfrom(sink, buffer, sizeof(buffer), 0, reinterpret_cast<struct sockaddr*>(&peer), &peerLen);
+
+    std::string datagram = envelope.toJson().dump();
+    enters = client.getStats().ioUring.enters;
+    cpu = processCpuUs();
+    start = Clock::now();
+    uint64_t sent = 0;
+    auto deadline = Clock::now() + std::chrono::seconds(10);
+    while (received < static_cast<uint64_t>(packets) && Clock::now() < deadline) {
+        if (sent < static_cast<uint64_t>(packets) && sent - received < static_cast<uint64_t>(window)) {
+            sendto(sink, datagram.data(), datagram.size(), 0, reinterpret_cast<struct sockaddr*>(&peer), peerLen);
+            sent++;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    printRow(name, "receive", received, elapsedUs(start), processCpuUs() - cpu,
+             client.getStats().ioUring.enters - enters);
+    client.stopReceiver();
+    close(sink);
+}
+
+int main(int argc, char* argv[]) {
+    int packets = 200000;
+    int burst = 32;
+    int window = 128;
+
+    if (argc >= 2) packets = std::stoi(argv[1]);
+    if (argc >= 3) burst = std::stoi(argv[2]);
+    if (argc >= 4) window = std::stoi(argv[3]);
+
+    std::cout << "=== UDP io_uring Benchmark ===" << std::endl;
+    std::cout << "Packets: " << packets << ", sendBatch burst: " << burst
+              << ", receive window: " << window << ", CPUs: " << std::thread::hardware_concurrency() << std::endl;
+    std::cout << "pkts/core-s = packets per second of process CPU time (user + system)" << std::endl;
+    std::cout << std::endl;
+    std::cout << std::left << std::setw(10) << "backend" << std::setw(14) << "path"
+              << std::right << std::setw(10) << "packets"
+              << std::setw(12) << "pkts/s"
+              << std::setw(14) << "pkts/core-s"
+              << std::setw(10) << "enter/pkt" << std::endl;
+
+    runBackend("socket", UdpBackend::SOCKET, packets, burst, window);
+    runBackend("io_uring", UdpBackend::IO_URING, packets, burst, window);
+    return 0;
+}
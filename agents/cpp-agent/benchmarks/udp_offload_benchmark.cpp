@@ -0,0 +1,217 @@
+/**
+ * UDP Offload Benchmark
+ * Loopback throughput of UdpClient with and without UDP_SEGMENT (GSO) and
+ * UDP_GRO: fragmented world snapshots, sendBatch bursts of equal-size
+ * envelopes, and receiver-thread delivery of coalesced bursts
+ */
+
+#include "hmdev/messaging/api/udp_client.h"
+#include "benchmark_utils.h"
+#include <sys/socket.h>
+#include <sys/resource.h>
+#include <netinet/in.h>
+#include <netinet/udp.h>
+#include <poll.h>
+#include <unistd.h>
+#include <cstring>
+#include <iostream>
+#include <iomanip>
+#include <thread>
+#include <atomic>
+
+#ifndef SOL_UDP
+#define SOL_UDP 17
+#endif
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103
+#endif
+
+using namespace hmdev::messaging;
+using namespace hmdev::messaging::bench;
+
+static double processCpuUs() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1e6 +
+           usage.ru_utime.tv_usec + usage.ru_stime.tv_usec;
+}
+
+static int bindLoopback(int& port) {
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    struct sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t addrLen = sizeof(addr);
+    if (fd < 0 || bind(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        getsockname(fd, reinterpret_cast<struct sockaddr*>(&addr), &addrLen) != 0) {
+        return -1;
+    }
+    port = ntohs(addr.sin_port);
+    return fd;
+}
+
+static void printRow(const std::string& mode, const std::string& path, uint64_t datagrams,
+                     uint64_t bytes, double wallUs, double cpuUs, uint64_t offloaded) {
+    std::cout << std::left << std::setw(9) << mode << std::setw(12) << path
+              << std::right << std::fixed << std::setprecision(0)
+              << std::setw(10) << datagrams
+              << std::setw(12) << datagrams / (wallUs / 1e6)
+              << std::setw(14) << datagrams / (cpuUs / 1e6)
+              << std::setprecision(1) << std::setw(9) << bytes / wallUs
+              << std::setw(11) << (datagrams > 0 ? 100.0 * offloaded / datagrams : 0.0) << "%"
+              << std::endl;
+}
+
+/**
+ * Send bursts of equal-size datagrams, each burst as one UDP_SEGMENT buffer when possible
+ */
+static bool sendSegmented(int fd, const struct sockaddr_storage& peer, socklen_t peerLen,
+                          const std::string& datagram, int count, bool segment) {
+    std::string burst;
+    for (int i = 0; i < count; i++) {
+        burst += datagram;
+    }
+    struct iovec iov;
+    iov.iov_base = const_cast<char*>(burst.data());
+    iov.iov_len = burst.size();
+
+    char control[CMSG_SPACE(sizeof(uint16_t))];
+    struct msghdr header;
+    std::memset(&header, 0, sizeof(header));
+    header.msg_name = const_cast<struct sockaddr_storage*>(&peer);
+    header.msg_namelen = peerLen;
+    header.msg_iov = &iov;
+    header.msg_iovlen = 1;
+    if (segment) {
+        std::memset(control, 0, sizeof(control));
+        header.msg_control = control;
+        header.msg_controllen = sizeof(control);
+        struct cmsghdr* cmsg = CMSG_FIRSTHDR(&header);
+        cmsg->cmsg_level = SOL_UDP;
+        cmsg->cmsg_type = UDP_SEGMENT;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+        uint16_t size = static_cast<uint16_t>(datagram.size());
+        std::memcpy(CMSG_DATA(cmsg), &size, sizeof(size));
+        return sendmsg(fd, &header, 0) >= 0;
+    }
+
+    for (int i = 0; i < count; i++) {
+        iov.iov_len = datagram.size();
+        iov.iov_base = const_cast<char*>(burst.data()) + i * datagram.size();
+        if (sendmsg(fd, &header, 0) < 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void runMode(const std::string& name, bool offload, int rounds, int snapshotBytes, int burst) {
+    int sinkPort = 0;
+    int sink = bindLoopback(sinkPort);
+    if (sink < 0) {
+        std::cerr << "Failed to bind sink socket" << std::endl;
+        return;
+    }
+
+    UdpClientConfig config;
+    config.addressFamily = AF_INET;
+    config.maxDatagramSize = 1200;
+    config.segmentOffload = offload;
+    config.receiveOffload = offload;
+    UdpClient client("127.0.0.1", sinkPort, config);
+    client.resolve();
+
+    // Snapshots: one large envelope fragmented into 1200-byte datagrams (the sink never reads)
+    UdpEnvelope snapshot("push", json{{"world", std::string(static_cast<size_t>(snapshotBytes), 'w')}});
+    uint64_t fragments = client.getStats().fragmentsSent;
+    uint64_t offloaded = client.getStats().offload.segmentDatagrams;
+    double cpu = processCpuUs();
+    auto start = Clock::now();
+    for (int i = 0; i < rounds; i++) {
+        client.send(snapshot);
+    }
+    uint64_t sent = client.getStats().fragmentsSent - fragments;
+    printRow(name, "snapshot", sent, sent * config.maxDatagramSize, elapsedUs(start), processCpuUs() - cpu,
+             client.getStats().offload.segmentDatagrams - offloaded);
+
+    // Bursts of equal-size envelopes, as produced by per-entity state updates
+    std::vector<UdpEnvelope> envelopes(burst, UdpEnvelope("push", json{{"entity", std::string(200, 'e')}}));
+    size_t envelopeBytes = envelopes[0].toJson().dump().size();
+    offloaded = client.getStats().offload.segmentDatagrams;
+    cpu = processCpuUs();
+    start = Clock::now();
+    sent = 0;
+    for (int i = 0; i < rounds; i++) {
+        sent += client.sendBatch(envelopes);
+    }
+    printRow(name, "sendBatch", sent, sent * envelopeBytes, elapsedUs(start), processCpuUs() - cpu,
+             client.getStats().offload.segmentDatagrams - offloaded);
+
+    // Receives: learn the client's address, then send it bursts of equal-size datagrams
+    std::atomic<uint64_t> received(0);
+    client.startReceiver([&](const json&) { received++; });
+    char buffer[2048];
+    while (recv(sink, buffer, sizeof(buffer), MSG_DONTWAIT) > 0) {
+    }
+    client.send(envelopes[0]);
+    struct sockaddr_storage peer;
+    socklen_t peerLen = sizeof(peer);
+    struct pollfd pfd = {sink, POLLIN, 0};
+    poll(&pfd, 1, 1000);
+    recvfrom(sink, buffer, sizeof(buffer), 0, reinterpret_cast<struct sockaddr*>(&peer), &peerLen);
+
+    std::string datagram = envelopes[0].toJson().dump();
+    uint64_t target = static_cast<uint64_t>(rounds) * burst;
+    uint64_t coalesced = client.getStats().offload.groDatagrams;
+    cpu = processCpuUs();
+    start = Clock::now();
+    sent = 0;
+    auto deadline = Clock::now() + std::chrono::seconds(10);
+    while (received < target && Clock::now() < deadline) {
+        if (sent < target && sent - received < static_cast<uint64_t>(4 * burst)) {
+            if (!sendSegmented(sink, peer, peerLen, datagram, burst, offload)) {
+                offload = false;  // Kernel without UDP_SEGMENT: plain datagrams
+                continue;
+            }
+            sent += burst;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    printRow(name, "receive", received, received * datagram.size(), elapsedUs(start), processCpuUs() - cpu,
+             client.getStats().offload.groDatagrams - coalesced);
+    client.stopReceiver();
+
+    UdpOffloadStats stats = client.getStats().offload;
+    if (stats.segmentFallbacks > 0) {
+        std::cout << "  (" << stats.segmentFallbacks << " offloaded sends refused; fell back to sendmmsg)" << std::endl;
+    }
+    close(sink);
+}
+
+int main(int argc, char* argv[]) {
+    int rounds = 5000;
+    int snapshotBytes = 48 * 1024;
+    int burst = 32;
+
+    if (argc >= 2) rounds = std::stoi(argv[1]);
+    if (argc >= 3) snapshotBytes = std::stoi(argv[2]);
+    if (argc >= 4) burst = std::stoi(argv[3]);
+
+    std::cout << "=== UDP Offload Benchmark ===" << std::endl;
+    std::cout << "Rounds: " << rounds << ", snapshot: " << snapshotBytes << " bytes in 1200-byte fragments"
+              << ", burst: " << burst << " envelopes" << std::endl;
+    std::cout << "dgrams/core-s = datagrams per second of process CPU time (user + system)" << std::endl;
+    std::cout << std::endl;
+    std::cout << std::left << std::setw(9) << "mode" << std::setw(12) << "path"
+              << std::right << std::setw(10) << "dgrams"
+              << std::setw(12) << "dgrams/s"
+              << std::setw(14) << "dgrams/core-s"
+              << std::setw(9) << "MB/s"
+              << std::setw(12) << "offloaded" << std::endl;
+
+    runMode("plain", false, rounds, snapshotBytes, burst);
+    runMode("offload", true, rounds, snapshotBytes, burst);
+    return 0;
+}
@@ -0,0 +1,233 @@
+/**
+ * UDP Pull Loss Benchmark
+ * Latency of request/reply pulls with retries under simulated packet loss
+ * and late replies, with one or several requests outstanding
+ */
+
+#include "hmdev/messaging/api/udp_client.h"
+#include "benchmark_utils.h"
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <unistd.h>
+#include <cstring>
+#include <iostream>
+#include <iomanip>
+#include <thread>
+#include <atomic>
+#include <random>
+#include <deque>
+
+using namespace hmdev::messaging;
+using namespace hmdev::messaging::bench;
+
+/**
+ * Local reply server that drops requests and replies with a given
+ * probability and delivers the same share of replies late
+ */
+class LossyServer {
+public:
+    LossyServer(double lossRate, int lateDelayMs, bool echoRequestId)
+        : lossRate_(lossRate), lateDelayMs_(lateDelayMs), echoRequestId_(echoRequestId),
+          running_(true), fd_(socket(AF_INET, SOCK_DGRAM, 0)), port_(0) {
+        struct sockaddr_in addr;
+        std::memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t addrLen = sizeof(addr);
+        if (fd_ >= 0 && bind(fd_, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) == 0 &&
+            getsockname(fd_, reinterpret_cast<struct sockaddr*>(&addr), &addrLen) == 0) {
+            port_ = ntohs(addr.sin_port);
+        }
+        thread_ = std::thread(&LossyServer::run, this);
+    }
+
+    ~LossyServer() {
+        running_ = false;
+        thread_.join();
+        if (fd_ >= 0) {
+            ::close(fd_);
+        }
+    }
+
+    int port() const { return port_; }
+
+private:
+    struct LateReply {
+        Clock::time_point due;
+        std::string data;
+        struct sockaddr_storage peer;
+        socklen_t peerLen;
+    };
+
+    const double lossRate_;
+    const int lateDelayMs_;
+    const bool echoRequestId_;
+    std::atomic<bool> running_;
+    int fd_;
+    int port_;
+    std::thread thread_;
+
+    void run() {
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<double> roll(0.0, 1.0);
+        std::deque<LateReply> late;
+        char buffer[65536];
+
+        while (running_) {
+            struct pollfd pfd = {fd_, POLLIN, 0};
+            poll(&pfd, 1, 1);
+
+            auto now = Clock::now();
+            while (!late.empty() && late.front().due <= now) {
+                const LateReply& reply = late.front();
+                sendto(fd_, reply.data.data(), reply.data.size(), 0,
+                       reinterpret_cast<const struct sockaddr*>(&reply.peer), reply.peerLen);
+                late.pop_front();
+            }
+
+            while (true) {
+                LateReply reply;
+                reply.peerLen = sizeof(reply.peer);
+                ssize_t received = recvfrom(fd_, buffer, sizeof(buffer), MSG_DONTWAIT,
+                                            reinterpret_cast<struct sockaddr*>(&reply.peer), &reply.peerLen);
+                if (received <= 0) {
+                    break;
+                }
+                if (roll(rng) < lossRate_) {
+                    continue;  // Request lost
+                }
+
+                json request = json::parse(buffer, buffer + received, nullptr, false);
+                if (request.is_discarded()) {
+                    continue;
+                }
+                json response = {
+                    {"status", "ok"},
+                    {"result", {{"status", "success"}, {"data", {{"nonce", request["payload"]["nonce"]}}}}}
+                };
+                if (echoRequestId_ && request.contains("requestId")) {
+                    response["requestId"] = request["requestId"];
+                }
+                reply.data = response.dump();
+
+                double r = roll(rng);
+                if (r < lossRate_) {
+                    continue;  // Reply lost
+                }
+                if (r < 2 * lossRate_) {
+                    reply.due = now + std::chrono::milliseconds(lateDelayMs_);
+                    late.push_back(std::move(reply));
+                    continue;
+                }
+                sendto(fd_, reply.data.data(), reply.data.size(), 0,
+                       reinterpret_cast<const struct sockaddr*>(&reply.peer), reply.peerLen);
+            }
+        }
+    }
+};
+
+static void runCase(double lossRate, int concurrency, bool echoRequestId, int pulls, int attemptTimeoutMs) {
+    LossyServer server(lossRate, attemptTimeoutMs * 3, echoRequestId);
+
+    UdpClientConfig config;
+    config.addressFamily = AF_INET;
+    UdpClient client("127.0.0.1", server.port(), config);
+
+    std::vector<std::vector<double>> latencies(concurrency);
+    std::atomic<int> next(0);
+    std::atomic<int> failed(0);
+    std::atomic<int> wrongReplies(0);
+    std::atomic<int> retries(0);
+
+    auto start = Clock::now();
+    std::vector<std::thread> workers;
+    for (int t = 0; t < concurrency; t++) {
+        workers.emplace_back([&, t]() {
+            int nonce;
+            while ((nonce = next++) < pulls) {
+                UdpEnvelope envelope("pull", json{{"sessionId", "bench-session"}, {"nonce", nonce}});
+                auto pullStart = Clock::now();
+                bool done = false;
+
+                // Retry like an application would; each attempt gets a new request ID
+                for (int attempt = 0; attempt < 20 && !done; attempt++) {
+                    if (attempt > 0) {
+                        retries++;
+                    }
+                    json response = client.sendAndWait(envelope, attemptTimeoutMs);
+                    if (response.is_null()) {
+                        continue;
+                    }
+                    if (response["result"]["data"]["nonce"] != nonce) {
+                        wrongReplies++;
+                    }
+                    done = true;
+                }
+
+                if (done) {
+                    latencies[t].push_back(elapsedUs(pullStart));
+                } else {
+                    failed++;
+                }
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    double totalUs = elapsedUs(start);
+
+    std::vector<double> all;
+    for (const auto& samples : latencies) {
+        all.insert(all.end(), samples.begin(), samples.end());
+    }
+    UdpClientStats stats = client.getStats();
+
+    std::cout << std::left << std::setw(8) << (echoRequestId ? "id" : "no-id")
+              << std::right << std::fixed << std::setprecision(1)
+              << std::setw(8) << lossRate * 100
+              << std::setw(6) << concurrency
+              << std::setw(12) << percentile(all, 50)
+              << std::setw(12) << percentile(all, 99)
+              << std::setw(12) << all.size() / (totalUs / 1e6)
+              << std::setw(9) << retries.load()
+              << std::setw(8) << stats.staleReplies
+              << std::setw(8) << wrongReplies.load()
+              << std::setw(8) << failed.load() << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    int pulls = 5000;
+    int attemptTimeoutMs = 20;
+
+    if (argc >= 2) pulls = std::stoi(argv[1]);
+    if (argc >= 3) attemptTimeoutMs = std::stoi(argv[2]);
+
+    std::cout << "=== UDP Pull Loss Benchmark ===" << std::endl;
+    std::cout << "Pulls per case: " << pulls << ", attempt timeout: " << attemptTimeoutMs
+              << " ms, late replies arrive after " << attemptTimeoutMs * 3 << " ms" << std::endl;
+    std::cout << "Loss applies to requests and replies; the same share of replies is late" << std::endl;
+    std::cout << std::endl;
+    std::cout << std::left << std::setw(8) << "reply"
+              << std::right << std::setw(8) << "loss %"
+              << std::setw(6) << "conc"
+              << std::setw(12) << "p50 (us)"
+              << std::setw(12) << "p99 (us)"
+              << std::setw(12) << "pulls/s"
+              << std::setw(9) << "retries"
+              << std::setw(8) << "stale"
+              << std::setw(8) << "wrong"
+              << std::setw(8) << "failed" << std::endl;
+
+    for (int concurrency : {1, 4}) {
+        for (double lossRate : {0.0, 0.01, 0.02, 0.05}) {
+            runCase(lossRate, concurrency, true, pulls, attemptTimeoutMs);
+        }
+    }
+
+    // Server that does not echo request IDs: late replies can be taken for the current request
+    runCase(0.05, 1, false, pulls, attemptTimeoutMs);
+
+    return 0;
+}
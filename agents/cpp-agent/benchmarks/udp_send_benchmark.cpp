@@ -0,0 +1,103 @@
+/**
+ * UDP Send Microbenchmark
+ * Per-datagram cost of resolving on every send (previous UdpClient behaviour)
+ * versus the resolve-once connected socket
+ */
+
+#include "hmdev/messaging/api/udp_client.h"
+#include "benchmark_utils.h"
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <unistd.h>
+#include <cstring>
+#include <iostream>
+#include <iomanip>
+
+using namespace hmdev::messaging;
+using namespace hmdev::messaging::bench;
+
+// Previous per-datagram path: gethostbyname + sendto
+static bool legacySend(int fd, const std::string& host, int port, const UdpEnvelope& envelope) {
+    std::string jsonStr = envelope.toJson().dump();
+
+    struct hostent* server = gethostbyname(host.c_str());
+    if (server == nullptr) {
+        return false;
+    }
+
+    struct sockaddr_in serverAddr;
+    std::memset(&serverAddr, 0, sizeof(serverAddr));
+    serverAddr.sin_family = AF_INET;
+    std::memcpy(&serverAddr.sin_addr.s_addr, server->h_addr, server->h_length);
+    serverAddr.sin_port = htons(port);
+
+    return sendto(fd, jsonStr.c_str(), jsonStr.length(), 0,
+                  reinterpret_cast<struct sockaddr*>(&serverAddr), sizeof(serverAddr)) > 0;
+}
+
+static void printRow(const std::string& label, double totalUs, int count, int failures) {
+    std::cout << std::left << std::setw(24) << label
+              << std::right << std::fixed << std::setprecision(0)
+              << std::setw(14) << totalUs * 1000.0 / count
+              << std::setw(10) << failures << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    int count = 200000;
+    std::string host = "localhost";
+
+    if (argc >= 2) count = std::stoi(argv[1]);
+    if (argc >= 3) host = argv[2];
+
+    // Local sink; datagrams are never read and simply dropped once the buffer fills
+    int sink = socket(AF_INET, SOCK_DGRAM, 0);
+    struct sockaddr_in sinkAddr;
+    std::memset(&sinkAddr, 0, sizeof(sinkAddr));
+    sinkAddr.sin_family = AF_INET;
+    sinkAddr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t sinkLen = sizeof(sinkAddr);
+    if (sink < 0 || bind(sink, reinterpret_cast<struct sockaddr*>(&sinkAddr), sizeof(sinkAddr)) != 0 ||
+        getsockname(sink, reinterpret_cast<struct sockaddr*>(&sinkAddr), &sinkLen) != 0) {
+        std::cerr << "Failed to bind sink socket" << std::endl;
+        return 1;
+    }
+    int port = ntohs(sinkAddr.sin_port);
+
+    UdpEnvelope envelope("push", json{
+        {"sessionId", "bench-session"}, {"type", "GAME_STATE"}, {"to", "*"},
+        {"content", "{\"x\":1.5,\"y\":2.5,\"hp\":100}"}, {"encrypted", false}
+    });
+
+    std::cout << "=== UDP Send Microbenchmark ===" << std::endl;
+    std::cout << "Host: " << host << ":" << port << ", datagrams: " << count << std::endl;
+    std::cout << std::endl;
+    std::cout << std::left << std::setw(24) << "path"
+              << std::right << std::setw(14) << "ns/datagram"
+              << std::setw(10) << "failed" << std::endl;
+
+    int legacyFd = socket(AF_INET, SOCK_DGRAM, 0);
+    int failures = 0;
+    auto start = Clock::now();
+    for (int i = 0; i < count; i++) {
+        if (!legacySend(legacyFd, host, port, envelope)) failures++;
+    }
+    printRow("resolve per send", elapsedUs(start), count, failures);
+    close(legacyFd);
+
+    UdpClientConfig config;
+    config.addressFamily = AF_INET;  // The sink listens on IPv4 loopback
+    UdpClient client(host, port, config);
+    client.resolve();
+
+    failures = 0;
+    start = Clock::now();
+    for (int i = 0; i < count; i++) {
+        if (!client.send(envelope)) failures++;
+    }
+    printRow("connected (UdpClient)", elapsedUs(start), count, failures);
+
+    close(sink);
+    return 0;
+}
@@ -0,0 +1,121 @@
+/**
+ * UDP Socket Tuning Benchmark
+ * Loopback bursts against UdpClient receive buffers of different sizes:
+ * datagrams delivered, kernel drops reported by SO_RXQ_OVFL, and the time
+ * between the kernel's receive timestamp and the client's read
+ */
+
+#include "hmdev/messaging/api/udp_client.h"
+#include "benchmark_utils.h"
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <unistd.h>
+#include <cstring>
+#include <iostream>
+#include <iomanip>
+#include <thread>
+
+using namespace hmdev::messaging;
+using namespace hmdev::messaging::bench;
+
+static int bindLoopback(int& port) {
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    struct sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t addrLen = sizeof(addr);
+    if (fd < 0 || bind(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        getsockname(fd, reinterpret_cast<struct sockaddr*>(&addr), &addrLen) != 0) {
+        return -1;
+    }
+    port = ntohs(addr.sin_port);
+    return fd;
+}
+
+static void runBuffer(int receiveBufferSize, int burst, int stallMs) {
+    int peerPort = 0;
+    int peer = bindLoopback(peerPort);
+    if (peer < 0) {
+        std::cerr << "Failed to bind peer socket" << std::endl;
+        return;
+    }
+
+    UdpClientConfig config;
+    config.addressFamily = AF_INET;
+    config.receiveBufferSize = receiveBufferSize;
+    config.timestamping = UdpTimestamping::SOFTWARE;
+    config.countKernelDrops = true;
+    UdpClient client("127.0.0.1", peerPort, config);
+
+    // Learn the client's address from one datagram
+    UdpEnvelope envelope("push", json{{"entity", std::string(200, 'e')}});
+    client.send(envelope);
+    char buffer[2048];
+    struct sockaddr_storage address;
+    socklen_t addressLen = sizeof(address);
+    struct pollfd pfd = {peer, POLLIN, 0};
+    poll(&pfd, 1, 1000);
+    recvfrom(peer, buffer, sizeof(buffer), 0, reinterpret_cast<struct sockaddr*>(&address), &addressLen);
+
+    // The burst lands while the application is busy (a long frame), then is drained at once
+    std::string datagram = envelope.toJson().dump();
+    for (int i = 0; i < burst; i++) {
+        sendto(peer, datagram.data(), datagram.size(), 0, reinterpret_cast<struct sockaddr*>(&address), addressLen);
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(stallMs));
+
+    std::vector<double> queuedUs;
+    std::vector<json> messages;
+    while (client.receiveBatch(messages, 20) > 0) {
+        for (const auto& message : messages) {
+            if (message.contains("rxTimestamp")) {
+                const json& stamp = message["rxTimestamp"];
+                queuedUs.push_back((stamp["readNs"].get<int64_t>() - stamp["kernelNs"].get<int64_t>()) / 1000.0);
+            }
+        }
+        messages.clear();
+    }
+    size_t received = queuedUs.size();
+
+    // The drop count rides on datagrams queued after the drops; one more brings it in
+    sendto(peer, datagram.data(), datagram.size(), 0, reinterpret_cast<struct sockaddr*>(&address), addressLen);
+    client.receiveBatch(messages, 100);
+
+    UdpClientStats stats = client.getStats();
+    std::cout << std::setw(10) << (receiveBufferSize > 0 ? std::to_string(receiveBufferSize) : "default")
+              << std::setw(12) << stats.receiveBufferSize
+              << std::setw(10) << burst
+              << std::setw(10) << received
+              << std::setw(10) << stats.kernelDrops
+              << std::fixed << std::setprecision(0)
+              << std::setw(12) << percentile(queuedUs, 50)
+              << std::setw(12) << percentile(queuedUs, 99) << std::endl;
+    close(peer);
+}
+
+int main(int argc, char* argv[]) {
+    int burst = 5000;
+    int stallMs = 16;
+
+    if (argc >= 2) burst = std::stoi(argv[1]);
+    if (argc >= 3) stallMs = std::stoi(argv[2]);
+
+    std::cout << "=== UDP Socket Tuning Benchmark ===" << std::endl;
+    std::cout << "Burst: " << burst << " datagrams while the application is busy for " << stallMs << " ms" << std::endl;
+    std::cout << "queued = rxTimestamp.readNs - rxTimestamp.kernelNs (time between kernel receive and read)"
+              << std::endl;
+    std::cout << std::endl;
+    std::cout << std::setw(10) << "requested" << std::setw(12) << "SO_RCVBUF"
+              << std::setw(10) << "sent"
+              << std::setw(10) << "received"
+              << std::setw(10) << "dropped"
+              << std::setw(12) << "queued p50"
+              << std::setw(12) << "p99 (us)" << std::endl;
+
+    runBuffer(0, burst, stallMs);
+    runBuffer(1024 * 1024, burst, stallMs);
+    runBuffer(8 * 1024 * 1024, burst, stallMs);
+    return 0;
+}
@@ -4,6 +4,7 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <cstdint>
 #include <nlohmann/json.hpp>
 
 namespace hmdev {
@@ -192,6 +193,7 @@ struct MessageReceiveRequest {
 struct UdpEnvelope {
     std::string action;  // "push" or "pull"
     json payload;
+    std::string requestId;  // Echoed in the reply to correlate it (empty = none)
 
     UdpEnvelope() = default;
     UdpEnvelope(const std::string& act, const json& pay)
@@ -199,6 +201,14 @@ struct UdpEnvelope {
 
     json toJson() const;
     static UdpEnvelope fromJson(const json& j);
+
+    /**
+     * Read the request ID of an envelope or reply
+     * @param j Envelope or reply JSON
+     * @param requestId Set to the ID; numeric IDs are taken in decimal
+     * @return False if there is no string or non-negative integer ID
+     */
+    static bool readRequestId(const json& j, std::string& requestId);
 };
 
 } // namespace messaging
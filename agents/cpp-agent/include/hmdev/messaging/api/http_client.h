@@ -3,7 +3,15 @@
 
 #include <string>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <future>
+#include <functional>
 #include <nlohmann/json.hpp>
+#include "transport.h"
+#include "http_connection_pool.h"
+#include "http_event_loop.h"
+#include "http_transport_context.h"
 
 namespace hmdev {
 namespace messaging {
@@ -21,41 +29,63 @@ enum class HttpMethod {
 };
 
 /**
- * HTTP response result
+ * HTTP protocol version
  */
-struct HttpClientResult {
-    int statusCode;
-    std::string data;
-    bool success;
-
-    HttpClientResult() : statusCode(0), success(false) {}
+enum class HttpVersion {
+    HTTP_1_1,               // One request per connection at a time
+    HTTP_2,                 // HTTP/2 over TLS (ALPN), falls back to HTTP/1.1
+    HTTP_2_PRIOR_KNOWLEDGE  // HTTP/2 without negotiation (cleartext h2c)
+};
 
-    bool isHttpOk() const { return statusCode >= 200 && statusCode < 300; }
-    json dataAsJson() const;
+/**
+ * HTTP client configuration
+ */
+struct HttpClientConfig {
+    int maxConnectionsPerHost;   // Cap on pooled keep-alive connections per host
+    HttpVersion httpVersion;     // HTTP/2 multiplexes all requests on one connection
+    bool compressResponses;      // Send Accept-Encoding for every decoder libcurl has (gzip, zstd, ...)
+    size_t compressRequestsAbove;  // Gzip request bodies larger than this many bytes (0 = never)
+    std::shared_ptr<HttpTransportContext> transportContext;  // Shared DNS/TLS/connection cache (null = private)
+    int prewarmConnections;      // Connections MessagingChannelApi opens in the background at construction (0 = none)
+
+    HttpClientConfig()
+        : maxConnectionsPerHost(8), httpVersion(HttpVersion::HTTP_1_1),
+          compressResponses(false), compressRequestsAbove(0), prewarmConnections(0) {}
 };
 
 /**
  * HTTP client for REST API calls
+ *
+ * Thread-safe: each request leases a keep-alive CURL handle from an internal
+ * pool, so a long-poll and concurrent pushes do not share connection state.
+ * Asynchronous requests are driven by a single curl_multi event loop thread
+ * that is started on first use.
+ *
+ * In HTTP/2 mode every request, synchronous or not, goes through the event
+ * loop so that all actions are multiplexed as streams on one connection
+ * instead of queueing behind a long-poll.
  */
-class HttpClient {
+class HttpClient : public HttpTransport {
 public:
     /**
      * Constructor
      * @param baseUrl Base URL for API (e.g., "https://api.example.com")
+     * @param config Client configuration
      */
-    explicit HttpClient(const std::string& baseUrl);
+    explicit HttpClient(const std::string& baseUrl,
+                        const HttpClientConfig& config = HttpClientConfig());
 
     /**
      * Destructor
      */
-    ~HttpClient();
+    ~HttpClient() override;
 
     /**
      * Set default header for all requests
      * @param key Header key
      * @param value Header value
      */
-    void setDefaultHeader(const std::string& key, const std::string& value);
+    void setDefaultHeader(const std::string& key, const std::string& value) override;
 
     /**
      * Remove default header
@@ -93,19 +123,128 @@ public:
      */
     HttpClientResult post(const std::string& path,
                          const json& body,
-                         int timeoutMs = 30000);
+                         int timeoutMs = 30000) override;
+
+    /**
+     * Make asynchronous HTTP request
+     * @param method HTTP method
+     * @param path API path
+     * @param body Request body as JSON
+     * @param timeoutMs Timeout in milliseconds
+     * @param callback Invoked once on the event loop thread; must not block
+     */
+    void requestAsync(HttpMethod method,
+                      const std::string& path,
+                      const json& body,
+                      int timeoutMs,
+                      HttpCallback callback);
+
+    /**
+     * Make asynchronous HTTP request
+     * @param method HTTP method
+     * @param path API path
+     * @param body Request body as JSON
+     * @param timeoutMs Timeout in milliseconds
+     * @return Future resolved with the HTTP response result
+     */
+    std::future<HttpClientResult> requestAsync(HttpMethod method,
+                                               const std::string& path,
+                                               const json& body = nullptr,
+                                               int timeoutMs = 30000);
+
+    /**
+     * Make asynchronous HTTP POST request
+     * @param path API path
+     * @param body Request body as JSON
+     * @param timeoutMs Timeout in milliseconds
+     * @return Future resolved with the HTTP response result
+     */
+    std::future<HttpClientResult> postAsync(const std::string& path,
+                                            const json& body,
+                                            int timeoutMs = 30000);
+
+    /**
+     * Make asynchronous HTTP POST request
+     * @param path API path
+     * @param body Request body as JSON
+     * @param timeoutMs Timeout in milliseconds
+     * @param callback Invoked once on the event loop thread; must not block
+     */
+    void postAsync(const std::string& path,
+                   const json& body,
+                   int timeoutMs,
+                   HttpCallback callback) override;
+
+    /**
+     * Open keep-alive connections ahead of the first request
+     *
+     * Issues HEAD requests to the base URL in parallel so DNS, TCP and TLS
+     * setup are done and the connections are parked in the pool. The response
+     * status is ignored. In HTTP/2 mode a single multiplexed connection is
+     * opened. Blocks until all connections are established or time out.
+     * @param connections Number of connections (capped at maxConnectionsPerHost)
+     * @param timeoutMs Timeout in milliseconds per connection
+     * @return Number of connections established
+     */
+    int prewarm(int connections, int timeoutMs = 10000) override;
 
     /**
      * Close all connections
      */
-    void closeAll();
+    void closeAll() override;
+
+    /**
+     * Get connection pool statistics
+     * @return Pool hit/miss/wait counters and handle counts
+     */
+    HttpPoolStats getPoolStats() const override;
+
+    /**
+     * Get compressed/uncompressed byte counters per action path
+     * @return Map of path (e.g., "/pull") to transfer statistics
+     */
+    std::map<std::string, HttpTransferStats> getTransferStats() const override;
+
+    /**
+     * Get effective HTTP version (HTTP/2 falls back if libcurl lacks support)
+     * @return HTTP version in use
+     */
+    HttpVersion getHttpVersion() const { return httpVersion_; }
 
 private:
     std::string baseUrl_;
+    std::string host_;  // Pool key derived from baseUrl_
+    HttpVersion httpVersion_;
+    std::shared_ptr<HttpTransportContext> transportContext_;  // Must outlive all handles
     std::map<std::string, std::string> defaultHeaders_;
-    void* curlHandle_;  // CURL handle (opaque pointer)
+    std::shared_ptr<void> headerList_;  // Prebuilt curl_slist, rebuilt only when headers change
+    std::shared_ptr<void> gzipHeaderList_;  // Same list plus Content-Encoding: gzip
+    mutable std::mutex headersMutex_;   // Guards defaultHeaders_ and the header lists
+    bool compressResponses_;
+    size_t compressRequestsAbove_;
+    std::map<std::string, HttpTransferStats> transferStats_;
+    mutable std::mutex statsMutex_;
+    std::unique_ptr<HttpConnectionPool> pool_;
+    std::unique_ptr<HttpEventLoop> eventLoop_;
+    std::once_flag eventLoopOnce_;
+
+    void buildUrl(const std::string& path, std::string& url) const;
+
+    void rebuildHeaderList();
+
+    HttpEventLoop& eventLoop();
+
+    void configureRequest(HttpConnection& connection,
+                          HttpMethod method,
+                          const std::string& path,
+                          const json& body,
+                          long timeoutMs) const;
+
+    void configurePrewarm(HttpConnection& connection, long timeoutMs) const;
+
+    static void serializeBody(HttpConnection& connection, const json& body);
 
-    std::string buildUrl(const std::string& path) const;
+    HttpClientResult completeRequest(HttpConnection& connection, int curlCode);
 };
 
 } // namespace messaging
@@ -0,0 +1,163 @@
+#ifndef HMDEV_MESSAGING_HTTP_CONNECTION_POOL_H
+#define HMDEV_MESSAGING_HTTP_CONNECTION_POOL_H
+
+#include <string>
+#include <map>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+
+namespace hmdev {
+namespace messaging {
+
+/**
+ * Connection pool statistics snapshot
+ */
+struct HttpPoolStats {
+    uint64_t hits;       // Leases served by an idle keep-alive handle
+    uint64_t misses;     // Leases that had to create a new handle
+    uint64_t waits;      // Leases that blocked on the per-host cap
+    uint64_t timeouts;   // Leases that gave up waiting for a free handle
+    size_t active;       // Handles currently leased
+    size_t idle;         // Handles parked in the pool
+
+    HttpPoolStats() : hits(0), misses(0), waits(0), timeouts(0), active(0), idle(0) {}
+};
+
+/**
+ * Pooled keep-alive connection: a CURL easy handle plus request buffers that
+ * keep their capacity across requests
+ */
+struct HttpConnection {
+    void* handle;                    // CURL easy handle (opaque pointer)
+    std::string url;                 // Reused URL buffer
+    std::string path;                // Action path, key for transfer statistics
+    std::string requestBody;         // Reused serialization buffer
+    std::string compressedBody;      // Reused gzip buffer for large request bodies
+    bool bodyCompressed;             // Whether compressedBody is sent for this transfer
+    std::string responseBody;        // Receive buffer, moved into the result
+    size_t responseSizeHint;         // Largest response seen, reserved after each move
+    std::shared_ptr<void> headers;   // Header list snapshot kept alive during a transfer
+
+    HttpConnection() : handle(nullptr), bodyCompressed(false), responseSizeHint(0) {}
+};
+
+/**
+ * Thread-safe pool of keep-alive CURL easy handles
+ *
+ * Each handle keeps its own connection cache, so a handle returned to the
+ * pool keeps its TCP/TLS connection open for the next lease. The number of
+ * handles per host (leased + idle) is capped; callers block until a handle
+ * is returned or their timeout expires.
+ */
+class HttpConnectionPool {
+private:
+    struct HostBucket;
+
+public:
+    /**
+     * Leased CURL handle, returned to the pool on destruction
+     */
+    class Lease {
+    public:
+        Lease() : pool_(nullptr), bucket_(nullptr), connection_(nullptr), generation_(0) {}
+        ~Lease() { release(); }
+
+        Lease(Lease&& other) noexcept;
+        Lease& operator=(Lease&& other) noexcept;
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+
+        /**
+         * Get leased CURL handle (opaque pointer)
+         * @return CURL handle or nullptr if the lease is empty
+         */
+        void* handle() const { return connection_ ? connection_->handle : nullptr; }
+
+        /**
+         * Get leased connection with its reusable buffers
+         * @return Connection or nullptr if the lease is empty
+         */
+        HttpConnection* connection() const { return connection_; }
+
+        explicit operator bool() const { return connection_ != nullptr; }
+
+        /**
+         * Return the handle to the pool early
+         */
+        void release();
+
+    private:
+        friend class HttpConnectionPool;
+
+        Lease(HttpConnectionPool* pool, HostBucket* bucket,
+              HttpConnection* connection, uint64_t generation)
+            : pool_(pool), bucket_(bucket), connection_(connection), generation_(generation) {}
+
+        HttpConnectionPool* pool_;
+        HostBucket* bucket_;  // Map nodes are stable, so no per-lease host copy
+        HttpConnection* connection_;
+        uint64_t generation_;
+    };
+
+    /**
+     * Constructor
+     * @param maxConnectionsPerHost Maximum handles (leased + idle) per host
+     */
+    explicit HttpConnectionPool(int maxConnectionsPerHost = 8);
+
+    /**
+     * Destructor - closes all idle handles
+     */
+    ~HttpConnectionPool();
+
+    HttpConnectionPool(const HttpConnectionPool&) = delete;
+    HttpConnectionPool& operator=(const HttpConnectionPool&) = delete;
+
+    /**
+     * Lease a handle for the given host
+     * @param host Host key (e.g., "api.example.com")
+     * @param timeoutMs Maximum time to wait for a free handle
+     * @return Lease (empty on timeout or handle creation failure)
+     */
+    Lease acquire(const std::string& host, int timeoutMs);
+
+    /**
+     * Close all idle handles; leased handles are closed when returned
+     */
+    void clear();
+
+    /**
+     * Get pool statistics
+     * @return Statistics snapshot
+     */
+    HttpPoolStats getStats() const;
+
+    int getMaxConnectionsPerHost() const { return maxConnectionsPerHost_; }
+
+private:
+    struct HostBucket {
+        std::vector<HttpConnection*> idle;
+        size_t active;
+
+        HostBucket() : active(0) {}
+    };
+
+    const int maxConnectionsPerHost_;
+    mutable std::mutex mutex_;
+    std::condition_variable available_;
+    std::map<std::string, HostBucket> buckets_;
+    uint64_t generation_;
+    HttpPoolStats stats_;
+
+    void release(HostBucket* bucket, HttpConnection* connection, uint64_t generation);
+
+    static void destroy(HttpConnection* connection);
+};
+
+} // namespace messaging
+} // namespace hmdev
+
+#endif // HMDEV_MESSAGING_HTTP_CONNECTION_POOL_H
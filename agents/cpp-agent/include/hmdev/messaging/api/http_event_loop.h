@@ -0,0 +1,97 @@
+#ifndef HMDEV_MESSAGING_HTTP_EVENT_LOOP_H
+#define HMDEV_MESSAGING_HTTP_EVENT_LOOP_H
+
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <vector>
+#include <map>
+#include <atomic>
+
+namespace hmdev {
+namespace messaging {
+
+/**
+ * Single-threaded curl_multi event loop for asynchronous HTTP transfers
+ *
+ * Callers configure a recycled CURL easy handle on their own thread, then the
+ * loop thread drives all transfers with curl_multi_poll and invokes each
+ * completion on the loop thread. Completions must not block.
+ */
+class HttpEventLoop {
+public:
+    /**
+     * Configure an easy handle for a transfer (runs on the submitting thread)
+     * @param curlHandle CURL easy handle (opaque pointer)
+     */
+    using Setup = std::function<void(void* curlHandle)>;
+
+    /**
+     * Transfer completion (runs on the loop thread)
+     * @param curlHandle CURL easy handle (opaque pointer)
+     * @param curlCode CURLcode result of the transfer
+     */
+    using Completion = std::function<void(void* curlHandle, int curlCode)>;
+
+    /**
+     * Constructor - starts the loop thread
+     * @param multiplex Multiplex transfers to the same host over one HTTP/2 connection
+     * @param maxIdleHandles Number of finished easy handles kept for reuse
+     */
+    explicit HttpEventLoop(bool multiplex = false, size_t maxIdleHandles = 64);
+
+    /**
+     * Destructor - stops the loop; unfinished transfers complete with an error
+     */
+    ~HttpEventLoop();
+
+    HttpEventLoop(const HttpEventLoop&) = delete;
+    HttpEventLoop& operator=(const HttpEventLoop&) = delete;
+
+    /**
+     * Submit a transfer
+     * @param setup Handle configuration, invoked before this call returns
+     * @param completion Invoked exactly once when the transfer finishes
+     * @return False if the loop is stopped or no handle could be created
+     *         (completion is not invoked in that case)
+     */
+    bool submit(const Setup& setup, Completion completion);
+
+    /**
+     * Get number of transfers submitted but not yet completed
+     * @return Outstanding transfer count
+     */
+    size_t getOutstandingCount() const { return outstanding_.load(); }
+
+    /**
+     * Stop the loop thread
+     */
+    void stop();
+
+private:
+    struct Transfer {
+        void* handle;
+        Completion completion;
+    };
+
+    void* multiHandle_;  // CURLM handle (opaque pointer)
+    const size_t maxIdleHandles_;
+    std::thread thread_;
+    std::atomic<bool> running_;
+    std::atomic<size_t> outstanding_;
+
+    std::mutex mutex_;                  // Guards queued_ and idleHandles_
+    std::vector<Transfer> queued_;      // Submitted, not yet added to the multi handle
+    std::vector<void*> idleHandles_;
+
+    std::map<void*, Completion> active_;  // Loop thread only
+
+    void run();
+    void complete(void* handle, int curlCode);
+    void recycle(void* handle);
+};
+
+} // namespace messaging
+} // namespace hmdev
+
+#endif // HMDEV_MESSAGING_HTTP_EVENT_LOOP_H
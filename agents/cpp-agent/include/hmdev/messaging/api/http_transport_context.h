@@ -0,0 +1,67 @@
+#ifndef HMDEV_MESSAGING_HTTP_TRANSPORT_CONTEXT_H
+#define HMDEV_MESSAGING_HTTP_TRANSPORT_CONTEXT_H
+
+#include <memory>
+#include <mutex>
+
+namespace hmdev {
+namespace messaging {
+
+/**
+ * Process-wide HTTP transport state shared between HttpClient instances
+ *
+ * Wraps a CURLSH share handle so that DNS results and TLS sessions (and,
+ * optionally, open connections) are reused by every client attached to the
+ * context, instead of each MessagingChannelApi resolving and handshaking on
+ * its own.
+ */
+class HttpTransportContext {
+public:
+    /**
+     * Constructor
+     * @param shareDns Share the DNS cache
+     * @param shareTlsSessions Share TLS session IDs (enables session resumption)
+     * @param shareConnections Share the connection cache. libcurl does not support
+     *        sharing it between handles used concurrently from several threads,
+     *        so only enable this when every transfer on the context runs on one
+     *        thread: a single attached HttpClient using only the async API, whose
+     *        transfers all run on its event loop
+     */
+    explicit HttpTransportContext(bool shareDns = true,
+                                  bool shareTlsSessions = true,
+                                  bool shareConnections = false);
+
+    /**
+     * Destructor - clients using the context must be destroyed first
+     */
+    ~HttpTransportContext();
+
+    HttpTransportContext(const HttpTransportContext&) = delete;
+    HttpTransportContext& operator=(const HttpTransportContext&) = delete;
+
+    /**
+     * Get the process-wide default context (created on first use)
+     * @return Shared context
+     */
+    static std::shared_ptr<HttpTransportContext> shared();
+
+    /**
+     * Initialize libcurl exactly once per process; cleaned up at exit
+     */
+    static void initializeCurl();
+
+    /**
+     * Get CURLSH share handle (opaque pointer)
+     * @return Share handle
+     */
+    void* shareHandle() const { return shareHandle_; }
+
+private:
+    void* shareHandle_;  // CURLSH handle (opaque pointer)
+    std::unique_ptr<std::mutex[]> locks_;  // One per curl_lock_data value
+};
+
+} // namespace messaging
+} // namespace hmdev
+
+#endif // HMDEV_MESSAGING_HTTP_TRANSPORT_CONTEXT_H
@@ -0,0 +1,162 @@
+#ifndef HMDEV_MESSAGING_LOOPBACK_SERVER_H
+#define HMDEV_MESSAGING_LOOPBACK_SERVER_H
+
+#include <string>
+#include <map>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <cstdint>
+#include "transport.h"
+
+namespace hmdev {
+namespace messaging {
+
+/**
+ * Loopback server statistics snapshot
+ */
+struct LoopbackServerStats {
+    size_t channels;
+    size_t sessions;
+    uint64_t messages;   // Messages stored across all channels
+    uint64_t requests;   // HTTP and UDP requests handled
+
+    LoopbackServerStats() : channels(0), sessions(0), messages(0), requests(0) {}
+};
+
+/**
+ * In-process messaging service for benchmarks and tests
+ *
+ * Implements create-channel, connect, push, pull (with long-poll),
+ * list-agents, list-system-agents and disconnect over in-memory channels,
+ * with the same JSON responses as the real service. Transports created by
+ * the server plug into MessagingChannelApi, so the whole client stack runs
+ * without a network:
+ *
+ *     auto server = std::make_shared<LoopbackServer>();
+ *     MessagingChannelApi api(server->createHttpTransport(), server->createUdpTransport());
+ *
+ * Global offsets count messages across the server; local offsets index
+ * messages within a channel. Agents do not receive their own messages.
+ * Must be owned by a std::shared_ptr.
+ */
+class LoopbackServer : public std::enable_shared_from_this<LoopbackServer> {
+public:
+    /**
+     * Constructor
+     * @param maxPollWaitMs Upper bound on how long an empty pull is held open
+     */
+    explicit LoopbackServer(int maxPollWaitMs = 1000);
+
+    /**
+     * Destructor - releases pulls still waiting
+     */
+    ~LoopbackServer();
+
+    LoopbackServer(const LoopbackServer&) = delete;
+    LoopbackServer& operator=(const LoopbackServer&) = delete;
+
+    /**
+     * Handle an HTTP action, holding empty pulls open like the real service
+     * @param path Action path (e.g., "/push")
+     * @param body Request body
+     * @param timeoutMs Client timeout in milliseconds
+     * @return HTTP response result
+     */
+    HttpClientResult handleHttp(const std::string& path, const json& body, int timeoutMs);
+
+    /**
+     * Handle a UDP envelope
+     * @param envelope Envelope with action "push", "pull" or "hello" (encoding negotiation)
+     * @return Response datagram, or null for fire-and-forget actions
+     */
+    json handleUdp(const UdpEnvelope& envelope);
+
+    /**
+     * Create an HTTP transport bound to this server
+     * @return Transport; asynchronous requests run on its own dispatcher thread
+     */
+    std::unique_ptr<HttpTransport> createHttpTransport();
+
+    /**
+     * Create a UDP transport bound to this server
+     * @return Transport
+     */
+    std::unique_ptr<UdpTransport> createUdpTransport();
+
+    /**
+     * Release all waiting pulls; later pulls return immediately
+     */
+    void shutdown();
+
+    /**
+     * Get server statistics
+     * @return Statistics snapshot
+     */
+    LoopbackServerStats getStats() const;
+
+private:
+    friend class LoopbackHttpTransport;
+
+    using TimePoint = std::chrono::steady_clock::time_point;
+
+    struct StoredMessage {
+        EventMessage message;
+        std::string senderSessionId;
+    };
+
+    struct Channel {
+        std::string name;
+        std::string password;
+        std::vector<StoredMessage> log;
+    };
+
+    struct Session {
+        std::string channelId;
+        AgentInfo agent;
+    };
+
+    const int maxPollWaitMs_;
+    mutable std::mutex mutex_;
+    std::condition_variable changed_;
+    uint64_t version_;      // Bumped on every state change; waiters compare against it
+    bool shutdown_;
+    std::map<std::string, Channel> channels_;
+    std::map<std::string, std::string> channelsByName_;
+    std::map<std::string, Session> sessions_;
+    uint64_t nextChannelId_;
+    uint64_t nextSessionId_;
+    long long globalOffset_;
+    uint64_t requests_;
+
+    /**
+     * Try to complete a request
+     * @param path Action path
+     * @param body Request body
+     * @param allowWait Whether an empty pull may be deferred
+     * @param result Filled when the request completes
+     * @return False if the pull has nothing to return yet
+     */
+    bool tryHandle(const std::string& path, const json& body, bool allowWait, HttpClientResult& result);
+
+    uint64_t getVersion() const;
+    void waitForChange(uint64_t version, TimePoint deadline);
+    void notifyChange();
+    TimePoint pollDeadline(TimePoint start, int timeoutMs) const;
+
+    // Action handlers; called with mutex_ held
+    int createChannel(const json& body, json& response);
+    int connect(const json& body, json& response);
+    int push(const json& body, json& response);
+    bool pull(const json& body, bool allowWait, int& status, json& response);
+    int listAgents(const json& body, json& response);
+    int disconnect(const json& body, json& response);
+    Session* findSession(const json& body);
+};
+
+} // namespace messaging
+} // namespace hmdev
+
+#endif // HMDEV_MESSAGING_LOOPBACK_SERVER_H
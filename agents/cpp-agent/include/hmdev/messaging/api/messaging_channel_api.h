@@ -2,13 +2,39 @@
 #define HMDEV_MESSAGING_CHANNEL_API_H
 
 #include <memory>
+#include <mutex>
+#include <future>
+#include <functional>
+#include <thread>
 #include "connection_channel_api.h"
 #include "http_client.h"
 #include "udp_client.h"
+#include "hmdev/messaging/util/latency_histogram.h"
 
 namespace hmdev {
 namespace messaging {
 
+/**
+ * Completion callback for sendAsync (invoked on the HTTP event loop thread)
+ */
+using SendCallback = std::function<void(bool)>;
+
+/**
+ * Completion callback for receiveAsync (invoked on the HTTP event loop thread)
+ */
+using ReceiveCallback = std::function<void(const EventMessageResult&)>;
+
+/**
+ * Latency histograms of one HTTP action, one per libcurl timing phase
+ */
+struct ActionLatencyStats {
+    LatencyHistogramSnapshot namelookup;
+    LatencyHistogramSnapshot connect;
+    LatencyHistogramSnapshot appconnect;
+    LatencyHistogramSnapshot starttransfer;
+    LatencyHistogramSnapshot total;
+};
+
 /**
  * Main implementation of ConnectionChannelApi
  * Provides HTTP and UDP communication with messaging platform
@@ -19,9 +45,22 @@ public:
      * Constructor
      * @param remoteUrl Base URL of messaging service (e.g., "https://api.example.com")
      * @param developerApiKey Developer API key (optional)
+     * @param httpConfig HTTP client configuration (connection pool size, etc.);
+     *                   prewarmConnections > 0 starts prewarm() in the background
+     * @param udpConfig UDP client configuration (address family, resolve TTL, etc.)
      */
     MessagingChannelApi(const std::string& remoteUrl,
-                       const std::string& developerApiKey = "");
+                       const std::string& developerApiKey = "",
+                       const HttpClientConfig& httpConfig = HttpClientConfig(),
+                       const UdpClientConfig& udpConfig = UdpClientConfig());
+
+    /**
+     * Constructor with custom transports (e.g., LoopbackServer for benchmarks)
+     * @param httpTransport Transport for REST actions
+     * @param udpTransport Transport for UDP actions
+     */
+    MessagingChannelApi(std::unique_ptr<HttpTransport> httpTransport,
+                       std::unique_ptr<UdpTransport> udpTransport);
 
     /**
      * Destructor
@@ -103,20 +142,224 @@ public:
     EventMessageResult udpPull(const std::string& sessionId,
                               const ReceiveConfig& config) override;
 
+    bool udpPush(const std::string& message,
+                 const std::string& destination,
+                 const std::string& sessionId) override;
+
+    /**
+     * Push message via UDP with a per-message delivery guarantee
+     * @param message Message content
+     * @param destination Destination agent ("*" for all)
+     * @param sessionId Session ID
+     * @param eventType Event type
+     * @param delivery UNRELIABLE (fire and forget), RELIABLE or RELIABLE_ORDERED
+     * @param channel Sequencing channel of reliable messages
+     * @return True if sent; reliable messages are retransmitted until acknowledged
+     */
+    bool udpPush(const std::string& message,
+                 const std::string& destination,
+                 const std::string& sessionId,
+                 EventType eventType,
+                 UdpDelivery delivery,
+                 uint8_t channel = 0);
+
+    /**
+     * Push several messages via UDP in one batch (sendmmsg)
+     * @param messages Message contents, sent in order as separate datagrams
+     * @param destination Destination agent ("*" for all)
+     * @param sessionId Session ID
+     * @param eventType Event type of every message
+     * @return Number of messages sent
+     */
+    size_t udpPushMany(const std::vector<std::string>& messages,
+                       const std::string& destination,
+                       const std::string& sessionId,
+                       EventType eventType = EventType::CHAT_TEXT);
+
+    /**
+     * Push message via UDP, sharing a datagram with other coalesced pushes
+     *
+     * Messages are packed into one datagram until UdpClientConfig::coalescing
+     * .maxDatagramSize is reached, its flush deadline expires or udpFlush()
+     * is called.
+     * @param message Message content
+     * @param destination Destination agent ("*" for all)
+     * @param sessionId Session ID
+     * @param eventType Event type
+     * @return True if queued (or sent)
+     */
+    bool udpPushCoalesced(const std::string& message,
+                          const std::string& destination,
+                          const std::string& sessionId,
+                          EventType eventType = EventType::CHAT_TEXT);
+
+    /**
+     * Send coalesced UDP pushes now (for example at the end of a frame)
+     * @return True if nothing was pending or the datagram was sent
+     */
+    bool udpFlush();
+
+    /**
+     * Start receiving server-pushed UDP datagrams on a background epoll thread
+     * @param callback Invoked on the receiver thread for each datagram (must not block);
+     *                 if empty, datagrams are queued for udpReceive()
+     * @return False if already running or unsupported by the UDP transport
+     */
+    bool startUdpReceiver(UdpMessageCallback callback = nullptr);
+
+    /**
+     * Take server-pushed UDP datagrams queued by the receiver
+     * @param messages Datagrams are appended here
+     * @param timeoutMs Time to wait for the first datagram (0 = do not wait)
+     * @return Number of datagrams appended
+     */
+    size_t udpReceive(std::vector<json>& messages, int timeoutMs = 0);
+
+    /**
+     * Stop the background UDP receiver
+     */
+    void stopUdpReceiver();
+
+    /**
+     * Offer UdpClientConfig::encoding (MessagePack or CBOR) to the server
+     * @param timeoutMs Time to wait for the server's answer
+     * @return Encoding used for UDP sends from now on (JSON if refused)
+     */
+    UdpEncoding negotiateUdpEncoding(int timeoutMs = 1000);
+
+    /**
+     * Start estimating the server clock with periodic UDP time requests
+     * (UdpClientConfig::clockSync sets the schedule)
+     * @return False if unsupported by the UDP transport
+     */
+    bool startUdpClockSync();
+
+    /**
+     * Stop the UDP time requests; serverNow() keeps extrapolating
+     */
+    void stopUdpClockSync();
+
+    /**
+     * Get the estimated server time, e.g. to compare with EventMessage::timestamp
+     * or to schedule inputs against server time
+     * @return Microseconds since the Unix epoch; the local wall clock until synchronized
+     */
+    int64_t serverNow();
+
+    /**
+     * Send/push message asynchronously
+     * @param eventType Event type
+     * @param message Message content
+     * @param destination Destination agent ("*" for all)
+     * @param sessionId Session ID
+     * @param encrypted Whether message is encrypted
+     * @return Future resolved with true if sent successfully
+     */
+    std::future<bool> sendAsync(EventType eventType,
+                                const std::string& message,
+                                const std::string& destination,
+                                const std::string& sessionId,
+                                bool encrypted);
+
+    /**
+     * Send/push message asynchronously
+     * @param eventType Event type
+     * @param message Message content
+     * @param destination Destination agent ("*" for all)
+     * @param sessionId Session ID
+     * @param encrypted Whether message is encrypted
+     * @param callback Invoked once with the send outcome; must not block
+     */
+    void sendAsync(EventType eventType,
+                   const std::string& message,
+                   const std::string& destination,
+                   const std::string& sessionId,
+                   bool encrypted,
+                   SendCallback callback);
+
+    /**
+     * Receive messages asynchronously (long polling without holding a thread)
+     * @param sessionId Session ID
+     * @param config Receive configuration
+     * @return Future resolved with the event message result
+     */
+    std::future<EventMessageResult> receiveAsync(const std::string& sessionId,
+                                                 const ReceiveConfig& config);
+
+    /**
+     * Receive messages asynchronously (long polling without holding a thread)
+     * @param sessionId Session ID
+     * @param config Receive configuration
+     * @param callback Invoked once with the result; must not block
+     */
+    void receiveAsync(const std::string& sessionId,
+                      const ReceiveConfig& config,
+                      ReceiveCallback callback);
+
+    /**
+     * Warm up transports in the background
+     *
+     * Opens keep-alive HTTP connections to the service, resolves the UDP
+     * endpoint and negotiates the UDP encoding so the first connect() only
+     * pays for its own round trips.
+     * Calling it again, from any thread, waits for the previous warm-up to finish first.
+     * @param connections Number of HTTP connections to open
+     * @return Future resolved with true if at least one connection was opened
+     */
+    std::future<bool> prewarm(int connections = 2);
+
     /**
      * Set whether to use public key encryption (currently not implemented)
      * @param usePublicKey Enable public key encryption
      */
     void setUsePublicKey(bool usePublicKey) { usePublicKey_ = usePublicKey; }
 
+    /**
+     * Get HTTP connection pool statistics
+     * @return Pool hit/miss/wait counters and handle counts
+     */
+    HttpPoolStats getHttpPoolStats() const { return httpClient_->getPoolStats(); }
+
+    /**
+     * Get compressed/uncompressed byte counters per HTTP action
+     * @return Map of action path (e.g., "/pull") to transfer statistics
+     */
+    std::map<std::string, HttpTransferStats> getHttpTransferStats() const {
+        return httpClient_->getTransferStats();
+    }
+
+    /**
+     * Get per-action latency histograms (connect, pull, push, ...)
+     *
+     * Recording is lock-free, so this can be scraped at any rate.
+     * @return Map of action name to timing-phase histograms
+     */
+    std::map<std::string, ActionLatencyStats> getLatencyStats() const;
+
 private:
+    /**
+     * Histograms for one action, fixed at construction so recording needs no lock
+     */
+    struct ActionLatency {
+        LatencyHistogram namelookup;
+        LatencyHistogram connect;
+        LatencyHistogram appconnect;
+        LatencyHistogram starttransfer;
+        LatencyHistogram total;
+    };
+
     static constexpr int POLLING_TIMEOUT_MS = 40000;  // 40 seconds
+    static constexpr int REQUEST_TIMEOUT_MS = 30000;  // Non-polling actions
     static constexpr int DEFAULT_UDP_PORT = 9999;
+    static constexpr int PREWARM_TIMEOUT_MS = 10000;
 
-    std::unique_ptr<HttpClient> httpClient_;
-    std::unique_ptr<UdpClient> udpClient_;
+    std::unique_ptr<HttpTransport> httpClient_;
+    std::unique_ptr<UdpTransport> udpClient_;
     bool usePublicKey_;
     std::string defaultPollSource_;  // Default poll source for receive operations
+    std::mutex prewarmMutex_;        // Guards prewarmThread_
+    std::thread prewarmThread_;      // Joined before the clients are destroyed
+    std::map<std::string, std::unique_ptr<ActionLatency>> latency_;  // Keys fixed at construction
 
     /**
      * Create channel on server
@@ -139,6 +382,34 @@ private:
      * @return Full action path
      */
     std::string getActionUrl(const std::string& action) const;
+
+    /**
+     * Create the per-action latency histograms
+     */
+    void initLatencyStats();
+
+    /**
+     * Record request timings into the action's histograms
+     * @param action Action name (e.g., "pull")
+     * @param timings Timings from the HTTP result
+     */
+    void recordLatency(const std::string& action, const HttpTimings& timings);
+
+    /**
+     * Build pull request, applying the default poll source
+     * @param sessionId Session ID
+     * @param config Receive configuration
+     * @return Pull request
+     */
+    MessageReceiveRequest buildReceiveRequest(const std::string& sessionId,
+                                              const ReceiveConfig& config) const;
+
+    /**
+     * Parse pull response
+     * @param httpResult HTTP response result
+     * @return Event message result (empty on failure)
+     */
+    static EventMessageResult parseReceiveResult(const HttpClientResult& httpResult);
 };
 
 } // namespace messaging
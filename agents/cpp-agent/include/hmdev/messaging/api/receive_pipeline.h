@@ -0,0 +1,87 @@
+#ifndef HMDEV_MESSAGING_RECEIVE_PIPELINE_H
+#define HMDEV_MESSAGING_RECEIVE_PIPELINE_H
+
+#include <string>
+#include <future>
+#include <chrono>
+#include <cstdint>
+#include "hmdev/messaging/agent/data_models.h"
+
+namespace hmdev {
+namespace messaging {
+
+class MessagingChannelApi;
+
+/**
+ * Receive pipeline statistics snapshot
+ */
+struct ReceivePipelineStats {
+    uint64_t batches;     // Pull results handed to the caller
+    uint64_t messages;    // Messages in those results (regular + ephemeral)
+    uint64_t failures;    // Pulls that returned no offsets
+    double elapsedSec;    // Time since the first pull was issued
+
+    ReceivePipelineStats() : batches(0), messages(0), failures(0), elapsedSec(0) {}
+
+    double messagesPerSecond() const { return elapsedSec > 0 ? messages / elapsedSec : 0; }
+};
+
+/**
+ * Double-buffered long-poll receive loop
+ *
+ * Keeps one pull in flight while the caller processes the previous batch:
+ * next() waits for the outstanding pull, immediately issues the following
+ * one with the returned nextGlobalOffset/nextLocalOffset, then hands the
+ * batch to the caller. This removes the idle round trip between batches of
+ * a plain receive() loop.
+ *
+ * Not thread-safe; use one pipeline per consuming thread. The API instance
+ * must outlive the pipeline.
+ */
+class ReceivePipeline {
+public:
+    /**
+     * Constructor - issues the first pull
+     * @param api Messaging API used for pulls
+     * @param sessionId Session ID
+     * @param config Initial offsets, batch limit and poll source
+     */
+    ReceivePipeline(MessagingChannelApi& api,
+                    const std::string& sessionId,
+                    const ReceiveConfig& config);
+
+    ReceivePipeline(const ReceivePipeline&) = delete;
+    ReceivePipeline& operator=(const ReceivePipeline&) = delete;
+
+    /**
+     * Wait for the in-flight pull and issue the next one
+     * @return Batch of messages (empty on failure; offsets are kept so the
+     *         next pull retries from the same position)
+     */
+    EventMessageResult next();
+
+    /**
+     * Get offsets the next pull will be issued with
+     * @return Receive configuration
+     */
+    const ReceiveConfig& getConfig() const { return config_; }
+
+    /**
+     * Get throughput statistics
+     * @return Statistics snapshot
+     */
+    ReceivePipelineStats getStats() const;
+
+private:
+    MessagingChannelApi& api_;
+    std::string sessionId_;
+    ReceiveConfig config_;
+    std::future<EventMessageResult> inFlight_;
+    std::chrono::steady_clock::time_point startTime_;
+    ReceivePipelineStats stats_;
+};
+
+} // namespace messaging
+} // namespace hmdev
+
+#endif // HMDEV_MESSAGING_RECEIVE_PIPELINE_H
@@ -0,0 +1,291 @@
+#ifndef HMDEV_MESSAGING_TRANSPORT_H
+#define HMDEV_MESSAGING_TRANSPORT_H
+
+#include <string>
+#include <map>
+#include <vector>
+#include <functional>
+#include <chrono>
+#include <cstdint>
+#include <nlohmann/json.hpp>
+#include "hmdev/messaging/agent/data_models.h"
+#include "http_connection_pool.h"
+#include "hmdev/messaging/util/udp_codec.h"
+#include "hmdev/messaging/util/reliable_udp.h"
+
+namespace hmdev {
+namespace messaging {
+
+using json = nlohmann::json;
+
+/**
+ * Per-request timing breakdown from libcurl, in microseconds since the start
+ * of the transfer (0 for phases skipped on a reused connection)
+ */
+struct HttpTimings {
+    int64_t namelookupUs;     // DNS resolved
+    int64_t connectUs;        // TCP connected
+    int64_t appconnectUs;     // TLS handshake done
+    int64_t starttransferUs;  // First response byte (includes server time)
+    int64_t totalUs;          // Transfer complete
+
+    HttpTimings()
+        : namelookupUs(0), connectUs(0), appconnectUs(0), starttransferUs(0), totalUs(0) {}
+};
+
+/**
+ * HTTP response result
+ */
+struct HttpClientResult {
+    int statusCode;
+    std::string data;
+    bool success;
+    HttpTimings timings;
+
+    HttpClientResult() : statusCode(0), success(false) {}
+
+    bool isHttpOk() const { return statusCode >= 200 && statusCode < 300; }
+    json dataAsJson() const;
+};
+
+/**
+ * Completion callback for asynchronous requests (invoked on the event loop thread)
+ */
+using HttpCallback = std::function<void(const HttpClientResult&)>;
+
+/**
+ * Per-action transfer byte counters
+ */
+struct HttpTransferStats {
+    uint64_t requests;
+    uint64_t compressedRequests;  // Requests sent with Content-Encoding: gzip
+    uint64_t requestBytes;        // Request body bytes before compression
+    uint64_t requestWireBytes;    // Request body bytes sent
+    uint64_t responseBytes;       // Response body bytes after decoding
+    uint64_t responseWireBytes;   // Response body bytes received
+
+    HttpTransferStats()
+        : requests(0), compressedRequests(0), requestBytes(0), requestWireBytes(0),
+          responseBytes(0), responseWireBytes(0) {}
+};
+
+/**
+ * Request/response transport used by MessagingChannelApi for REST actions
+ *
+ * HttpClient is the network implementation; LoopbackServer provides an
+ * in-process one. Implementations must be thread-safe.
+ */
+class HttpTransport {
+public:
+    virtual ~HttpTransport() = default;
+
+    /**
+     * Set default header for all requests
+     * @param key Header key
+     * @param value Header value
+     */
+    virtual void setDefaultHeader(const std::string& key, const std::string& value) = 0;
+
+    /**
+     * Make POST request
+     * @param path API path (e.g., "/connect")
+     * @param body Request body as JSON
+     * @param timeoutMs Timeout in milliseconds
+     * @return HTTP response result
+     */
+    virtual HttpClientResult post(const std::string& path,
+                                  const json& body,
+                                  int timeoutMs = 30000) = 0;
+
+    /**
+     * Make asynchronous POST request
+     * @param path API path
+     * @param body Request body as JSON
+     * @param timeoutMs Timeout in milliseconds
+     * @param callback Invoked once on a transport thread; must not block
+     */
+    virtual void postAsync(const std::string& path,
+                           const json& body,
+                           int timeoutMs,
+                           HttpCallback callback) = 0;
+
+    /**
+     * Open connections ahead of the first request
+     * @param connections Number of connections
+     * @param timeoutMs Timeout in milliseconds per connection
+     * @return Number of connections established
+     */
+    virtual int prewarm(int connections, int timeoutMs = 10000) {
+        (void)timeoutMs;
+        return connections;
+    }
+
+    /**
+     * Close all connections
+     */
+    virtual void closeAll() {}
+
+    /**
+     * Get connection pool statistics
+     * @return Pool statistics (empty if the transport has no pool)
+     */
+    virtual HttpPoolStats getPoolStats() const { return HttpPoolStats(); }
+
+    /**
+     * Get byte counters per action path
+     * @return Map of path to transfer statistics
+     */
+    virtual std::map<std::string, HttpTransferStats> getTransferStats() const {
+        return std::map<std::string, HttpTransferStats>();
+    }
+};
+
+/**
+ * Server-pushed UDP datagram handler
+ * @param message Parsed datagram
+ */
+using UdpMessageCallback = std::function<void(const json& message)>;
+
+/**
+ * Datagram transport used by MessagingChannelApi for UDP actions
+ *
+ * UdpClient is the network implementation; LoopbackServer provides an
+ * in-process one.
+ */
+class UdpTransport {
+public:
+    virtual ~UdpTransport() = default;
+
+    /**
+     * Send envelope (fire and forget)
+     * @param envelope UDP envelope to send
+     * @return True if sent successfully
+     */
+    virtual bool send(const UdpEnvelope& envelope) = 0;
+
+    /**
+     * Send envelope with acknowledgement and retransmission
+     *
+     * The default sends once, for transports that cannot lose datagrams.
+     * @param envelope UDP envelope to send
+     * @param channel Sequencing channel
+     * @param ordered Deliver after all earlier messages of the channel
+     * @return True if sent (or queued for retransmission)
+     */
+    virtual bool sendReliable(const UdpEnvelope& envelope, uint8_t channel = 0, bool ordered = true) {
+        (void)channel;
+        (void)ordered;
+        return send(envelope);
+    }
+
+    /**
+     * Queue a push request to share a datagram with other pushes
+     *
+     * The default sends it at once as its own "push" envelope.
+     * @param request EventMessageRequest JSON
+     * @return True if sent or queued
+     */
+    virtual bool pushCoalesced(const json& request) {
+        return send(UdpEnvelope("push", request));
+    }
+
+    /**
+     * Send queued coalesced pushes now
+     * @return True if nothing was pending or the batch was sent
+     */
+    virtual bool flush() { return true; }
+
+    /**
+     * Send envelope and wait for response
+     * @param envelope UDP envelope to send
+     * @param timeoutMs Timeout in milliseconds
+     * @return Response JSON or null on timeout/error
+     */
+    virtual json sendAndWait(const UdpEnvelope& envelope, int timeoutMs = 3000) = 0;
+
+    /**
+     * Send several envelopes (fire and forget)
+     * @param envelopes Envelopes to send, in order
+     * @return Number of envelopes sent (stops at the first failure)
+     */
+    virtual size_t sendBatch(const std::vector<UdpEnvelope>& envelopes) {
+        size_t sent = 0;
+        while (sent < envelopes.size() && send(envelopes[sent])) {
+            sent++;
+        }
+        return sent;
+    }
+
+    /**
+     * Drain server-pushed datagrams
+     * @param messages Datagrams are appended here
+     * @param timeoutMs Time to wait for the first datagram (0 = do not wait)
+     * @return Number of datagrams appended (0 if the transport has no pushes)
+     */
+    virtual size_t receiveBatch(std::vector<json>& messages, int timeoutMs = 0) {
+        (void)messages;
+        (void)timeoutMs;
+        return 0;
+    }
+
+    /**
+     * Start receiving server pushes on a background thread
+     * @param callback Invoked for each push; if empty, pushes are queued for receiveBatch()
+     * @return False if unsupported or already running
+     */
+    virtual bool startReceiver(UdpMessageCallback callback = nullptr) {
+        (void)callback;
+        return false;
+    }
+
+    /**
+     * Stop the background receiver
+     */
+    virtual void stopReceiver() {}
+
+    /**
+     * Agree on a compact wire encoding with the server
+     * @param timeoutMs Time to wait for the server's answer
+     * @return Encoding used for sending (JSON if not negotiated)
+     */
+    virtual UdpEncoding negotiateEncoding(int timeoutMs = 1000) {
+        (void)timeoutMs;
+        return UdpEncoding::JSON;
+    }
+
+    /**
+     * Start estimating the server clock with periodic time requests
+     * @return False if unsupported
+     */
+    virtual bool startClockSync() { return false; }
+
+    /**
+     * Stop sending time requests; serverNow() keeps extrapolating
+     */
+    virtual void stopClockSync() {}
+
+    /**
+     * Get the estimated server time
+     * @return Microseconds since the Unix epoch (the local wall clock if not synchronized)
+     */
+    virtual int64_t serverNow() {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+    /**
+     * Resolve the server address ahead of the first send
+     * @return True if the endpoint is usable
+     */
+    virtual bool resolve() { return true; }
+
+    /**
+     * Release the underlying socket
+     */
+    virtual void close() {}
+};
+
+} // namespace messaging
+} // namespace hmdev
+
+#endif // HMDEV_MESSAGING_TRANSPORT_H
@@ -2,58 +2,530 @@
 #define HMDEV_MESSAGING_UDP_CLIENT_H
 
 #include <string>
+#include <mutex>
+#include <chrono>
+#include <vector>
+#include <map>
+#include <memory>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <thread>
+#include <sys/socket.h>
+#include <netdb.h>
 #include <nlohmann/json.hpp>
 #include "hmdev/messaging/agent/data_models.h"
+#include "transport.h"
+#include "udp_io_uring.h"
+#include "hmdev/messaging/util/udp_fragmentation.h"
+#include "hmdev/messaging/util/reliable_udp.h"
+#include "hmdev/messaging/util/udp_coalescer.h"
+#include "hmdev/messaging/util/clock_sync.h"
 
 namespace hmdev {
 namespace messaging {
 
 using json = nlohmann::json;
 
+/**
+ * Kernel receive timestamps added to received messages (socket backend only)
+ */
+enum class UdpTimestamping {
+    NONE,      // No timestamps
+    SOFTWARE,  // SO_TIMESTAMPNS: time the kernel queued the datagram
+    HARDWARE   // SO_TIMESTAMPING: NIC time when the driver provides it, plus the software time
+};
+
+/**
+ * UDP client configuration
+ */
+struct UdpClientConfig {
+    int resolveTtlMs;   // Re-resolve the host after this long (0 = never)
+    int addressFamily;  // AF_UNSPEC (IPv6 or IPv4, resolver order), AF_INET or AF_INET6
+    int receiveBatchSize;  // Datagrams drained per recvmmsg call
+    size_t receiveQueueCapacity;  // Server pushes queued by the receiver thread; oldest dropped when full
+    UdpEncoding encoding;  // Encoding offered by negotiateEncoding(); JSON until the server accepts
+    size_t maxDatagramSize;  // Fragment larger datagrams (0 = never; 1200 fits any path MTU)
+    UdpReassemblyConfig reassembly;  // Limits for reassembling received fragments
+    ReliableUdpConfig reliability;   // Timers and buffers of sendReliable()
+    UdpCoalescingConfig coalescing;  // Size budget and deadline of pushCoalesced()
+    ClockSyncConfig clockSync;       // Ping schedule and filters of startClockSync()
+    UdpBackend backend;              // Socket I/O backend, fixed for the client's lifetime
+    UdpIoUringConfig ioUring;        // Rings and buffers of the IO_URING backend
+    bool segmentOffload;             // Send runs of equal-size datagrams as one UDP_SEGMENT (GSO) buffer
+    bool receiveOffload;             // Accept UDP_GRO coalesced buffers and split them on receive
+    int receiveBufferSize;           // SO_RCVBUF in bytes (0 = system default)
+    int sendBufferSize;              // SO_SNDBUF in bytes (0 = system default)
+    UdpTimestamping timestamping;    // Kernel receive timestamps on each received message
+    bool countKernelDrops;           // Count datagrams dropped on a full receive buffer (SO_RXQ_OVFL)
+
+    UdpClientConfig()
+        : resolveTtlMs(60000), addressFamily(AF_UNSPEC), receiveBatchSize(32),
+          receiveQueueCapacity(1024), encoding(UdpEncoding::JSON), maxDatagramSize(0),
+          backend(UdpBackend::SOCKET), segmentOffload(false), receiveOffload(false),
+          receiveBufferSize(0), sendBufferSize(0), timestamping(UdpTimestamping::NONE),
+          countKernelDrops(false) {}
+};
+
+/**
+ * UDP segmentation/receive offload statistics snapshot
+ */
+struct UdpOffloadStats {
+    uint64_t segmentSends;     // UDP_SEGMENT messages sent
+    uint64_t segmentDatagrams; // Datagrams carried by those messages
+    uint64_t segmentFallbacks; // Offloaded sends the kernel refused (offload then disabled)
+    uint64_t groReceives;      // Coalesced buffers received with UDP_GRO
+    uint64_t groDatagrams;     // Datagrams split out of those buffers
+
+    UdpOffloadStats()
+        : segmentSends(0), segmentDatagrams(0), segmentFallbacks(0), groReceives(0), groDatagrams(0) {}
+};
+
+/**
+ * UDP request/reply statistics snapshot
+ */
+struct UdpClientStats {
+    uint64_t requests;      // sendAndWait calls that were sent
+    uint64_t replies;       // Replies matched to a pending request
+    uint64_t timeouts;      // Requests that expired without a reply
+    uint64_t staleReplies;  // Replies for unknown or expired requests (dropped)
+    uint64_t messages;      // Server-pushed datagrams delivered by the receiver thread
+    uint64_t queueDrops;    // Server pushes dropped because the receive queue was full
+    uint64_t fragmentsSent; // Fragments of datagrams above maxDatagramSize
+    uint64_t kernelDrops;   // Datagrams the kernel dropped on a full receive buffer (countKernelDrops)
+    int receiveBufferSize;  // Effective SO_RCVBUF of the current socket (as reported by the kernel)
+    int sendBufferSize;     // Effective SO_SNDBUF of the current socket
+    UdpReassemblyStats reassembly;
+    ReliableUdpStats reliability;
+    UdpCoalescingStats coalescing;
+    UdpIoUringStats ioUring;  // Current socket's rings (IO_URING backend only)
+    UdpOffloadStats offload;
+    ClockSyncStats clockSync;
+
+    UdpClientStats()
+        : requests(0), replies(0), timeouts(0), staleReplies(0), messages(0), queueDrops(0),
+          fragmentsSent(0), kernelDrops(0), receiveBufferSize(0), sendBufferSize(0) {}
+};
+
 /**
  * UDP client for fast message transport
+ *
+ * The host is resolved once with getaddrinfo and the socket is connect()ed
+ * to the first reachable address, so each datagram is a single send() with
+ * no resolver or address handling on the hot path. The address is resolved
+ * again when the TTL expires or after a send reports the peer unreachable;
+ * the lookup runs outside the socket lock, sends keep using the connected
+ * socket meanwhile, and a failed lookup is retried after a second.
+ *
+ * startReceiver() runs an epoll thread that reads the socket continuously:
+ * replies complete their sendAndWait callers, and server-pushed datagrams go
+ * to the callback or, without one, to a queue drained by receiveBatch().
+ *
+ * With maxDatagramSize set, larger datagrams are sent as numbered fragments
+ * (see UdpFragmentation). Received fragments are always reassembled.
+ *
+ * sendReliable() adds sequencing, selective acknowledgement and
+ * retransmission (see ReliableUdpEndpoint); the receiver thread answers
+ * and services them, so the first reliable send starts it if needed.
+ *
+ * pushCoalesced() packs push requests into shared datagrams (see
+ * UdpCoalescer); the receiver thread sends batches whose flush deadline
+ * expires, so the first coalesced push starts it when a deadline is set.
+ *
+ * With UdpBackend::IO_URING every socket gets a UdpIoUring: datagrams are
+ * sent through registered buffers and received by a multishot receive, and
+ * waiting polls the ring's eventfd instead of the socket. If the rings
+ * cannot be set up the client uses plain socket calls.
+ *
+ * With segmentOffload, consecutive equal-size datagrams of one sendmmsg
+ * call (fragments of a snapshot, bursts of equal-size envelopes) go to the
+ * kernel as one UDP_SEGMENT buffer, which is split into datagrams after the
+ * stack (or by the NIC). With receiveOffload the socket enables UDP_GRO and
+ * coalesced buffers are split by their segment size. Both are probed when a
+ * socket is created and only used without io_uring rings; kernels without
+ * support (before 4.18 and 5.0) get the regular path.
+ *
+ * With timestamping set, every message read from the socket gets an
+ * "rxTimestamp" object: "kernelNs" (the kernel's receive time), "readNs"
+ * (when the client read it) and, with NIC support, "hardwareNs", all in
+ * CLOCK_REALTIME nanoseconds. readNs - kernelNs is the time spent queued in
+ * the socket and waiting for the reader to run.
+ *
+ * startClockSync() sends periodic "time" requests from the receiver thread
+ * and feeds the replies to a ClockSync; serverNow() then reads the server
+ * clock estimate at any time without I/O.
  */
-class UdpClient {
+class UdpClient : public UdpTransport {
 public:
     /**
      * Constructor
-     * @param host Server host
+     * @param host Server host name or IPv4/IPv6 literal
      * @param port Server UDP port
+     * @param config Client configuration
      */
-    UdpClient(const std::string& host, int port);
+    UdpClient(const std::string& host, int port,
+              const UdpClientConfig& config = UdpClientConfig());
 
     /**
      * Destructor
      */
-    ~UdpClient();
+    ~UdpClient() override;
 
     /**
      * Send UDP envelope (fire and forget)
      * @param envelope UDP envelope to send
      * @return True if sent successfully
      */
-    bool send(const UdpEnvelope& envelope);
+    bool send(const UdpEnvelope& envelope) override;
 
     /**
-     * Send UDP envelope and wait for response
-     * @param envelope UDP envelope to send
+     * Send UDP envelope and wait for the reply carrying the same request ID
+     *
+     * Thread-safe: any number of requests may be outstanding. One waiting
+     * thread at a time reads the socket and hands replies to their owners by
+     * request ID (sent as a decimal string); replies to expired or unknown
+     * requests are dropped. A reply is a datagram with a "status" member;
+     * replies without a request ID are accepted only while a single request
+     * is pending and are never delivered as server pushes.
+     * @param envelope UDP envelope to send (its requestId is assigned here)
      * @param timeoutMs Timeout in milliseconds
      * @return Response JSON or null on timeout/error
      */
-    json sendAndWait(const UdpEnvelope& envelope, int timeoutMs = 3000);
+    json sendAndWait(const UdpEnvelope& envelope, int timeoutMs = 3000) override;
+
+    /**
+     * Send several envelopes with sendmmsg (one syscall per 1024 datagrams)
+     * @param envelopes Envelopes to send, in order
+     * @return Number of envelopes sent
+     */
+    size_t sendBatch(const std::vector<UdpEnvelope>& envelopes) override;
+
+    /**
+     * Drain waiting server pushes
+     *
+     * Reads the socket with recvmmsg, or takes the receiver thread's queue
+     * while it runs. Replies to outstanding requests are handed to their
+     * waiters and not returned here.
+     * @param messages Parsed datagrams are appended here (invalid JSON is dropped)
+     * @param timeoutMs Time to wait for the first datagram (0 = do not wait)
+     * @return Number of datagrams appended
+     */
+    size_t receiveBatch(std::vector<json>& messages, int timeoutMs = 0) override;
+
+    /**
+     * Send envelope with acknowledgement and retransmission
+     *
+     * Starts the receiver thread (queue mode) if it is not running. Reliable
+     * messages the peer sends are acknowledged and delivered like server
+     * pushes, in sequence order for ordered messages.
+     * @param envelope UDP envelope to send
+     * @param channel Sequencing channel; ordering applies within a channel
+     * @param ordered Deliver only after all earlier messages of the channel
+     * @return False if the message could not be queued (too many in flight)
+     */
+    bool sendReliable(const UdpEnvelope& envelope, uint8_t channel = 0, bool ordered = true) override;
+
+    /**
+     * Queue a push request for a coalesced datagram
+     *
+     * The batch is sent when the next request would exceed
+     * config.coalescing.maxDatagramSize, when its flush deadline expires or
+     * on flush(). Thread-safe.
+     * @param request EventMessageRequest JSON
+     * @return False if a batch completed by this request could not be sent
+     */
+    bool pushCoalesced(const json& request) override;
 
     /**
-     * Close UDP socket
+     * Send the pending coalesced batch now (for example at the end of a frame)
+     * @return True if nothing was pending or the batch was sent
      */
-    void close();
+    bool flush() override;
+
+    /**
+     * Start periodic time requests on the receiver thread (started if needed)
+     * @return False if the receiver could not be started
+     */
+    bool startClockSync() override;
+
+    /**
+     * Stop sending time requests; serverNow() keeps extrapolating
+     */
+    void stopClockSync() override;
+
+    /**
+     * Get the estimated server time with microsecond resolution
+     *
+     * Extrapolated from steady_clock with the filtered offset and drift;
+     * never goes backwards. Thread-safe.
+     * @return Microseconds since the Unix epoch in server time
+     */
+    int64_t serverNow() override;
+
+    /**
+     * Start the background receiver thread
+     * @param callback Invoked on the receiver thread for each server push;
+     *                 if empty, pushes are queued for receiveBatch()
+     * @return False if already running or epoll setup failed
+     */
+    bool startReceiver(UdpMessageCallback callback = nullptr) override;
+
+    /**
+     * Stop the background receiver thread; queued pushes stay available
+     */
+    void stopReceiver() override;
+
+    /**
+     * Offer config.encoding to the server with a "hello" request
+     *
+     * Datagrams are sent as JSON until the server accepts a binary encoding.
+     * Received datagrams are decoded in any encoding regardless.
+     * @param timeoutMs Time to wait for the server's answer
+     * @return Encoding used for sending from now on
+     */
+    UdpEncoding negotiateEncoding(int timeoutMs = 1000) override;
+
+    /**
+     * Get the encoding currently used for sending
+     * @return Active encoding
+     */
+    UdpEncoding getEncoding() const;
+
+    /**
+     * Resolve the server address now and connect the socket to it
+     * @return True if the host resolved and the socket is connected
+     */
+    bool resolve() override;
+
+    /**
+     * Close UDP socket; pending coalesced pushes are sent first
+     */
+    void close() override;
+
+    /**
+     * Get request/reply statistics
+     * @return Statistics snapshot
+     */
+    UdpClientStats getStats() const;
 
 private:
     std::string host_;
     int port_;
+    UdpClientConfig config_;
     int socketFd_;
-    bool isOpen_;
+    bool isOpen_;                      // Socket connected to serverAddr_
+    bool needsResolve_;                // Set after unreachable errors
+    struct sockaddr_storage serverAddr_;
+    std::chrono::steady_clock::time_point resolvedAt_;
+    std::chrono::steady_clock::time_point resolveRetryAt_;  // No lookup from sends before this, after a failure
+    uint64_t socketGeneration_;        // Bumped when the socket is replaced or closed
+    int wakeFd_;                       // eventfd waking the receiver thread, -1 when stopped
+    std::shared_ptr<UdpIoUring> ring_; // IO_URING backend bound to socketFd_, null otherwise
+    mutable std::mutex socketMutex_;   // Guards the socket, address state, ring_ and wakeFd_
+    std::mutex resolveMutex_;          // Held across a lookup, which runs without socketMutex_
+    std::atomic<int> segmentOffloadFd_; // Socket accepting UDP_SEGMENT, -1 if none
+    std::atomic<int> receiveOffloadFd_; // Socket with UDP_GRO enabled, -1 if none
+
+    // Preallocated sendmmsg/recvmmsg state, kept across calls
+    mutable std::mutex sendBatchMutex_;     // Also guards the send counters of offloadStats_
+    std::vector<std::string> sendPayloads_;
+    std::vector<size_t> sendEnvelopeEnds_;  // Datagram index after each envelope of a batch
+    std::vector<struct iovec> sendIov_;
+    std::vector<struct mmsghdr> sendMsgs_;
+    std::vector<char> sendControl_;         // UDP_SEGMENT control messages, one slot per message
+    mutable std::mutex receiveBatchMutex_;  // Also guards reassembler_ and the GRO counters of offloadStats_
+    std::vector<char> receiveBuffer_;
+    std::vector<struct iovec> receiveIov_;
+    std::vector<struct mmsghdr> receiveMsgs_;
+    std::vector<char> receiveControl_;      // UDP_GRO, timestamp and overflow control messages per message
+    UdpOffloadStats offloadStats_;
+    std::atomic<int> timestampFd_;          // Socket with receive timestamps enabled, -1 if none
+    std::atomic<int> dropCountFd_;          // Socket with SO_RXQ_OVFL enabled, -1 if none
+    int dropCountSocket_;                   // Socket the last overflow count came from
+    uint32_t dropCountSeen_;                // Last SO_RXQ_OVFL value of dropCountSocket_
+    uint64_t kernelDrops_;                  // Guarded by receiveBatchMutex_
+    std::atomic<int> receiveBufferSize_;
+    std::atomic<int> sendBufferSize_;
+    UdpReassembler reassembler_;
+    std::string reassembled_;
+
+    // Outstanding sendAndWait requests by request ID
+    struct PendingRequest {
+        bool done;
+        json response;
+
+        PendingRequest() : done(false) {}
+    };
+
+    mutable std::mutex pendingMutex_;  // Guards pending_, readerActive_, receiveQueue_ and stats_
+    std::condition_variable pendingChanged_;
+    std::map<std::string, std::shared_ptr<PendingRequest>> pending_;
+    bool readerActive_;                // A waiter or the receiver thread is reading the socket
+    std::atomic<uint64_t> nextRequestId_;
+    UdpClientStats stats_;
+
+    // Background receiver (see startReceiver)
+    std::thread receiverThread_;
+    std::atomic<bool> receiverRunning_;
+    UdpMessageCallback messageCallback_;  // Only changed while the thread is stopped
+    std::condition_variable receiveQueueChanged_;
+    std::deque<json> receiveQueue_;
+
+    std::atomic<UdpEncoding> activeEncoding_;  // Set by negotiateEncoding()
+    std::atomic<uint32_t> nextMessageId_;      // Fragment message IDs
+    std::atomic<uint64_t> fragmentsSent_;
+
+    mutable std::mutex reliableMutex_;  // Guards reliable_
+    ReliableUdpEndpoint reliable_;
+
+    mutable std::mutex coalesceMutex_;  // Guards coalescer_; held while its datagrams are sent
+    UdpCoalescer coalescer_;
+
+    mutable std::mutex clockMutex_;     // Guards clockSync_
+    ClockSync clockSync_;
+
+    static constexpr size_t MAX_DATAGRAM_SIZE = 65536;
+
+    /**
+     * Send a request tagged with a new request ID and wait for its reply
+     * @param request Request JSON
+     * @param encoding Wire encoding of the request
+     * @param timeoutMs Timeout in milliseconds
+     * @return Reply JSON or null on timeout/error
+     */
+    json sendRequest(json request, UdpEncoding encoding, int timeoutMs);
+
+    /**
+     * Encode a datagram, splitting it into fragments above maxDatagramSize
+     * @param datagram JSON to send
+     * @param encoding Wire encoding
+     * @param out Encoded datagrams are written from out[index] on (grown as needed)
+     * @param index First slot to write
+     * @return Number of datagrams written (0 if too large to fragment)
+     */
+    size_t encodeDatagrams(const json& datagram, UdpEncoding encoding,
+                           std::vector<std::string>& out, size_t index);
+
+    /**
+     * Send encoded datagrams: send() for one, sendmmsg for fragments
+     * @return True if all were sent
+     */
+    bool sendEncoded(int fd, const std::vector<std::string>& datagrams, size_t count);
+
+    /**
+     * Send datagrams with sendmmsg; sendBatchMutex_ must be held
+     * @return Number of datagrams sent
+     */
+    size_t sendDatagrams(int fd, const std::vector<std::string>& datagrams, size_t count);
+
+    /**
+     * Build sendmmsg messages for datagrams [first, count) from sendIov_
+     * @param first First datagram to send
+     * @param count Total number of datagrams
+     * @param segment Merge runs of equal-size datagrams into UDP_SEGMENT messages
+     * @return Number of messages written to sendMsgs_
+     */
+    size_t prepareMessages(size_t first, size_t count, bool segment);
+
+    /**
+     * Enable segmentation/receive offload on a new socket as configured
+     * @param fd Newly connected socket without io_uring rings
+     */
+    void configureOffloadLocked(int fd);
+
+    /**
+     * Apply buffer sizes, receive timestamps and drop counting to a new socket
+     * @param fd Newly created socket
+     * @param control Enable the options that arrive as control messages (no io_uring rings)
+     */
+    void configureSocketLocked(int fd, bool control);
+
+    /**
+     * Read available datagrams and complete their pending requests
+     * @param fd Connected socket
+     * @param timeoutMs Time to wait for the first datagram
+     */
+    void readReplies(int fd, int timeoutMs);
+
+    /**
+     * Hand a datagram to its pending request or the reliability layer
+     * @param datagram Parsed datagram (moved from when consumed)
+     * @param messages Server pushes that are ready for delivery are appended here
+     */
+    void routeDatagram(json& datagram, std::vector<json>& messages);
+
+    /**
+     * Encode and send datagrams produced by the reliability layer or coalescer
+     * @param outgoing Datagrams to send
+     * @return True if all were sent
+     */
+    bool sendGenerated(const std::vector<json>& outgoing);
+
+    /**
+     * Send due acknowledgements, retransmissions and coalesced batches
+     * @return Milliseconds until the next deadline, or -1 if none
+     */
+    int serviceTimers();
+
+    /**
+     * Start the receiver thread if needed and let it pick up a new deadline
+     * @param wake Wake the thread so it recomputes its epoll timeout
+     * @return False if the receiver could not be started
+     */
+    bool scheduleTimer(bool wake);
+
+    /**
+     * Get the io_uring backend of a socket
+     * @param fd Socket descriptor
+     * @return Rings bound to fd, or null when using socket calls
+     */
+    std::shared_ptr<UdpIoUring> ringFor(int fd);
+
+    /**
+     * Get the descriptor that becomes readable when datagrams arrive on a socket
+     * @param fd Socket descriptor
+     * @return The ring's eventfd with the IO_URING backend, otherwise fd
+     */
+    int waitFd(int fd);
+
+    /**
+     * Reassemble and decode one received datagram; receiveBatchMutex_ must be held
+     * @param data Datagram bytes
+     * @param length Datagram length
+     * @param datagrams The parsed datagram is appended here when complete and valid
+     */
+    void decodeDatagram(const char* data, size_t length, std::vector<json>& datagrams);
+
+    /**
+     * Read up to receiveBatchSize datagrams with one recvmmsg call (or from the rings)
+     * @param fd Connected socket
+     * @param datagrams Parsed datagrams are appended here
+     * @return Number of datagrams read (0 when none were waiting)
+     */
+    int readDatagrams(int fd, std::vector<json>& datagrams);
+
+    void runReceiver(int epollFd, int wakeFd);
+    void deliverMessages(std::vector<json>& messages);
+    void wakeReceiverLocked();
+
+    /**
+     * Get the connected socket, resolving and connecting first if needed
+     * @return Socket descriptor or -1 on failure
+     */
+    int connectedSocket();
+
+    bool resolveDueLocked() const;
+
+    /**
+     * Look the host up and connect the socket to the result; the caller holds
+     * resolveMutex_ but not socketMutex_
+     * @return True if the socket is connected to a freshly resolved address
+     */
+    bool lookupAndConnect();
+
+    bool connectLocked(const struct addrinfo* results);
 
-    void ensureSocketOpen();
+    void handleSendError(int error);
 };
 
 } // namespace messaging
@@ -0,0 +1,177 @@
+#ifndef HMDEV_MESSAGING_UDP_IO_URING_H
+#define HMDEV_MESSAGING_UDP_IO_URING_H
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <memory>
+#include <functional>
+#include <cstdint>
+
+namespace hmdev {
+namespace messaging {
+
+/**
+ * Socket I/O backend of UdpClient
+ */
+enum class UdpBackend {
+    SOCKET,    // send/sendmmsg/recvmmsg with poll/epoll readiness (default)
+    IO_URING   // io_uring with registered send buffers and multishot receive; falls back to SOCKET
+};
+
+/**
+ * io_uring backend configuration
+ */
+struct UdpIoUringConfig {
+    unsigned queueDepth;      // Submission queue entries
+    unsigned sendBuffers;     // Registered send buffers (datagrams submitted per io_uring_enter)
+    unsigned receiveBuffers;  // Provided receive buffers (rounded up to a power of two)
+    size_t bufferSize;        // Bytes per buffer; larger datagrams are sent with send() and dropped on receive
+
+    UdpIoUringConfig() : queueDepth(256), sendBuffers(64), receiveBuffers(256), bufferSize(2048) {}
+};
+
+/**
+ * io_uring backend statistics snapshot
+ */
+struct UdpIoUringStats {
+    uint64_t enters;         // io_uring_enter calls
+    uint64_t sent;           // Datagrams sent through registered buffers
+    uint64_t received;       // Datagrams received through provided buffers
+    uint64_t rearms;         // Multishot receives re-armed (buffers ran out or the request ended)
+    uint64_t truncated;      // Received datagrams larger than bufferSize (dropped)
+    uint64_t oversizeSends;  // Datagrams larger than bufferSize sent with send()
+
+    UdpIoUringStats() : enters(0), sent(0), received(0), rearms(0), truncated(0), oversizeSends(0) {}
+};
+
+/**
+ * io_uring submission/completion rings bound to one connected UDP socket
+ *
+ * Outgoing datagrams are copied into buffers registered with the ring and
+ * submitted as IORING_OP_WRITE_FIXED, many per io_uring_enter. Incoming
+ * datagrams land in a provided-buffer ring through one multishot
+ * IORING_OP_RECV, so receiving costs no syscall per datagram. Receive
+ * completions signal eventFd(), which callers poll instead of the socket.
+ *
+ * Uses the kernel ABI directly (no liburing). Thread-safe.
+ */
+class UdpIoUring {
+public:
+    /**
+     * Datagram handler for receive()
+     * @param data Datagram bytes (valid during the call only)
+     * @param length Datagram length
+     */
+    using DatagramHandler = std::function<void(const char* data, size_t length)>;
+
+    /**
+     * Set up the rings and arm the multishot receive
+     * @param socketFd Connected UDP socket (not owned)
+     * @param config Buffer and queue sizes
+     * @return Backend, or null if io_uring is unavailable (kernel, permissions or build)
+     */
+    static std::unique_ptr<UdpIoUring> create(int socketFd, const UdpIoUringConfig& config);
+
+    ~UdpIoUring();
+
+    UdpIoUring(const UdpIoUring&) = delete;
+    UdpIoUring& operator=(const UdpIoUring&) = delete;
+
+    /**
+     * Send datagrams, waiting for their completions
+     * @param datagrams Encoded datagrams
+     * @param count Number of datagrams to send from the front
+     * @return Number sent; errno holds the first error if fewer than count
+     */
+    size_t send(const std::vector<std::string>& datagrams, size_t count);
+
+    /**
+     * Hand received datagrams to a handler without blocking
+     * @param handler Called for each datagram
+     * @param maxDatagrams Maximum number of datagrams to hand over
+     * @return Number of datagrams taken (including dropped oversize ones)
+     */
+    size_t receive(const DatagramHandler& handler, size_t maxDatagrams);
+
+    /**
+     * Get the socket the rings are bound to
+     * @return Socket descriptor
+     */
+    int socket() const { return socketFd_; }
+
+    /**
+     * Get the descriptor to poll for incoming datagrams
+     * @return eventfd signalled by asynchronous completions
+     */
+    int eventFd() const { return eventFd_; }
+
+    /**
+     * Get statistics
+     * @return Statistics snapshot
+     */
+    UdpIoUringStats getStats() const;
+
+private:
+    struct Received {
+        uint16_t bufferId;
+        int32_t length;
+    };
+
+    UdpIoUring(int socketFd, const UdpIoUringConfig& config);
+
+    UdpIoUringConfig config_;
+    int socketFd_;
+    int ringFd_;
+    int eventFd_;
+
+    // Mapped ring memory
+    void* sqRing_;
+    size_t sqRingSize_;
+    void* cqRing_;
+    size_t cqRingSize_;
+    void* sqes_;
+    size_t sqesSize_;
+    unsigned* sqHead_;
+    unsigned* sqTail_;
+    unsigned sqMask_;
+    unsigned* sqArray_;
+    unsigned sqEntries_;
+    unsigned* cqHead_;
+    unsigned* cqTail_;
+    unsigned cqMask_;
+    unsigned* cqFlags_;
+    void* cqes_;
+
+    // Registered send buffers and provided receive buffers
+    char* sendMemory_;
+    size_t sendMemorySize_;
+    char* receiveMemory_;
+    size_t receiveMemorySize_;
+    void* bufferRing_;
+    size_t bufferRingSize_;
+    unsigned receiveEntries_;
+    uint16_t bufferRingTail_;
+
+    mutable std::mutex mutex_;  // Guards the rings and everything below
+    std::deque<Received> received_;
+    unsigned sendsInFlight_;
+    size_t sendsSucceeded_;
+    int sendError_;
+    bool receiveArmed_;
+    UdpIoUringStats stats_;
+
+    bool setup();
+    void armReceiveLocked();
+    int enterLocked(unsigned submit, unsigned waitFor);
+    void reapLocked();
+    void recycleLocked(uint16_t bufferId);
+    void publishBuffersLocked();
+    void* nextSqeLocked();
+};
+
+} // namespace messaging
+} // namespace hmdev
+
+#endif // HMDEV_MESSAGING_UDP_IO_URING_H
@@ -0,0 +1,168 @@
+#ifndef HMDEV_MESSAGING_CLOCK_SYNC_H
+#define HMDEV_MESSAGING_CLOCK_SYNC_H
+
+#include <deque>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include <nlohmann/json.hpp>
+
+namespace hmdev {
+namespace messaging {
+
+using json = nlohmann::json;
+
+/**
+ * Clock synchronization configuration
+ */
+struct ClockSyncConfig {
+    int intervalMs;        // Ping period once the first fastSamples pings are out
+    int fastIntervalMs;    // Ping period while converging after start()
+    int fastSamples;       // Pings sent at fastIntervalMs
+    size_t filterWindow;   // Recent samples the minimum-RTT filter chooses from
+    size_t driftWindow;    // Filtered estimates the drift is fitted over
+    int maxRttMs;          // Replies with a longer round trip are discarded
+    double maxDriftPpm;    // Bound of the drift estimate
+
+    ClockSyncConfig()
+        : intervalMs(1000), fastIntervalMs(100), fastSamples(8), filterWindow(8),
+          driftWindow(16), maxRttMs(1000), maxDriftPpm(500.0) {}
+};
+
+/**
+ * Clock synchronization statistics snapshot
+ */
+struct ClockSyncStats {
+    uint64_t pings;       // Time requests sent
+    uint64_t samples;     // Replies used as samples
+    uint64_t rejected;    // Replies dropped (unknown request, negative or too long round trip)
+    int64_t rttUs;        // Round trip of the sample the estimate is based on
+    int64_t lastRttUs;    // Round trip of the latest sample
+    int64_t offsetUs;     // Estimated server time minus local time, now
+    int64_t lastOffsetUs; // Offset measured by the latest sample (unfiltered)
+    double driftPpm;      // Estimated rate of the server clock relative to steady_clock
+    bool synchronized;    // At least one sample was accepted
+
+    ClockSyncStats()
+        : pings(0), samples(0), rejected(0), rttUs(0), lastRttUs(0), offsetUs(0),
+          lastOffsetUs(0), driftPpm(0.0), synchronized(false) {}
+};
+
+/**
+ * NTP-style estimate of the server clock
+ *
+ * Each ping carries the local send time t0; the server answers with
+ *
+ *     {"action": "time", "t0": t0, "t1": receivedUs, "t2": sentUs}
+ *
+ * in its own microsecond clock (Unix epoch, the clock of
+ * EventMessage::timestamp), and the reply arrives at t3. A sample gives
+ *
+ *     rtt    = (t3 - t0) - (t2 - t1)
+ *     offset = ((t1 - t0) + (t2 - t3)) / 2
+ *
+ * Queueing delay on one path skews the offset by half of it, so the
+ * estimate uses the sample with the smallest round trip among the last
+ * filterWindow. Drift is the least-squares slope of successive filtered
+ * offsets and extrapolates the estimate between samples.
+ *
+ * Local time is steady_clock, so wall clock steps do not disturb the
+ * estimate. Before the first sample the local wall clock stands in for
+ * the server clock. Performs no I/O and is not thread-safe.
+ */
+class ClockSync {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * Constructor
+     * @param config Ping schedule and filter sizes
+     */
+    explicit ClockSync(const ClockSyncConfig& config = ClockSyncConfig());
+
+    /**
+     * Start pinging; the first ping is due immediately
+     * @param now Current time
+     */
+    void start(Clock::time_point now);
+
+    /**
+     * Stop pinging; the estimate keeps extrapolating
+     */
+    void stop();
+
+    /**
+     * Check whether pings are being sent
+     * @return True between start() and stop()
+     */
+    bool isRunning() const { return running_; }
+
+    /**
+     * Emit a ping if one is due
+     * @param now Current time
+     * @param ready The ping datagram is appended here when due
+     */
+    void poll(Clock::time_point now, std::vector<json>& ready);
+
+    /**
+     * Get the time the next ping is due
+     * @return Deadline, or Clock::time_point::max() when stopped
+     */
+    Clock::time_point nextDeadline() const;
+
+    /**
+     * Check whether a datagram is a time reply
+     * @param datagram Received datagram
+     * @return True if it should be passed to receive()
+     */
+    static bool isTimeReply(const json& datagram);
+
+    /**
+     * Add a sample from a time reply
+     * @param reply Time reply datagram
+     * @param now Arrival time
+     * @return True if the sample was accepted
+     */
+    bool receive(const json& reply, Clock::time_point now);
+
+    /**
+     * Get the estimated server time; never goes backwards
+     * @param now Current time
+     * @return Server time in microseconds since the Unix epoch
+     */
+    int64_t serverTimeUs(Clock::time_point now);
+
+    /**
+     * Get statistics
+     * @param now Current time (for offsetUs)
+     * @return Statistics snapshot
+     */
+    ClockSyncStats getStats(Clock::time_point now) const;
+
+private:
+    struct Sample {
+        int64_t localUs;   // Midpoint of the exchange in local time
+        int64_t offsetUs;
+        int64_t rttUs;
+    };
+
+    ClockSyncConfig config_;
+    bool running_;
+    Clock::time_point nextPing_;
+    std::deque<int64_t> outstanding_;  // t0 of pings awaiting a reply, oldest first
+    std::deque<Sample> samples_;       // Last filterWindow samples
+    std::deque<Sample> filtered_;      // Last driftWindow minimum-RTT picks
+    Sample best_;                      // Sample the estimate extrapolates from
+    double drift_;                     // Server microseconds gained per local microsecond
+    int64_t lastServerUs_;             // Last value returned by serverTimeUs()
+    ClockSyncStats stats_;
+
+    static int64_t toLocalUs(Clock::time_point time);
+    int64_t offsetAt(int64_t localUs) const;
+    void fitDrift();
+};
+
+} // namespace messaging
+} // namespace hmdev
+
+#endif // HMDEV_MESSAGING_CLOCK_SYNC_H
@@ -0,0 +1,27 @@
+#ifndef HMDEV_MESSAGING_COMPRESSION_H
+#define HMDEV_MESSAGING_COMPRESSION_H
+
+#include <string>
+
+namespace hmdev {
+namespace messaging {
+
+/**
+ * Compression utilities (zlib)
+ */
+class Compression {
+public:
+    /**
+     * Compress data into gzip format
+     * @param input Uncompressed data
+     * @param output Output buffer (cleared first; capacity is reused)
+     * @param level zlib compression level (1 = fastest, 9 = smallest)
+     * @return True if compressed successfully
+     */
+    static bool gzip(const std::string& input, std::string& output, int level = 6);
+};
+
+} // namespace messaging
+} // namespace hmdev
+
+#endif // HMDEV_MESSAGING_COMPRESSION_H
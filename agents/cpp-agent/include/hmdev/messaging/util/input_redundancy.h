@@ -0,0 +1,178 @@
+#ifndef HMDEV_MESSAGING_INPUT_REDUNDANCY_H
+#define HMDEV_MESSAGING_INPUT_REDUNDANCY_H
+
+#include <deque>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <nlohmann/json.hpp>
+
+namespace hmdev {
+namespace messaging {
+
+using json = nlohmann::json;
+
+/**
+ * Input redundancy configuration
+ */
+struct InputRedundancyConfig {
+    size_t depth;       // Inputs per datagram: the new one plus up to depth - 1 unacknowledged ones
+    size_t maxBytes;    // Older inputs are left out once the content would exceed this
+
+    InputRedundancyConfig() : depth(4), maxBytes(1000) {}
+};
+
+/**
+ * Redundant input sender statistics snapshot
+ */
+struct InputRedundancySenderStats {
+    uint64_t inputs;          // Inputs encoded (one datagram each)
+    uint64_t redundantCopies; // Older inputs carried again
+    uint64_t acks;            // Acknowledgements that released inputs
+    uint64_t bytes;           // Content bytes produced
+    size_t pending;           // Unacknowledged inputs kept for redundancy
+
+    InputRedundancySenderStats() : inputs(0), redundantCopies(0), acks(0), bytes(0), pending(0) {}
+};
+
+/**
+ * Redundant input receiver statistics snapshot
+ */
+struct InputRedundancyReceiverStats {
+    uint64_t datagrams;   // Contents received
+    uint64_t delivered;   // Inputs delivered (each once)
+    uint64_t recovered;   // Delivered from a redundant copy after their own datagram was lost
+    uint64_t duplicates;  // Copies of inputs already delivered or skipped
+    uint64_t lost;        // Inputs skipped because no datagram carrying them arrived in time
+    uint64_t malformed;   // Content that is not an input encoding
+
+    InputRedundancyReceiverStats()
+        : datagrams(0), delivered(0), recovered(0), duplicates(0), lost(0), malformed(0) {}
+};
+
+/**
+ * Sender side of redundant GAME_INPUT datagrams
+ *
+ * Every input gets the next sequence number and is sent as GAME_INPUT
+ * content together with the inputs before it that the receiver has not
+ * acknowledged, newest first:
+ *
+ *     {"s": sequence, "i": [input s, input s - 1, ...]}
+ *
+ * A lost datagram costs nothing as long as one of the next depth - 1
+ * arrives, so there is no retransmission round trip. Acknowledgements
+ * (see RedundantInputReceiver::ack()) are optional and only shrink the
+ * datagrams; without them every datagram carries depth inputs.
+ *
+ * Performs no I/O and is not thread-safe.
+ */
+class RedundantInputSender {
+public:
+    /**
+     * Constructor
+     * @param config Redundancy depth and size budget
+     */
+    explicit RedundantInputSender(const InputRedundancyConfig& config = InputRedundancyConfig());
+
+    /**
+     * Encode the next input with the unacknowledged ones before it
+     * @param input Input (any JSON value)
+     * @return GAME_INPUT content to send
+     */
+    std::string encode(const json& input);
+
+    /**
+     * Release inputs the receiver has
+     * @param sequence Newest sequence the receiver delivered
+     * @return False if the sequence was never sent
+     */
+    bool acknowledge(uint64_t sequence);
+
+    /**
+     * Apply an acknowledgement made by RedundantInputReceiver::ack()
+     * @param content Acknowledgement content
+     * @return False if the content is not an acknowledgement or the sequence was never sent
+     */
+    bool acknowledge(const std::string& content);
+
+    /**
+     * Get the sequence of the last encoded input
+     * @return Sequence, 0 before the first encode()
+     */
+    uint64_t sequence() const { return sequence_; }
+
+    /**
+     * Get statistics
+     * @return Statistics snapshot
+     */
+    InputRedundancySenderStats getStats() const;
+
+private:
+    struct Pending {
+        uint64_t sequence;
+        std::string encoded;   // Input serialized once
+    };
+
+    InputRedundancyConfig config_;
+    uint64_t sequence_;
+    uint64_t acked_;
+    std::deque<Pending> pending_;  // Unacknowledged inputs, oldest first, at most depth
+    InputRedundancySenderStats stats_;
+};
+
+/**
+ * Receiver side of redundant GAME_INPUT datagrams; one per sender
+ *
+ * Delivers each input once, in sequence order, as soon as any datagram
+ * carrying it arrives. Copies of inputs already delivered are dropped by
+ * sequence number. When a datagram skips past inputs no datagram carried in
+ * time (more than depth - 1 consecutive losses), those are counted as lost
+ * and never delivered, so a late input cannot be applied out of order.
+ * Not thread-safe.
+ */
+class RedundantInputReceiver {
+public:
+    RedundantInputReceiver();
+
+    /**
+     * Check whether content is a RedundantInputSender encoding
+     * @param content GAME_INPUT content
+     * @return True if it should be passed to receive()
+     */
+    static bool isEncoded(const std::string& content);
+
+    /**
+     * Take the new inputs of a datagram
+     * @param content GAME_INPUT content
+     * @param inputs New inputs are appended here, oldest first
+     * @return Number of new inputs, 0 for duplicates or malformed content
+     */
+    size_t receive(const std::string& content, std::vector<json>& inputs);
+
+    /**
+     * Get the newest delivered sequence
+     * @return Sequence, 0 if nothing was delivered
+     */
+    uint64_t lastSequence() const { return lastSequence_; }
+
+    /**
+     * Get the acknowledgement to send back to the sender (as GAME_SYNC)
+     * @return {"inputAck": lastSequence()}
+     */
+    std::string ack() const;
+
+    /**
+     * Get statistics
+     * @return Statistics snapshot
+     */
+    InputRedundancyReceiverStats getStats() const { return stats_; }
+
+private:
+    uint64_t lastSequence_;
+    InputRedundancyReceiverStats stats_;
+};
+
+} // namespace messaging
+} // namespace hmdev
+
+#endif // HMDEV_MESSAGING_INPUT_REDUNDANCY_H
@@ -0,0 +1,176 @@
+#ifndef HMDEV_MESSAGING_JITTER_BUFFER_H
+#define HMDEV_MESSAGING_JITTER_BUFFER_H
+
+#include <map>
+#include <deque>
+#include <memory>
+#include <string>
+#include <chrono>
+#include <cstdint>
+#include "hmdev/messaging/agent/data_models.h"
+
+namespace hmdev {
+namespace messaging {
+
+/**
+ * Jitter buffer configuration
+ */
+struct JitterBufferConfig {
+    size_t maxSnapshots;      // Snapshots kept per sender; the oldest are dropped beyond this
+    size_t maxSenders;        // Senders tracked; the least recently heard from is evicted beyond this
+    int minDelayMs;           // Lower bound of the playout delay
+    int maxDelayMs;           // Upper bound of the playout delay
+    double jitterMultiplier;  // Playout delay = send interval + jitterMultiplier * jitter
+    size_t transitWindow;     // Arrivals the minimum transit time is taken over
+
+    JitterBufferConfig()
+        : maxSnapshots(32), maxSenders(64), minDelayMs(0), maxDelayMs(500),
+          jitterMultiplier(3.0), transitWindow(64) {}
+};
+
+/**
+ * Jitter buffer statistics snapshot
+ */
+struct JitterBufferStats {
+    uint64_t received;    // GAME_STATE snapshots accepted
+    uint64_t late;        // Older than the snapshot being interpolated from (dropped)
+    uint64_t duplicates;  // Same sender and localOffset/timestamp seen before (dropped)
+    uint64_t overflows;   // Dropped because a sender's buffer was full
+    uint64_t underruns;   // Queries whose render time was past the newest snapshot
+    uint64_t evictions;   // Senders evicted to respect maxSenders
+    size_t senders;       // Senders currently tracked
+
+    JitterBufferStats()
+        : received(0), late(0), duplicates(0), overflows(0), underruns(0), evictions(0), senders(0) {}
+};
+
+/**
+ * Per-sender playout state
+ */
+struct JitterBufferSenderStats {
+    size_t depth;        // Snapshots buffered
+    double delayMs;      // Current playout delay
+    double jitterMs;     // Interarrival jitter (RFC 3550)
+    double intervalMs;   // Smoothed interval between snapshot timestamps
+
+    JitterBufferSenderStats() : depth(0), delayMs(0.0), jitterMs(0.0), intervalMs(0.0) {}
+};
+
+/**
+ * The two snapshots around a render time
+ *
+ * Interpolate as from + alpha * (to - from). When render time is past the
+ * newest snapshot (underrun) or before the oldest, both point to the same
+ * snapshot and alpha is 0.
+ */
+struct SnapshotPair {
+    std::shared_ptr<const EventMessage> from;
+    std::shared_ptr<const EventMessage> to;
+    double alpha;            // Position of renderTimestampMs between from and to, in [0, 1]
+    double renderTimestampMs;// Sender timestamp being rendered
+    bool underrun;           // Render time is past the newest snapshot
+
+    SnapshotPair() : alpha(0.0), renderTimestampMs(0.0), underrun(false) {}
+};
+
+/**
+ * Per-sender jitter buffer for GAME_STATE snapshots
+ *
+ * Snapshots are ordered by EventMessage::timestamp, then localOffset, and
+ * played out a delay behind the fastest observed arrival: render time is
+ * now - minimum transit - playout delay, in the sender's timestamps. The
+ * delay follows the send interval plus a multiple of the interarrival
+ * jitter; it rises quickly when jitter grows and decays slowly, and render
+ * time holds rather than steps back when it rises. Snapshots older than
+ * the one being interpolated from and duplicates are dropped; each sender
+ * keeps at most maxSnapshots snapshots, and those before the last render
+ * time are released on every sample().
+ *
+ * Performs no I/O and is not thread-safe; callers pass the current time.
+ */
+class SnapshotJitterBuffer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * Constructor
+     * @param config Buffer sizes and delay bounds
+     */
+    explicit SnapshotJitterBuffer(const JitterBufferConfig& config = JitterBufferConfig());
+
+    /**
+     * Add a snapshot
+     * @param message Received message; other types than GAME_STATE are ignored
+     * @param now Arrival time
+     * @return True if buffered
+     */
+    bool push(const EventMessage& message, Clock::time_point now);
+
+    /**
+     * Add the GAME_STATE snapshots of a pull result (messages and ephemeral messages)
+     * @param result Pull result
+     * @param now Arrival time
+     * @return Number of snapshots buffered
+     */
+    size_t push(const EventMessageResult& result, Clock::time_point now);
+
+    /**
+     * Get the two snapshots around a sender's render time
+     * @param sender EventMessage::from of the snapshots
+     * @param now Current time
+     * @param pair Filled with the snapshots and interpolation factor
+     * @return False if nothing is buffered for the sender
+     */
+    bool sample(const std::string& sender, Clock::time_point now, SnapshotPair& pair);
+
+    /**
+     * Forget a sender and its snapshots
+     * @param sender EventMessage::from of the snapshots
+     */
+    void remove(const std::string& sender);
+
+    /**
+     * Get statistics
+     * @return Statistics snapshot
+     */
+    JitterBufferStats getStats() const;
+
+    /**
+     * Get a sender's playout state
+     * @param sender EventMessage::from of the snapshots
+     * @return Playout state (all zero for unknown senders)
+     */
+    JitterBufferSenderStats getSenderStats(const std::string& sender) const;
+
+private:
+    struct Sender {
+        std::deque<std::shared_ptr<const EventMessage>> snapshots;  // Ordered by (timestamp, localOffset)
+        std::deque<int64_t> transits;   // Recent arrival - timestamp, in microseconds
+        int64_t minTransitUs;
+        int64_t lastTransitUs;
+        long long newestTimestampMs;    // Newest timestamp seen, for the interval estimate
+        double jitterUs;
+        double intervalUs;
+        double delayUs;
+        double renderedMs;              // Last render time returned; render time never goes back
+        Clock::time_point lastArrival;
+        bool hasTransit;
+
+        Sender()
+            : minTransitUs(0), lastTransitUs(0), newestTimestampMs(0), jitterUs(0.0), intervalUs(0.0),
+              delayUs(0.0), renderedMs(-1.0), hasTransit(false) {}
+    };
+
+    JitterBufferConfig config_;
+    std::map<std::string, Sender> senders_;
+    JitterBufferStats stats_;
+
+    static int64_t toUs(Clock::time_point time);
+    void updateTiming(Sender& sender, const EventMessage& message, Clock::time_point now);
+    void evictIfFull();
+};
+
+} // namespace messaging
+} // namespace hmdev
+
+#endif // HMDEV_MESSAGING_JITTER_BUFFER_H
@@ -0,0 +1,81 @@
+#ifndef HMDEV_MESSAGING_LATENCY_HISTOGRAM_H
+#define HMDEV_MESSAGING_LATENCY_HISTOGRAM_H
+
+#include <atomic>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace hmdev {
+namespace messaging {
+
+/**
+ * Latency histogram snapshot
+ *
+ * Bucket i counts samples in [2^(i-1), 2^i) microseconds; bucket 0 counts
+ * samples below 1 us and the last bucket is open-ended.
+ */
+struct LatencyHistogramSnapshot {
+    uint64_t count;
+    uint64_t sumUs;
+    uint64_t maxUs;
+    std::vector<uint64_t> buckets;
+
+    LatencyHistogramSnapshot() : count(0), sumUs(0), maxUs(0) {}
+
+    /**
+     * Get exclusive upper bound of a bucket
+     * @param index Bucket index
+     * @return Upper bound in microseconds
+     */
+    static uint64_t bucketUpperBoundUs(size_t index) { return uint64_t(1) << index; }
+
+    /**
+     * Estimate a percentile from the buckets (upper bound of the bucket)
+     * @param p Percentile in [0, 100]
+     * @return Latency in microseconds or 0 if empty
+     */
+    uint64_t percentileUs(double p) const;
+
+    double meanUs() const { return count > 0 ? static_cast<double>(sumUs) / count : 0; }
+};
+
+/**
+ * Lock-free latency histogram with power-of-two microsecond buckets
+ *
+ * Recording is a handful of relaxed atomic increments, so it is safe to call
+ * from the HTTP event loop thread and request threads concurrently; a
+ * snapshot is a consistent-enough copy for monitoring.
+ */
+class LatencyHistogram {
+public:
+    static constexpr size_t BUCKET_COUNT = 28;  // Last bucket starts at ~67 s
+
+    LatencyHistogram();
+
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    /**
+     * Record a sample
+     * @param us Latency in microseconds (negative samples are ignored)
+     */
+    void record(int64_t us);
+
+    /**
+     * Copy the current counters
+     * @return Snapshot
+     */
+    LatencyHistogramSnapshot snapshot() const;
+
+private:
+    std::atomic<uint64_t> buckets_[BUCKET_COUNT];
+    std::atomic<uint64_t> count_;
+    std::atomic<uint64_t> sumUs_;
+    std::atomic<uint64_t> maxUs_;
+};
+
+} // namespace messaging
+} // namespace hmdev
+
+#endif // HMDEV_MESSAGING_LATENCY_HISTOGRAM_H
@@ -0,0 +1,189 @@
+#ifndef HMDEV_MESSAGING_RELIABLE_UDP_H
+#define HMDEV_MESSAGING_RELIABLE_UDP_H
+
+#include <map>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include <nlohmann/json.hpp>
+
+namespace hmdev {
+namespace messaging {
+
+using json = nlohmann::json;
+
+/**
+ * Delivery guarantee of one UDP message
+ */
+enum class UdpDelivery {
+    UNRELIABLE,        // Fire and forget (default)
+    RELIABLE,          // Retransmitted until acknowledged; delivered as soon as it arrives
+    RELIABLE_ORDERED   // Retransmitted until acknowledged; delivered after all earlier messages of its channel
+};
+
+/**
+ * Reliability layer configuration
+ */
+struct ReliableUdpConfig {
+    int initialRtoMs;         // Retransmission timeout before the first RTT sample
+    int minRtoMs;             // Lower bound of the computed timeout
+    int maxRtoMs;             // Upper bound, also for exponential backoff
+    int maxRetransmits;       // A message is given up after this many retransmissions
+    size_t maxInFlight;       // Unacknowledged messages per endpoint; further sends fail
+    size_t maxReorderBuffer;  // Messages held per channel above a gap; later ones are dropped unacknowledged
+
+    ReliableUdpConfig()
+        : initialRtoMs(200), minRtoMs(20), maxRtoMs(2000), maxRetransmits(10),
+          maxInFlight(4096), maxReorderBuffer(1024) {}
+};
+
+/**
+ * Reliability layer statistics snapshot
+ */
+struct ReliableUdpStats {
+    uint64_t sent;          // Reliable messages sent (first transmission)
+    uint64_t retransmits;   // Retransmissions
+    uint64_t acked;         // Messages acknowledged by the peer
+    uint64_t failed;        // Messages given up after maxRetransmits
+    uint64_t delivered;     // Reliable messages delivered to the application
+    uint64_t duplicates;    // Received again after delivery (dropped)
+    uint64_t skipped;       // Sequence numbers passed over because the peer gave up on them
+    uint64_t overflows;     // Received while the reorder buffer was full (dropped unacknowledged)
+    uint64_t acksSent;      // Acknowledgement datagrams sent
+    size_t inFlight;        // Messages currently awaiting acknowledgement
+    int64_t srttUs;         // Smoothed round-trip time (0 before the first sample)
+    int64_t rtoUs;          // Current retransmission timeout
+
+    ReliableUdpStats()
+        : sent(0), retransmits(0), acked(0), failed(0), delivered(0), duplicates(0),
+          skipped(0), overflows(0), acksSent(0), inFlight(0), srttUs(0), rtoUs(0) {}
+};
+
+/**
+ * Sequencing, acknowledgement and retransmission state of one UDP peer
+ *
+ * Reliable datagrams carry a "reliable" object with their channel, sequence
+ * number, ordering flag and the sender's floor: the lowest sequence number
+ * it still retransmits. The receiver answers with "ack" datagrams holding
+ * the cumulative sequence number (everything up to it arrived), the highest
+ * sequence number seen and a 64-bit selective-ACK bitfield for the 64
+ * numbers below it. Retransmission timeouts follow RFC 6298 (smoothed RTT
+ * plus four deviations, Karn's rule, exponential backoff).
+ *
+ * A gap is only passed over once the sender has given up on it: the floor
+ * moves past messages that exhausted maxRetransmits, and a "skip" datagram
+ * repeats it until the receiver acknowledges past it. Messages that arrive
+ * while maxReorderBuffer messages wait above a gap are dropped without
+ * being acknowledged, so the sender retransmits them later.
+ *
+ * Performs no I/O and is not thread-safe; the owner sends what poll()
+ * returns and serializes calls.
+ */
+class ReliableUdpEndpoint {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * Constructor
+     * @param config Reliability configuration
+     */
+    explicit ReliableUdpEndpoint(const ReliableUdpConfig& config = ReliableUdpConfig());
+
+    /**
+     * Tag a datagram for reliable delivery and keep it for retransmission
+     * @param datagram Envelope JSON, tagged in place
+     * @param channel Sequencing channel; ordering applies within a channel
+     * @param ordered Deliver only after all earlier messages of the channel
+     * @param now Current time
+     * @return False if maxInFlight messages are already unacknowledged
+     */
+    bool prepare(json& datagram, uint8_t channel, bool ordered, Clock::time_point now);
+
+    /**
+     * Check whether a datagram belongs to the reliability layer
+     * @param datagram Received datagram
+     * @return True for reliable data, acknowledgements and skip notices
+     */
+    static bool isReliable(const json& datagram);
+
+    /**
+     * Process a reliable data, acknowledgement or skip datagram
+     * @param datagram Received datagram (moved from when delivered)
+     * @param now Current time
+     * @param deliver Messages that became deliverable are appended here,
+     *                without their "reliable" tag
+     */
+    void receive(json& datagram, Clock::time_point now, std::vector<json>& deliver);
+
+    /**
+     * Collect due retransmissions and pending acknowledgements
+     * @param now Current time
+     * @param outgoing Datagrams to send are appended here
+     */
+    void poll(Clock::time_point now, std::vector<json>& outgoing);
+
+    /**
+     * Get the time poll() next has work
+     * @return Earliest deadline, or Clock::time_point::max() if idle
+     */
+    Clock::time_point nextDeadline() const;
+
+    /**
+     * Get statistics
+     * @return Statistics snapshot
+     */
+    ReliableUdpStats getStats() const;
+
+private:
+    struct InFlight {
+        json datagram;
+        Clock::time_point lastSent;
+        Clock::time_point deadline;
+        int retransmits;
+    };
+
+    struct SendChannel {
+        uint64_t nextSeq;
+        std::map<uint64_t, InFlight> inFlight;
+        uint64_t peerCumulative;          // Highest cumulative sequence number the peer acknowledged
+        bool skipPending;                 // The peer still waits on a message given up on
+        Clock::time_point skipDeadline;   // When the skip notice is sent (again)
+        int skipNotices;
+
+        SendChannel() : nextSeq(1), peerCumulative(0), skipPending(false), skipNotices(0) {}
+
+        uint64_t floor() const { return inFlight.empty() ? nextSeq : inFlight.begin()->first; }
+    };
+
+    struct ReceiveChannel {
+        uint64_t cumulative;              // Every sequence number up to here arrived or was given up on
+        uint64_t highest;                 // Highest sequence number seen
+        std::map<uint64_t, json> above;   // Arrived above cumulative; null once delivered
+        bool ackPending;
+
+        ReceiveChannel() : cumulative(0), highest(0), ackPending(false) {}
+    };
+
+    ReliableUdpConfig config_;
+    std::map<uint8_t, SendChannel> sendChannels_;
+    std::map<uint8_t, ReceiveChannel> receiveChannels_;
+    size_t inFlight_;
+    bool ackPending_;
+    int64_t srttUs_;
+    int64_t rttVarUs_;
+    int64_t rtoUs_;
+    ReliableUdpStats stats_;
+
+    void receiveData(json& datagram, std::vector<json>& deliver);
+    void receiveAck(const json& payload, Clock::time_point now);
+    void receiveSkip(const json& payload, std::vector<json>& deliver);
+    void advanceFloor(ReceiveChannel& receiveChannel, uint64_t floor, std::vector<json>& deliver);
+    void deliverInOrder(ReceiveChannel& receiveChannel, std::vector<json>& deliver);
+    void updateRto(int64_t sampleUs);
+    Clock::time_point retransmitDeadline(Clock::time_point sent, int retransmits) const;
+};
+
+} // namespace messaging
+} // namespace hmdev
+
+#endif // HMDEV_MESSAGING_RELIABLE_UDP_H
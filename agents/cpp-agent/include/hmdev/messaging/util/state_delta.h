@@ -0,0 +1,265 @@
+#ifndef HMDEV_MESSAGING_STATE_DELTA_H
+#define HMDEV_MESSAGING_STATE_DELTA_H
+
+#include <map>
+#include <deque>
+#include <string>
+#include <chrono>
+#include <cstdint>
+#include <nlohmann/json.hpp>
+
+namespace hmdev {
+namespace messaging {
+
+using json = nlohmann::json;
+
+/**
+ * Delta encoder configuration
+ */
+struct StateDeltaConfig {
+    size_t historySize;     // Sent states kept as baselines; older acknowledgements force a full snapshot
+    int keyframeInterval;   // Full snapshot at least every N ticks (0 = only when needed)
+    int peerTimeoutMs;      // Receivers silent for this long no longer hold the baseline back
+    size_t maxPeers;        // Receivers tracked; the longest silent is forgotten beyond this
+
+    StateDeltaConfig()
+        : historySize(32), keyframeInterval(0), peerTimeoutMs(2000), maxPeers(128) {}
+};
+
+/**
+ * Delta encoder statistics snapshot
+ */
+struct StateDeltaStats {
+    uint64_t ticks;              // States encoded
+    uint64_t fullSnapshots;      // Encodings returned as full snapshots
+    uint64_t deltas;             // Encodings returned as deltas
+    uint64_t acks;               // Acknowledgements applied
+    uint64_t staleAcks;          // Acknowledgements of a state no longer in history
+    uint64_t rawBytes;           // Sum of the full JSON of every state returned
+    uint64_t encodedBytes;       // Sum of the encodings returned
+    size_t lastRawBytes;         // Full JSON of the last state
+    size_t lastEncodedBytes;     // Last encoding returned
+    double compressionRatio;     // rawBytes / encodedBytes
+    double lastEncodeUs;         // Encode cost of the last tick (encode() and its encodeFor() calls)
+    double meanEncodeUs;         // Mean encode cost per tick
+    size_t peers;                // Receivers currently acknowledging
+
+    StateDeltaStats()
+        : ticks(0), fullSnapshots(0), deltas(0), acks(0), staleAcks(0), rawBytes(0), encodedBytes(0),
+          lastRawBytes(0), lastEncodedBytes(0), compressionRatio(0.0), lastEncodeUs(0.0),
+          meanEncodeUs(0.0), peers(0) {}
+};
+
+/**
+ * Delta decoder statistics snapshot
+ */
+struct StateDeltaDecoderStats {
+    uint64_t fullSnapshots;      // Full snapshots decoded
+    uint64_t deltas;             // Deltas decoded
+    uint64_t missingBaselines;   // Deltas against a state this decoder does not have
+    uint64_t malformed;          // Content that is not a state encoding
+
+    StateDeltaDecoderStats() : fullSnapshots(0), deltas(0), missingBaselines(0), malformed(0) {}
+};
+
+/**
+ * Delta encoder for GAME_STATE content
+ *
+ * Each tick's state is sent as GAME_STATE content in one of two forms:
+ *
+ *     {"s": sequence, "f": state}                   full snapshot
+ *     {"s": sequence, "b": baseline, "d": patch}    delta
+ *
+ * where the patch is a JSON merge patch (RFC 7386) from the baseline state:
+ * changed members with their new value, removed members as null, nested
+ * objects recursively, arrays whole. Keep per-player data in objects keyed
+ * by player id rather than in arrays so unchanged players cost nothing.
+ * Null members cannot be told from removals; leave them out of the state.
+ *
+ * Receivers acknowledge the newest sequence they decoded plus a bitmask of
+ * which of the 64 before it they decoded (see StateDeltaDecoder::ack()).
+ * commit() records a tick's state; encodeFor() then encodes it for one
+ * receiver against the newest state that receiver has decoded. Receivers
+ * sharing a baseline share the encoding, so a room mostly costs one or two
+ * diffs per tick, and a lost state only moves that receiver's baseline
+ * back. encode() records the state and makes one encoding for a broadcast,
+ * against the newest state every receiver heard from within peerTimeoutMs
+ * has decoded; with many lossy receivers such a state is rare, so prefer
+ * encodeFor() with unicast pushes there.
+ *
+ * A full snapshot is sent instead when the receiver has not acknowledged
+ * yet, has no state left in history, asks for one (acknowledges sequence
+ * 0), at keyframe intervals, and when the delta would not be smaller.
+ *
+ * Performs no I/O and is not thread-safe.
+ */
+class StateDeltaEncoder {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * Constructor
+     * @param config History size, keyframe interval and receiver bounds
+     */
+    explicit StateDeltaEncoder(const StateDeltaConfig& config = StateDeltaConfig());
+
+    /**
+     * Record the next state without encoding it (for encodeFor())
+     * @param state Full game state (a JSON object)
+     * @return Its sequence
+     */
+    uint64_t commit(const json& state);
+
+    /**
+     * Record the next state and encode it for all receivers
+     * @param state Full game state (a JSON object)
+     * @param now Current time
+     * @return GAME_STATE content to broadcast
+     */
+    std::string encode(const json& state, Clock::time_point now);
+
+    /**
+     * Encode the last recorded state for one receiver
+     * @param peer Receiver (EventMessage::from of its acknowledgements)
+     * @param now Current time
+     * @return GAME_STATE content to send to the receiver, empty before the first state
+     */
+    std::string encodeFor(const std::string& peer, Clock::time_point now);
+
+    /**
+     * Apply a receiver's acknowledgement
+     * @param peer Receiver (EventMessage::from of the acknowledgement)
+     * @param sequence Newest sequence it decoded; 0 requests a full snapshot
+     * @param mask Bit i set if it also decoded sequence - 1 - i
+     * @param now Current time
+     * @return False if the sequence was never sent
+     */
+    bool acknowledge(const std::string& peer, uint64_t sequence, uint64_t mask, Clock::time_point now);
+
+    /**
+     * Apply an acknowledgement made by StateDeltaDecoder::ack()
+     * @param peer Receiver (EventMessage::from of the acknowledgement)
+     * @param content Acknowledgement content
+     * @param now Current time
+     * @return False if the content is not an acknowledgement or the sequence was never sent
+     */
+    bool acknowledge(const std::string& peer, const std::string& content, Clock::time_point now);
+
+    /**
+     * Send a full snapshot on the next tick
+     */
+    void forceFull() { forceFull_ = true; }
+
+    /**
+     * Get the sequence of the last encoded state
+     * @return Sequence, 0 before the first encode()
+     */
+    uint64_t sequence() const { return sequence_; }
+
+    /**
+     * Get statistics
+     * @param now Current time (for peers)
+     * @return Statistics snapshot
+     */
+    StateDeltaStats getStats(Clock::time_point now) const;
+
+    /**
+     * Compute a JSON merge patch (RFC 7386)
+     * @param from Baseline
+     * @param to Target
+     * @return Patch turning from into to when applied with json::merge_patch()
+     */
+    static json diff(const json& from, const json& to);
+
+private:
+    struct Peer {
+        uint64_t acked;                // Newest sequence decoded, 0 if it needs a full snapshot
+        uint64_t mask;                 // Bit i: acked - 1 - i decoded
+        Clock::time_point lastAck;
+
+        bool has(uint64_t sequence) const;
+    };
+
+    struct Encoding {
+        std::string content;
+        bool full;
+    };
+
+    StateDeltaConfig config_;
+    uint64_t sequence_;
+    bool forceFull_;
+    bool tickFull_;                    // Every encoding of this tick is a full snapshot
+    size_t tickRawBytes_;              // Full JSON size of the current state
+    std::map<uint64_t, Encoding> tickEncodings_;  // Encodings of this tick by baseline (0 = full)
+    std::deque<json> history_;         // Last historySize states; back() is sequence_
+    std::map<std::string, Peer> peers_;
+    StateDeltaStats stats_;
+    double totalEncodeUs_;
+
+    const json* baselineState(uint64_t sequence) const;
+    bool isLive(const Peer& peer, Clock::time_point now) const;
+    bool chooseBaseline(Clock::time_point now, uint64_t& baseline) const;
+    const std::string& encodeAgainst(uint64_t baseline);
+};
+
+/**
+ * Decoder for StateDeltaEncoder content; one per sender
+ *
+ * Keeps the last historySize decoded states so deltas against any baseline
+ * the encoder may still choose can be applied. Not thread-safe.
+ */
+class StateDeltaDecoder {
+public:
+    /**
+     * Constructor
+     * @param historySize Decoded states kept as baselines (match StateDeltaConfig::historySize)
+     */
+    explicit StateDeltaDecoder(size_t historySize = 32);
+
+    /**
+     * Check whether content is a StateDeltaEncoder encoding
+     * @param content GAME_STATE content
+     * @return True for a full snapshot or delta
+     */
+    static bool isEncoded(const std::string& content);
+
+    /**
+     * Decode a state
+     * @param content GAME_STATE content
+     * @param state Decoded full state
+     * @return False if malformed or its baseline is missing (acknowledge to get a full snapshot)
+     */
+    bool decode(const std::string& content, json& state);
+
+    /**
+     * Get the newest decoded sequence
+     * @return Sequence, 0 if nothing was decoded
+     */
+    uint64_t lastSequence() const { return lastSequence_; }
+
+    /**
+     * Get the acknowledgement to send back to the encoder (as GAME_SYNC)
+     * @return {"stateAck": lastSequence(), "mask": bits}, where bit i is set if
+     *         lastSequence() - 1 - i is held as a baseline; sequence 0 after a
+     *         missing baseline until a full snapshot arrives
+     */
+    std::string ack() const;
+
+    /**
+     * Get statistics
+     * @return Statistics snapshot
+     */
+    StateDeltaDecoderStats getStats() const { return stats_; }
+
+private:
+    size_t historySize_;
+    std::map<uint64_t, json> history_;  // Decoded states by sequence, newest historySize_
+    uint64_t lastSequence_;
+    bool needsFull_;                    // A delta could not be applied
+    StateDeltaDecoderStats stats_;
+};
+
+} // namespace messaging
+} // namespace hmdev
+
+#endif // HMDEV_MESSAGING_STATE_DELTA_H
@@ -0,0 +1,118 @@
+#ifndef HMDEV_MESSAGING_UDP_COALESCER_H
+#define HMDEV_MESSAGING_UDP_COALESCER_H
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include <nlohmann/json.hpp>
+#include "udp_codec.h"
+
+namespace hmdev {
+namespace messaging {
+
+using json = nlohmann::json;
+
+/**
+ * Outbound coalescing configuration
+ */
+struct UdpCoalescingConfig {
+    size_t maxDatagramSize;  // Encoded size budget of one coalesced datagram
+    int flushDeadlineMs;     // Send a batch this long after its first message (0 = only on size or flush())
+
+    UdpCoalescingConfig() : maxDatagramSize(1200), flushDeadlineMs(2) {}
+};
+
+/**
+ * Coalescing statistics snapshot
+ */
+struct UdpCoalescingStats {
+    uint64_t messages;         // Push requests sent through the coalescer
+    uint64_t datagrams;        // Datagrams they were packed into
+    uint64_t sizeFlushes;      // Batches sent because the next message did not fit
+    uint64_t deadlineFlushes;  // Batches sent when flushDeadlineMs expired
+    uint64_t explicitFlushes;  // Batches sent by flush()
+    size_t maxPerDatagram;     // Most messages packed into one datagram
+    size_t pending;            // Messages waiting in the current batch
+
+    UdpCoalescingStats()
+        : messages(0), datagrams(0), sizeFlushes(0), deadlineFlushes(0), explicitFlushes(0),
+          maxPerDatagram(0), pending(0) {}
+};
+
+/**
+ * Packs push requests into shared datagrams
+ *
+ * Requests are collected until the next one would push the encoded batch
+ * over the size budget, the flush deadline of the batch expires or flush()
+ * is called. A batch is sent as
+ *
+ *     {"action": "push-batch", "payload": {"messages": [request, ...]}}
+ *
+ * and a batch of one as a plain "push" envelope. Sizes are measured with
+ * the encoding active when a request is added.
+ *
+ * Performs no I/O and is not thread-safe; the owner sends the datagrams
+ * it returns and serializes calls.
+ */
+class UdpCoalescer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * Constructor
+     * @param config Coalescing configuration
+     */
+    explicit UdpCoalescer(const UdpCoalescingConfig& config = UdpCoalescingConfig());
+
+    /**
+     * Add a push request to the current batch
+     * @param request EventMessageRequest JSON
+     * @param encoding Wire encoding used to measure the request
+     * @param now Current time
+     * @param ready Datagrams that are complete are appended here
+     */
+    void add(json request, UdpEncoding encoding, Clock::time_point now, std::vector<json>& ready);
+
+    /**
+     * Close the current batch
+     * @param ready The batch datagram is appended here if any message is pending
+     */
+    void flush(std::vector<json>& ready);
+
+    /**
+     * Close the current batch if its deadline has expired
+     * @param now Current time
+     * @param ready The batch datagram is appended here when due
+     */
+    void poll(Clock::time_point now, std::vector<json>& ready);
+
+    /**
+     * Get the time the current batch is due
+     * @return Deadline, or Clock::time_point::max() if nothing is pending or there is no deadline
+     */
+    Clock::time_point nextDeadline() const;
+
+    /**
+     * Get statistics
+     * @return Statistics snapshot
+     */
+    UdpCoalescingStats getStats() const;
+
+private:
+    UdpCoalescingConfig config_;
+    json batch_;                  // Pending requests (array)
+    size_t batchBytes_;           // Encoded size of the pending requests
+    Clock::time_point deadline_;
+    std::string scratch_;         // Encoding buffer for measuring
+    size_t overhead_[3];          // Encoded size of an empty batch envelope, per encoding
+    UdpCoalescingStats stats_;
+
+    size_t measure(const json& value, UdpEncoding encoding);
+    void close(std::vector<json>& ready);
+};
+
+} // namespace messaging
+} // namespace hmdev
+
+#endif // HMDEV_MESSAGING_UDP_COALESCER_H
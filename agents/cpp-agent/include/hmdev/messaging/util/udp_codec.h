@@ -0,0 +1,88 @@
+#ifndef HMDEV_MESSAGING_UDP_CODEC_H
+#define HMDEV_MESSAGING_UDP_CODEC_H
+
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+namespace hmdev {
+namespace messaging {
+
+using json = nlohmann::json;
+
+/**
+ * Wire encoding of UDP datagrams
+ */
+enum class UdpEncoding {
+    JSON,     // Textual JSON with full field names (always understood)
+    MSGPACK,  // MessagePack with short field names
+    CBOR      // CBOR with short field names
+};
+
+/**
+ * Convert UdpEncoding to its negotiation name ("json", "msgpack", "cbor")
+ */
+std::string udpEncodingToString(UdpEncoding encoding);
+
+/**
+ * Convert a negotiation name to UdpEncoding
+ * @param str Encoding name
+ * @param encoding Set when the name is known
+ * @return False for unknown names
+ */
+bool stringToUdpEncoding(const std::string& str, UdpEncoding& encoding);
+
+/**
+ * UDP datagram encoder/decoder
+ *
+ * Binary encodings replace the envelope and EventMessageRequest field names
+ * with one- or two-letter keys ("action" -> "a", "sessionId" -> "s", ...)
+ * before serializing. Decoding detects the encoding from the first byte, so
+ * JSON, MessagePack and CBOR datagrams can be mixed on one socket; short
+ * keys of binary datagrams are expanded back to the full names.
+ */
+class UdpCodec {
+public:
+    /**
+     * Encode a datagram
+     * @param datagram Envelope or reply JSON
+     * @param encoding Wire encoding
+     * @param output Output buffer (cleared first; capacity is reused)
+     */
+    static void encode(const json& datagram, UdpEncoding encoding, std::string& output);
+
+    /**
+     * Decode a datagram in any supported encoding
+     * @param data Datagram bytes
+     * @param length Datagram length
+     * @return Decoded JSON with full field names, or a discarded value if invalid
+     */
+    static json decode(const char* data, size_t length);
+
+    /**
+     * Detect the encoding of a datagram from its first byte
+     * @param data Datagram bytes
+     * @param length Datagram length
+     * @return Detected encoding (JSON when not a binary map)
+     */
+    static UdpEncoding detect(const char* data, size_t length);
+
+    /**
+     * Replace known field names with their short keys (recursively)
+     * @param value JSON value
+     * @return Copy with short keys
+     */
+    static json shortenKeys(const json& value);
+
+    /**
+     * Replace known short keys with their full field names (recursively)
+     * @param value JSON value
+     * @return Copy with full field names
+     */
+    static json expandKeys(const json& value);
+};
+
+} // namespace messaging
+} // namespace hmdev
+
+#endif // HMDEV_MESSAGING_UDP_CODEC_H
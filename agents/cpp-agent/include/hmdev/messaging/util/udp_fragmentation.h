@@ -0,0 +1,139 @@
+#ifndef HMDEV_MESSAGING_UDP_FRAGMENTATION_H
+#define HMDEV_MESSAGING_UDP_FRAGMENTATION_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <chrono>
+#include <cstdint>
+
+namespace hmdev {
+namespace messaging {
+
+/**
+ * Application-level UDP fragmentation
+ *
+ * A datagram larger than the size budget is split into fragments that each
+ * start with a 10-byte header:
+ *
+ *     0xF7 | version (1) | message ID (4) | index (2) | count (2)
+ *
+ * (big-endian). 0xF7 never starts a JSON, MessagePack map or CBOR map
+ * datagram, so fragments and whole datagrams can share a socket.
+ */
+class UdpFragmentation {
+public:
+    static constexpr size_t HEADER_SIZE = 10;
+    static constexpr size_t MAX_FRAGMENTS = 65535;
+
+    /**
+     * Split a datagram into fragments
+     * @param datagram Encoded datagram
+     * @param maxDatagramSize Size budget per fragment including the header
+     * @param messageId ID shared by all fragments of this datagram
+     * @param fragments Fragments are appended here
+     * @return Number of fragments, or 0 if the datagram needs more than MAX_FRAGMENTS
+     */
+    static size_t split(const std::string& datagram, size_t maxDatagramSize, uint32_t messageId,
+                        std::vector<std::string>& fragments);
+
+    /**
+     * Check whether a datagram is a fragment
+     * @param data Datagram bytes
+     * @param length Datagram length
+     * @return True if it starts with a fragment header
+     */
+    static bool isFragment(const char* data, size_t length);
+};
+
+/**
+ * Reassembly limits
+ */
+struct UdpReassemblyConfig {
+    int timeoutMs;          // Partial messages older than this are dropped
+    size_t maxBytes;        // Bytes buffered across all partial messages; oldest evicted first
+    size_t maxMessageSize;  // Larger messages are rejected at their first fragment
+
+    UdpReassemblyConfig() : timeoutMs(2000), maxBytes(4 * 1024 * 1024), maxMessageSize(1024 * 1024) {}
+};
+
+/**
+ * Reassembly statistics snapshot
+ */
+struct UdpReassemblyStats {
+    uint64_t fragments;   // Fragments received
+    uint64_t messages;    // Messages completed
+    uint64_t timeouts;    // Partial messages dropped after timeoutMs
+    uint64_t evictions;   // Partial messages dropped to stay under maxBytes
+    uint64_t rejected;    // Malformed, duplicate-conflicting or oversized fragments
+    size_t bufferedBytes; // Bytes currently held by partial messages, including per-fragment slots
+
+    UdpReassemblyStats()
+        : fragments(0), messages(0), timeouts(0), evictions(0), rejected(0), bufferedBytes(0) {}
+};
+
+/**
+ * Reassembly buffer for fragmented datagrams
+ *
+ * Every fragment but the last carries exactly the sender's chunk size, so
+ * the first full-size fragment bounds the fragment count by maxMessageSize.
+ * Each partial message is charged for its fragment slots as well as its
+ * payload, so forged headers claiming many fragments are evicted under
+ * maxBytes like any other partial message.
+ *
+ * Not thread-safe; the owner serializes calls.
+ */
+class UdpReassembler {
+public:
+    /**
+     * Constructor
+     * @param config Reassembly limits
+     */
+    explicit UdpReassembler(const UdpReassemblyConfig& config = UdpReassemblyConfig());
+
+    /**
+     * Add a fragment
+     * @param data Fragment bytes including the header
+     * @param length Fragment length
+     * @param message Set to the reassembled datagram when this fragment completes it
+     * @return True if a datagram was completed
+     */
+    bool add(const char* data, size_t length, std::string& message);
+
+    /**
+     * Drop partial messages older than the timeout
+     */
+    void expire();
+
+    /**
+     * Get reassembly statistics
+     * @return Statistics snapshot
+     */
+    UdpReassemblyStats getStats() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct PartialMessage {
+        Clock::time_point firstSeen;
+        std::vector<std::string> parts;
+        std::vector<bool> have;
+        size_t received;
+        size_t chunk;          // Payload size of non-final fragments, 0 until one arrives
+        size_t payloadBytes;   // Payload received so far
+        size_t bytes;          // Charged to bufferedBytes: payload plus slot overhead
+    };
+
+    UdpReassemblyConfig config_;
+    std::map<uint32_t, PartialMessage> partial_;
+    UdpReassemblyStats stats_;
+
+    void expire(Clock::time_point now);
+    void evictOldest();
+    void drop(std::map<uint32_t, PartialMessage>::iterator it);
+};
+
+} // namespace messaging
+} // namespace hmdev
+
+#endif // HMDEV_MESSAGING_UDP_FRAGMENTATION_H
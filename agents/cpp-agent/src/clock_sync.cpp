@@ -0,0 +1,171 @@
+#include "hmdev/messaging/util/clock_sync.h"
+#include <algorithm>
+
+namespace hmdev {
+namespace messaging {
+
+static constexpr size_t MAX_OUTSTANDING = 16;
+
+ClockSync::ClockSync(const ClockSyncConfig& config)
+    : config_(config), running_(false), drift_(0.0), lastServerUs_(0) {
+    config_.filterWindow = std::max<size_t>(1, config_.filterWindow);
+    config_.driftWindow = std::max<size_t>(2, config_.driftWindow);
+
+    // Until a sample arrives the local wall clock is the best guess
+    int64_t wallUs = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    best_.localUs = toLocalUs(Clock::now());
+    best_.offsetUs = wallUs - best_.localUs;
+    best_.rttUs = 0;
+}
+
+void ClockSync::start(Clock::time_point now) {
+    running_ = true;
+    nextPing_ = now;
+}
+
+void ClockSync::stop() {
+    running_ = false;
+    outstanding_.clear();
+}
+
+void ClockSync::poll(Clock::time_point now, std::vector<json>& ready) {
+    if (!running_ || now < nextPing_) {
+        return;
+    }
+
+    int64_t t0 = toLocalUs(now);
+    ready.push_back(json{{"action", "time"}, {"payload", {{"t0", t0}}}});
+    outstanding_.push_back(t0);
+    if (outstanding_.size() > MAX_OUTSTANDING) {
+        outstanding_.pop_front();  // Lost; a late reply is rejected
+    }
+
+    stats_.pings++;
+    bool converging = stats_.pings < static_cast<uint64_t>(std::max(0, config_.fastSamples));
+    nextPing_ = now + std::chrono::milliseconds(converging ? config_.fastIntervalMs : config_.intervalMs);
+}
+
+ClockSync::Clock::time_point ClockSync::nextDeadline() const {
+    return running_ ? nextPing_ : Clock::time_point::max();
+}
+
+bool ClockSync::isTimeReply(const json& datagram) {
+    return datagram.is_object() && datagram.contains("action") && datagram["action"] == "time" &&
+           datagram.contains("t1");
+}
+
+bool ClockSync::receive(const json& reply, Clock::time_point now) {
+    if (!isTimeReply(reply)) {
+        stats_.rejected++;
+        return false;
+    }
+    const json& t0Value = reply.contains("t0") ? reply["t0"] : json();
+    const json& t2Value = reply.contains("t2") ? reply["t2"] : reply["t1"];
+    if (!t0Value.is_number_integer() || !reply["t1"].is_number_integer() || !t2Value.is_number_integer()) {
+        stats_.rejected++;
+        return false;
+    }
+
+    // Only replies to our own pings, each once
+    int64_t t0 = t0Value.get<int64_t>();
+    auto it = std::find(outstanding_.begin(), outstanding_.end(), t0);
+    if (it == outstanding_.end()) {
+        stats_.rejected++;
+        return false;
+    }
+    outstanding_.erase(it);
+
+    int64_t t1 = reply["t1"].get<int64_t>();
+    int64_t t2 = t2Value.get<int64_t>();
+    int64_t t3 = toLocalUs(now);
+    int64_t rtt = (t3 - t0) - (t2 - t1);
+    if (t2 < t1 || rtt < 0 || rtt > static_cast<int64_t>(config_.maxRttMs) * 1000) {
+        stats_.rejected++;
+        return false;
+    }
+
+    Sample sample;
+    sample.localUs = t0 + (t3 - t0) / 2;
+    sample.offsetUs = ((t1 - t0) + (t2 - t3)) / 2;
+    sample.rttUs = rtt;
+    samples_.push_back(sample);
+    if (samples_.size() > config_.filterWindow) {
+        samples_.pop_front();
+    }
+    stats_.samples++;
+    stats_.lastRttUs = rtt;
+    stats_.lastOffsetUs = sample.offsetUs;
+
+    // Minimum-RTT filter: the fastest exchange had the least queueing to skew it
+    const Sample& pick = *std::min_element(samples_.begin(), samples_.end(),
+                                           [](const Sample& a, const Sample& b) { return a.rttUs < b.rttUs; });
+    if (filtered_.empty() || filtered_.back().localUs != pick.localUs) {
+        filtered_.push_back(pick);
+        if (filtered_.size() > config_.driftWindow) {
+            filtered_.pop_front();
+        }
+        fitDrift();
+    }
+    best_ = pick;
+    stats_.rttUs = pick.rttUs;
+    stats_.synchronized = true;
+    return true;
+}
+
+int64_t ClockSync::serverTimeUs(Clock::time_point now) {
+    int64_t localUs = toLocalUs(now);
+    int64_t serverUs = localUs + offsetAt(localUs);
+
+    // A new sample may move the estimate back; hold until it catches up instead
+    lastServerUs_ = std::max(lastServerUs_, serverUs);
+    return lastServerUs_;
+}
+
+ClockSyncStats ClockSync::getStats(Clock::time_point now) const {
+    ClockSyncStats stats = stats_;
+    stats.offsetUs = offsetAt(toLocalUs(now));
+    stats.driftPpm = drift_ * 1e6;
+    return stats;
+}
+
+int64_t ClockSync::toLocalUs(Clock::time_point time) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(time.time_since_epoch()).count();
+}
+
+int64_t ClockSync::offsetAt(int64_t localUs) const {
+    return best_.offsetUs + static_cast<int64_t>(drift_ * static_cast<double>(localUs - best_.localUs));
+}
+
+void ClockSync::fitDrift() {
+    // Needs a few points over a span long enough for the slope to beat the offset noise
+    if (filtered_.size() < 3 ||
+        filtered_.back().localUs - filtered_.front().localUs < static_cast<int64_t>(config_.intervalMs) * 1000) {
+        return;
+    }
+
+    double meanX = 0.0;
+    double meanY = 0.0;
+    for (const Sample& sample : filtered_) {
+        meanX += static_cast<double>(sample.localUs - filtered_.front().localUs);
+        meanY += static_cast<double>(sample.offsetUs - filtered_.front().offsetUs);
+    }
+    meanX /= filtered_.size();
+    meanY /= filtered_.size();
+
+    double covariance = 0.0;
+    double variance = 0.0;
+    for (const Sample& sample : filtered_) {
+        double x = static_cast<double>(sample.localUs - filtered_.front().localUs) - meanX;
+        double y = static_cast<double>(sample.offsetUs - filtered_.front().offsetUs) - meanY;
+        covariance += x * y;
+        variance += x * x;
+    }
+    if (variance > 0.0) {
+        double limit = config_.maxDriftPpm / 1e6;
+        drift_ = std::max(-limit, std::min(limit, covariance / variance));
+    }
+}
+
+} // namespace messaging
+} // namespace hmdev
@@ -0,0 +1,35 @@
+#include "hmdev/messaging/util/compression.h"
+#include <zlib.h>
+#include <cstring>
+
+namespace hmdev {
+namespace messaging {
+
+// windowBits offset selecting the gzip wrapper
+static constexpr int GZIP_WINDOW_BITS = 15 + 16;
+
+bool Compression::gzip(const std::string& input, std::string& output, int level) {
+    output.clear();
+
+    z_stream stream;
+    std::memset(&stream, 0, sizeof(stream));
+    if (deflateInit2(&stream, level, Z_DEFLATED, GZIP_WINDOW_BITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        return false;
+    }
+
+    output.resize(deflateBound(&stream, static_cast<uLong>(input.size())));
+
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
+    stream.avail_in = static_cast<uInt>(input.size());
+    stream.next_out = reinterpret_cast<Bytef*>(&output[0]);
+    stream.avail_out = static_cast<uInt>(output.size());
+
+    int result = deflate(&stream, Z_FINISH);
+    output.resize(stream.total_out);
+    deflateEnd(&stream);
+
+    return result == Z_STREAM_END;
+}
+
+} // namespace messaging
+} // namespace hmdev
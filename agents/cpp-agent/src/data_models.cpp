@@ -224,19 +224,41 @@ json MessageReceiveRequest::toJson() const {
 
 // UdpEnvelope
 json UdpEnvelope::toJson() const {
-    return json{
+    json j = {
         {"action", action},
         {"payload", payload}
     };
+    if (!requestId.empty()) {
+        j["requestId"] = requestId;
+    }
+    return j;
 }
 
 UdpEnvelope UdpEnvelope::fromJson(const json& j) {
+    // Fields of an unexpected type are left empty rather than thrown on
     UdpEnvelope envelope;
-    if (j.contains("action")) envelope.action = j["action"].get<std::string>();
+    if (!j.is_object()) return envelope;
+    if (j.contains("action") && j["action"].is_string()) envelope.action = j["action"].get<std::string>();
     if (j.contains("payload")) envelope.payload = j["payload"];
+    readRequestId(j, envelope.requestId);
     return envelope;
 }
 
+bool UdpEnvelope::readRequestId(const json& j, std::string& requestId) {
+    if (!j.is_object() || !j.contains("requestId")) {
+        return false;
+    }
+    const json& id = j["requestId"];
+    if (id.is_string()) {
+        requestId = id.get<std::string>();
+    } else if (id.is_number_unsigned() || (id.is_number_integer() && id.get<int64_t>() >= 0)) {
+        requestId = std::to_string(id.get<uint64_t>());
+    } else {
+        return false;
+    }
+    return !requestId.empty();
+}
+
 } // namespace messaging
 } // namespace hmdev
 
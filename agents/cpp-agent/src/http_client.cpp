@@ -1,7 +1,16 @@
 #include "hmdev/messaging/api/http_client.h"
+#include "hmdev/messaging/util/utils.h"
+#include "hmdev/messaging/util/compression.h"
 #include <curl/curl.h>
 #include <sstream>
+#include <ostream>
+#include <streambuf>
 #include <stdexcept>
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
 
 namespace hmdev {
 namespace messaging {
@@ -14,6 +23,32 @@ static size_t WriteCallback(void* contents, size_t size, size_t nmemb, void* use
     return totalSize;
 }
 
+// Stream buffer that appends to a caller-owned string, so json can be serialized in place
+class StringAppendBuffer : public std::streambuf {
+public:
+    explicit StringAppendBuffer(std::string& target) : target_(target) {}
+
+protected:
+    int_type overflow(int_type ch) override {
+        if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+            target_.push_back(traits_type::to_char_type(ch));
+        }
+        return traits_type::not_eof(ch);
+    }
+
+    std::streamsize xsputn(const char* data, std::streamsize count) override {
+        target_.append(data, static_cast<size_t>(count));
+        return count;
+    }
+
+private:
+    std::string& target_;
+};
+
+static void freeHeaderList(void* headers) {
+    curl_slist_free_all(static_cast<struct curl_slist*>(headers));
+}
+
 json HttpClientResult::dataAsJson() const {
     if (data.empty()) {
         return json::object();
@@ -25,71 +60,213 @@ json HttpClientResult::dataAsJson() const {
     }
 }
 
-HttpClient::HttpClient(const std::string& baseUrl)
-    : baseUrl_(baseUrl), curlHandle_(nullptr) {
-    // Initialize CURL
-    curl_global_init(CURL_GLOBAL_DEFAULT);
-    curlHandle_ = curl_easy_init();
+HttpClient::HttpClient(const std::string& baseUrl, const HttpClientConfig& config)
+    : baseUrl_(baseUrl), httpVersion_(config.httpVersion),
+      transportContext_(config.transportContext),
+      compressResponses_(config.compressResponses),
+      compressRequestsAbove_(config.compressRequestsAbove) {
+    // Initialize CURL (once per process)
+    HttpTransportContext::initializeCurl();
 
-    if (!curlHandle_) {
-        throw std::runtime_error("Failed to initialize CURL");
+    if (httpVersion_ != HttpVersion::HTTP_1_1 &&
+        !(curl_version_info(CURLVERSION_NOW)->features & CURL_VERSION_HTTP2)) {
+        std::cerr << "libcurl built without HTTP/2 support, using HTTP/1.1" << std::endl;
+        httpVersion_ = HttpVersion::HTTP_1_1;
     }
+
+    int port;
+    if (!Utils::parseUrl(baseUrl_, host_, port)) {
+        host_ = baseUrl_;
+    }
+
+    pool_ = std::make_unique<HttpConnectionPool>(config.maxConnectionsPerHost);
+
+    rebuildHeaderList();
 }
 
 HttpClient::~HttpClient() {
-    closeAll();
-    curl_global_cleanup();
+    // Async transfers and pooled handles must be released before the share handle
+    eventLoop_.reset();
+    pool_.reset();
 }
 
 void HttpClient::setDefaultHeader(const std::string& key, const std::string& value) {
+    std::lock_guard<std::mutex> lock(headersMutex_);
     defaultHeaders_[key] = value;
+    rebuildHeaderList();
 }
 
 void HttpClient::removeDefaultHeader(const std::string& key) {
-    defaultHeaders_.erase(key);
+    std::lock_guard<std::mutex> lock(headersMutex_);
+    if (defaultHeaders_.erase(key) > 0) {
+        rebuildHeaderList();
+    }
+}
+
+void HttpClient::rebuildHeaderList() {
+    struct curl_slist* headers = nullptr;
+    headers = curl_slist_append(headers, "Content-Type: application/json");
+
+    for (const auto& header : defaultHeaders_) {
+        std::string headerStr = header.first + ": " + header.second;
+        headers = curl_slist_append(headers, headerStr.c_str());
+    }
+
+    // In-flight requests keep their own reference to the previous list
+    headerList_ = std::shared_ptr<void>(headers, freeHeaderList);
+
+    struct curl_slist* gzipHeaders = nullptr;
+    for (struct curl_slist* item = headers; item; item = item->next) {
+        gzipHeaders = curl_slist_append(gzipHeaders, item->data);
+    }
+    gzipHeaders = curl_slist_append(gzipHeaders, "Content-Encoding: gzip");
+    gzipHeaderList_ = std::shared_ptr<void>(gzipHeaders, freeHeaderList);
 }
 
 HttpClientResult HttpClient::request(HttpMethod method,
                                      const std::string& path,
                                      const json& body,
                                      int timeoutMs) {
+    // HTTP/2 streams share the event loop's multiplexed connection
+    if (httpVersion_ != HttpVersion::HTTP_1_1) {
+        return requestAsync(method, path, body, timeoutMs).get();
+    }
+
     HttpClientResult result;
 
-    if (!curlHandle_) {
+    // Lease a keep-alive handle; waiting for a free one counts against the timeout
+    auto leaseStart = std::chrono::steady_clock::now();
+    HttpConnectionPool::Lease lease = pool_->acquire(host_, timeoutMs);
+    if (!lease) {
         return result;
     }
+    long waitedMs = static_cast<long>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - leaseStart).count());
+    long remainingMs = std::max(1L, static_cast<long>(timeoutMs) - waitedMs);
+
+    HttpConnection& connection = *lease.connection();
+    configureRequest(connection, method, path, body, remainingMs);
+
+    // Perform request
+    CURLcode res = curl_easy_perform(static_cast<CURL*>(connection.handle));
+
+    return completeRequest(connection, res);
+}
+
+void HttpClient::requestAsync(HttpMethod method,
+                              const std::string& path,
+                              const json& body,
+                              int timeoutMs,
+                              HttpCallback callback) {
+    // Event loop handles are recycled per transfer, so buffers live with the request
+    auto connection = std::make_shared<HttpConnection>();
+
+    bool submitted = eventLoop().submit(
+        [&](void* curl) {
+            connection->handle = curl;
+            configureRequest(*connection, method, path, body, timeoutMs);
+        },
+        [this, connection, callback](void*, int curlCode) {
+            HttpClientResult result = completeRequest(*connection, curlCode);
+            if (callback) {
+                callback(result);
+            }
+        });
+
+    if (!submitted && callback) {
+        callback(HttpClientResult());
+    }
+}
+
+std::future<HttpClientResult> HttpClient::requestAsync(HttpMethod method,
+                                                       const std::string& path,
+                                                       const json& body,
+                                                       int timeoutMs) {
+    auto promise = std::make_shared<std::promise<HttpClientResult>>();
+    std::future<HttpClientResult> future = promise->get_future();
+
+    requestAsync(method, path, body, timeoutMs,
+                 [promise](const HttpClientResult& result) {
+                     promise->set_value(result);
+                 });
+
+    return future;
+}
 
-    CURL* curl = static_cast<CURL*>(curlHandle_);
-    std::string url = buildUrl(path);
-    std::string responseData;
+std::future<HttpClientResult> HttpClient::postAsync(const std::string& path,
+                                                    const json& body,
+                                                    int timeoutMs) {
+    return requestAsync(HttpMethod::POST, path, body, timeoutMs);
+}
+
+void HttpClient::postAsync(const std::string& path,
+                           const json& body,
+                           int timeoutMs,
+                           HttpCallback callback) {
+    requestAsync(HttpMethod::POST, path, body, timeoutMs, std::move(callback));
+}
+
+void HttpClient::configureRequest(HttpConnection& connection,
+                                  HttpMethod method,
+                                  const std::string& path,
+                                  const json& body,
+                                  long timeoutMs) const {
+    CURL* curl = static_cast<CURL*>(connection.handle);
+    buildUrl(path, connection.url);
 
     // Set URL
-    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+    curl_easy_setopt(curl, CURLOPT_URL, connection.url.c_str());
 
-    // Set timeout
+    // Set timeout; no signals so timeouts are safe with concurrent requests
     curl_easy_setopt(curl, CURLOPT_TIMEOUT_MS, timeoutMs);
+    curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
 
-    // Set write callback
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &responseData);
-
-    // Build headers
-    struct curl_slist* headers = nullptr;
-    headers = curl_slist_append(headers, "Content-Type: application/json");
+    // Reuse DNS results, TLS sessions and connections of other clients in the context
+    if (transportContext_) {
+        curl_easy_setopt(curl, CURLOPT_SHARE, static_cast<CURLSH*>(transportContext_->shareHandle()));
+    }
 
-    for (const auto& header : defaultHeaders_) {
-        std::string headerStr = header.first + ": " + header.second;
-        headers = curl_slist_append(headers, headerStr.c_str());
+    // Select protocol; PIPEWAIT waits for a multiplexable connection instead of opening a new one
+    if (httpVersion_ == HttpVersion::HTTP_2) {
+        curl_easy_setopt(curl, CURLOPT_HTTP_VERSION, static_cast<long>(CURL_HTTP_VERSION_2TLS));
+        curl_easy_setopt(curl, CURLOPT_PIPEWAIT, 1L);
+    } else if (httpVersion_ == HttpVersion::HTTP_2_PRIOR_KNOWLEDGE) {
+        curl_easy_setopt(curl, CURLOPT_HTTP_VERSION, static_cast<long>(CURL_HTTP_VERSION_2_PRIOR_KNOWLEDGE));
+        curl_easy_setopt(curl, CURLOPT_PIPEWAIT, 1L);
+    } else {
+        curl_easy_setopt(curl, CURLOPT_HTTP_VERSION, static_cast<long>(CURL_HTTP_VERSION_1_1));
     }
 
-    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
+    // Set write callback; the buffer was reserved from the size hint when the last response was moved out
+    connection.responseBody.clear();
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &connection.responseBody);
+
+    // Let libcurl advertise and decode every content encoding it was built with
+    if (compressResponses_) {
+        curl_easy_setopt(curl, CURLOPT_ACCEPT_ENCODING, "");
+    }
 
     // Set method and body
-    std::string bodyStr;
+    connection.path.assign(path);
+    connection.requestBody.clear();
+    connection.bodyCompressed = false;
+
     if (method == HttpMethod::POST || method == HttpMethod::PUT) {
         if (!body.is_null()) {
-            bodyStr = body.dump();
-            curl_easy_setopt(curl, CURLOPT_POSTFIELDS, bodyStr.c_str());
+            serializeBody(connection, body);
+
+            // Large bodies are gzipped; fall back to plain if compression does not pay off
+            const std::string* payload = &connection.requestBody;
+            if (compressRequestsAbove_ > 0 && connection.requestBody.size() > compressRequestsAbove_ &&
+                Compression::gzip(connection.requestBody, connection.compressedBody, 1) &&
+                connection.compressedBody.size() < connection.requestBody.size()) {
+                connection.bodyCompressed = true;
+                payload = &connection.compressedBody;
+            }
+
+            curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, static_cast<long>(payload->size()));
+            curl_easy_setopt(curl, CURLOPT_POSTFIELDS, payload->data());
         }
 
         if (method == HttpMethod::POST) {
@@ -104,17 +281,125 @@ HttpClientResult HttpClient::request(HttpMethod method,
         curl_easy_setopt(curl, CURLOPT_HTTPGET, 1L);
     }
 
-    // Perform request
-    CURLcode res = curl_easy_perform(curl);
+    // Use the prebuilt header list; the snapshot keeps it alive for this transfer
+    {
+        std::lock_guard<std::mutex> lock(headersMutex_);
+        connection.headers = connection.bodyCompressed ? gzipHeaderList_ : headerList_;
+    }
+    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, static_cast<struct curl_slist*>(connection.headers.get()));
+}
+
+int HttpClient::prewarm(int connections, int timeoutMs) {
+    if (connections <= 0) {
+        return 0;
+    }
+
+    // HTTP/2 needs one connection; the event loop's multi handle keeps it open
+    if (httpVersion_ != HttpVersion::HTTP_1_1) {
+        auto connection = std::make_shared<HttpConnection>();
+        auto promise = std::make_shared<std::promise<bool>>();
+        std::future<bool> done = promise->get_future();
+
+        bool submitted = eventLoop().submit(
+            [&](void* curl) {
+                connection->handle = curl;
+                configurePrewarm(*connection, timeoutMs);
+            },
+            [connection, promise](void*, int curlCode) {
+                promise->set_value(curlCode == CURLE_OK);
+            });
+
+        return submitted && done.get() ? 1 : 0;
+    }
+
+    // Hold all leases at once so each warms a distinct handle
+    connections = std::min(connections, pool_->getMaxConnectionsPerHost());
+    std::vector<HttpConnectionPool::Lease> leases;
+    for (int i = 0; i < connections; i++) {
+        HttpConnectionPool::Lease lease = pool_->acquire(host_, timeoutMs);
+        if (!lease) {
+            break;
+        }
+        leases.push_back(std::move(lease));
+    }
+
+    // Connect in parallel; handles return to the pool with their connection open
+    std::vector<char> established(leases.size(), 0);
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < leases.size(); i++) {
+        workers.emplace_back([this, &leases, &established, i, timeoutMs]() {
+            HttpConnection& connection = *leases[i].connection();
+            configurePrewarm(connection, timeoutMs);
+            established[i] = curl_easy_perform(static_cast<CURL*>(connection.handle)) == CURLE_OK;
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    return static_cast<int>(std::count(established.begin(), established.end(), 1));
+}
+
+void HttpClient::configurePrewarm(HttpConnection& connection, long timeoutMs) const {
+    // Same connection-level options as a real request, so the connection is reusable
+    configureRequest(connection, HttpMethod::GET, "", nullptr, timeoutMs);
+    curl_easy_setopt(static_cast<CURL*>(connection.handle), CURLOPT_NOBODY, 1L);
+}
+
+void HttpClient::serializeBody(HttpConnection& connection, const json& body) {
+    // Same output as body.dump(), appended to the connection's retained buffer
+    connection.requestBody.clear();
+    StringAppendBuffer buffer(connection.requestBody);
+    std::ostream out(&buffer);
+    out << body;
+}
+
+HttpClientResult HttpClient::completeRequest(HttpConnection& connection, int curlCode) {
+    HttpClientResult result;
+    CURL* curl = static_cast<CURL*>(connection.handle);
 
-    // Clean up headers
-    curl_slist_free_all(headers);
+    // Phase timings are valid for failed transfers too, up to the failing phase
+    curl_off_t timing = 0;
+    if (curl_easy_getinfo(curl, CURLINFO_NAMELOOKUP_TIME_T, &timing) == CURLE_OK) result.timings.namelookupUs = timing;
+    if (curl_easy_getinfo(curl, CURLINFO_CONNECT_TIME_T, &timing) == CURLE_OK) result.timings.connectUs = timing;
+    if (curl_easy_getinfo(curl, CURLINFO_APPCONNECT_TIME_T, &timing) == CURLE_OK) result.timings.appconnectUs = timing;
+    if (curl_easy_getinfo(curl, CURLINFO_STARTTRANSFER_TIME_T, &timing) == CURLE_OK) result.timings.starttransferUs = timing;
+    if (curl_easy_getinfo(curl, CURLINFO_TOTAL_TIME_T, &timing) == CURLE_OK) result.timings.totalUs = timing;
 
-    if (res == CURLE_OK) {
+    if (curlCode == CURLE_OK) {
         long statusCode;
         curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &statusCode);
+
+        // Body bytes as received on the wire, before content decoding
+        curl_off_t wireBytes = 0;
+        curl_easy_getinfo(curl, CURLINFO_SIZE_DOWNLOAD_T, &wireBytes);
+
+        {
+            std::lock_guard<std::mutex> lock(statsMutex_);
+            auto it = transferStats_.find(connection.path);
+            if (it == transferStats_.end()) {
+                it = transferStats_.emplace(connection.path, HttpTransferStats()).first;
+            }
+            HttpTransferStats& stats = it->second;
+            stats.requests++;
+            stats.requestBytes += connection.requestBody.size();
+            if (connection.bodyCompressed) {
+                stats.compressedRequests++;
+                stats.requestWireBytes += connection.compressedBody.size();
+            } else {
+                stats.requestWireBytes += connection.requestBody.size();
+            }
+            stats.responseBytes += connection.responseBody.size();
+            stats.responseWireBytes += static_cast<uint64_t>(wireBytes);
+        }
+
         result.statusCode = static_cast<int>(statusCode);
-        result.data = responseData;
+        // Hand the body over without copying and reserve the pooled buffer for the next one
+        connection.responseSizeHint = std::max(connection.responseSizeHint,
+                                               connection.responseBody.size());
+        result.data = std::move(connection.responseBody);
+        connection.responseBody.clear();
+        connection.responseBody.reserve(connection.responseSizeHint);
         result.success = true;
     } else {
         result.statusCode = 0;
@@ -135,17 +420,32 @@ HttpClientResult HttpClient::post(const std::string& path,
 }
 
 void HttpClient::closeAll() {
-    if (curlHandle_) {
-        curl_easy_cleanup(static_cast<CURL*>(curlHandle_));
-        curlHandle_ = nullptr;
-    }
+    pool_->clear();
+}
+
+HttpEventLoop& HttpClient::eventLoop() {
+    // Started lazily so purely synchronous clients never spawn the loop thread
+    std::call_once(eventLoopOnce_, [this]() {
+        eventLoop_ = std::make_unique<HttpEventLoop>(httpVersion_ != HttpVersion::HTTP_1_1);
+    });
+    return *eventLoop_;
+}
+
+HttpPoolStats HttpClient::getPoolStats() const {
+    return pool_->getStats();
+}
+
+std::map<std::string, HttpTransferStats> HttpClient::getTransferStats() const {
+    std::lock_guard<std::mutex> lock(statsMutex_);
+    return transferStats_;
 }
 
-std::string HttpClient::buildUrl(const std::string& path) const {
+void HttpClient::buildUrl(const std::string& path, std::string& url) const {
+    url.assign(baseUrl_);
     if (path.empty() || path[0] != '/') {
-        return baseUrl_ + "/" + path;
+        url.push_back('/');
     }
-    return baseUrl_ + path;
+    url.append(path);
 }
 
 } // namespace messaging
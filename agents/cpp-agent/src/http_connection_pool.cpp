@@ -0,0 +1,150 @@
+#include "hmdev/messaging/api/http_connection_pool.h"
+#include <curl/curl.h>
+#include <chrono>
+
+namespace hmdev {
+namespace messaging {
+
+// Lease
+
+HttpConnectionPool::Lease::Lease(Lease&& other) noexcept
+    : pool_(other.pool_), bucket_(other.bucket_),
+      connection_(other.connection_), generation_(other.generation_) {
+    other.pool_ = nullptr;
+    other.connection_ = nullptr;
+}
+
+HttpConnectionPool::Lease& HttpConnectionPool::Lease::operator=(Lease&& other) noexcept {
+    if (this != &other) {
+        release();
+        pool_ = other.pool_;
+        bucket_ = other.bucket_;
+        connection_ = other.connection_;
+        generation_ = other.generation_;
+        other.pool_ = nullptr;
+        other.connection_ = nullptr;
+    }
+    return *this;
+}
+
+void HttpConnectionPool::Lease::release() {
+    if (pool_ && connection_) {
+        pool_->release(bucket_, connection_, generation_);
+    }
+    pool_ = nullptr;
+    connection_ = nullptr;
+}
+
+// HttpConnectionPool
+
+HttpConnectionPool::HttpConnectionPool(int maxConnectionsPerHost)
+    : maxConnectionsPerHost_(maxConnectionsPerHost > 0 ? maxConnectionsPerHost : 1),
+      generation_(0) {
+}
+
+HttpConnectionPool::~HttpConnectionPool() {
+    clear();
+}
+
+HttpConnectionPool::Lease HttpConnectionPool::acquire(const std::string& host, int timeoutMs) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    HostBucket& bucket = buckets_[host];
+
+    auto hasCapacity = [&]() {
+        return !bucket.idle.empty() ||
+               bucket.active + bucket.idle.size() < static_cast<size_t>(maxConnectionsPerHost_);
+    };
+
+    if (!hasCapacity()) {
+        stats_.waits++;
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+        if (!available_.wait_until(lock, deadline, hasCapacity)) {
+            stats_.timeouts++;
+            return Lease();
+        }
+    }
+
+    bucket.active++;
+    uint64_t generation = generation_;
+
+    if (!bucket.idle.empty()) {
+        HttpConnection* connection = bucket.idle.back();
+        bucket.idle.pop_back();
+        stats_.hits++;
+        return Lease(this, &bucket, connection, generation);
+    }
+
+    stats_.misses++;
+    lock.unlock();
+
+    // Create handle outside the lock; the slot is already reserved
+    CURL* curl = curl_easy_init();
+    if (!curl) {
+        lock.lock();
+        bucket.active--;
+        available_.notify_one();
+        return Lease();
+    }
+
+    HttpConnection* connection = new HttpConnection();
+    connection->handle = curl;
+    return Lease(this, &bucket, connection, generation);
+}
+
+void HttpConnectionPool::release(HostBucket* bucket, HttpConnection* connection, uint64_t generation) {
+    // Drop per-request options but keep the live connection and caches
+    curl_easy_reset(static_cast<CURL*>(connection->handle));
+    connection->headers.reset();
+
+    bool stale = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        bucket->active--;
+        stale = generation != generation_;
+        if (!stale) {
+            bucket->idle.push_back(connection);
+        }
+    }
+    available_.notify_one();
+
+    if (stale) {
+        destroy(connection);
+    }
+}
+
+void HttpConnectionPool::destroy(HttpConnection* connection) {
+    curl_easy_cleanup(static_cast<CURL*>(connection->handle));
+    delete connection;
+}
+
+void HttpConnectionPool::clear() {
+    std::vector<HttpConnection*> toClose;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        generation_++;
+        for (auto& entry : buckets_) {
+            toClose.insert(toClose.end(), entry.second.idle.begin(), entry.second.idle.end());
+            entry.second.idle.clear();
+        }
+    }
+    available_.notify_all();
+
+    for (HttpConnection* connection : toClose) {
+        destroy(connection);
+    }
+}
+
+HttpPoolStats HttpConnectionPool::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    HttpPoolStats stats = stats_;
+    stats.active = 0;
+    stats.idle = 0;
+    for (const auto& entry : buckets_) {
+        stats.active += entry.second.active;
+        stats.idle += entry.second.idle.size();
+    }
+    return stats;
+}
+
+} // namespace messaging
+} // namespace hmdev
@@ -0,0 +1,177 @@
+#include "hmdev/messaging/api/http_event_loop.h"
+#include <curl/curl.h>
+#include <stdexcept>
+#include <iostream>
+
+namespace hmdev {
+namespace messaging {
+
+// Upper bound on a single curl_multi_poll wait; wakeups cut it short
+static constexpr int POLL_TIMEOUT_MS = 1000;
+
+HttpEventLoop::HttpEventLoop(bool multiplex, size_t maxIdleHandles)
+    : multiHandle_(nullptr), maxIdleHandles_(maxIdleHandles),
+      running_(true), outstanding_(0) {
+    multiHandle_ = curl_multi_init();
+    if (!multiHandle_) {
+        throw std::runtime_error("Failed to initialize CURL multi handle");
+    }
+
+    curl_multi_setopt(static_cast<CURLM*>(multiHandle_), CURLMOPT_PIPELINING,
+                      multiplex ? CURLPIPE_MULTIPLEX : CURLPIPE_NOTHING);
+
+    thread_ = std::thread(&HttpEventLoop::run, this);
+}
+
+HttpEventLoop::~HttpEventLoop() {
+    stop();
+
+    for (void* handle : idleHandles_) {
+        curl_easy_cleanup(static_cast<CURL*>(handle));
+    }
+    idleHandles_.clear();
+
+    curl_multi_cleanup(static_cast<CURLM*>(multiHandle_));
+}
+
+bool HttpEventLoop::submit(const Setup& setup, Completion completion) {
+    if (!running_) {
+        return false;
+    }
+
+    void* handle = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!idleHandles_.empty()) {
+            handle = idleHandles_.back();
+            idleHandles_.pop_back();
+        }
+    }
+
+    if (!handle) {
+        handle = curl_easy_init();
+        if (!handle) {
+            return false;
+        }
+    }
+
+    setup(handle);
+
+    {
+        // Checked under the lock so a transfer never slips in after the final drain
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_) {
+            curl_easy_reset(static_cast<CURL*>(handle));
+            idleHandles_.push_back(handle);
+            return false;
+        }
+        queued_.push_back(Transfer{handle, std::move(completion)});
+        outstanding_++;
+    }
+
+    curl_multi_wakeup(static_cast<CURLM*>(multiHandle_));
+    return true;
+}
+
+void HttpEventLoop::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_.exchange(false)) {
+            return;
+        }
+    }
+
+    curl_multi_wakeup(static_cast<CURLM*>(multiHandle_));
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void HttpEventLoop::run() {
+    CURLM* multi = static_cast<CURLM*>(multiHandle_);
+
+    while (running_) {
+        // Pick up newly submitted transfers
+        std::vector<Transfer> queued;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            queued.swap(queued_);
+        }
+
+        for (auto& transfer : queued) {
+            active_[transfer.handle] = std::move(transfer.completion);
+            if (curl_multi_add_handle(multi, static_cast<CURL*>(transfer.handle)) != CURLM_OK) {
+                complete(transfer.handle, CURLE_FAILED_INIT);
+            }
+        }
+
+        int runningHandles = 0;
+        curl_multi_perform(multi, &runningHandles);
+
+        // Dispatch finished transfers
+        int messagesLeft = 0;
+        CURLMsg* msg = nullptr;
+        while ((msg = curl_multi_info_read(multi, &messagesLeft)) != nullptr) {
+            if (msg->msg == CURLMSG_DONE) {
+                CURL* handle = msg->easy_handle;
+                CURLcode code = msg->data.result;
+                curl_multi_remove_handle(multi, handle);
+                complete(handle, code);
+            }
+        }
+
+        curl_multi_poll(multi, nullptr, 0, POLL_TIMEOUT_MS, nullptr);
+    }
+
+    // Fail whatever is still in flight or queued
+    std::vector<Transfer> queued;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queued.swap(queued_);
+    }
+    for (auto& transfer : queued) {
+        active_[transfer.handle] = std::move(transfer.completion);
+    }
+
+    while (!active_.empty()) {
+        void* handle = active_.begin()->first;
+        curl_multi_remove_handle(multi, static_cast<CURL*>(handle));
+        complete(handle, CURLE_ABORTED_BY_CALLBACK);
+    }
+}
+
+void HttpEventLoop::complete(void* handle, int curlCode) {
+    auto it = active_.find(handle);
+    if (it == active_.end()) {
+        return;
+    }
+
+    Completion completion = std::move(it->second);
+    active_.erase(it);
+
+    try {
+        completion(handle, curlCode);
+    } catch (const std::exception& e) {
+        std::cerr << "Exception in HTTP completion: " << e.what() << std::endl;
+    }
+
+    outstanding_--;
+    recycle(handle);
+}
+
+void HttpEventLoop::recycle(void* handle) {
+    // Drop per-request options; the multi handle keeps the connections
+    curl_easy_reset(static_cast<CURL*>(handle));
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (idleHandles_.size() < maxIdleHandles_) {
+            idleHandles_.push_back(handle);
+            return;
+        }
+    }
+    curl_easy_cleanup(static_cast<CURL*>(handle));
+}
+
+} // namespace messaging
+} // namespace hmdev
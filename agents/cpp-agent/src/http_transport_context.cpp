@@ -0,0 +1,80 @@
+#include "hmdev/messaging/api/http_transport_context.h"
+#include <curl/curl.h>
+#include <stdexcept>
+
+namespace hmdev {
+namespace messaging {
+
+namespace {
+
+// Performs curl_global_init once and curl_global_cleanup at process exit
+struct CurlGlobal {
+    CURLcode code;
+
+    CurlGlobal() : code(curl_global_init(CURL_GLOBAL_DEFAULT)) {}
+    ~CurlGlobal() {
+        if (code == CURLE_OK) {
+            curl_global_cleanup();
+        }
+    }
+};
+
+void shareLock(CURL*, curl_lock_data data, curl_lock_access, void* userptr) {
+    static_cast<std::mutex*>(userptr)[data].lock();
+}
+
+void shareUnlock(CURL*, curl_lock_data data, void* userptr) {
+    static_cast<std::mutex*>(userptr)[data].unlock();
+}
+
+} // namespace
+
+void HttpTransportContext::initializeCurl() {
+    static CurlGlobal global;
+    if (global.code != CURLE_OK) {
+        throw std::runtime_error("Failed to initialize CURL");
+    }
+}
+
+HttpTransportContext::HttpTransportContext(bool shareDns,
+                                           bool shareTlsSessions,
+                                           bool shareConnections)
+    : shareHandle_(nullptr), locks_(new std::mutex[CURL_LOCK_DATA_LAST]) {
+    initializeCurl();
+
+    CURLSH* share = curl_share_init();
+    if (!share) {
+        throw std::runtime_error("Failed to initialize CURL share handle");
+    }
+
+    curl_share_setopt(share, CURLSHOPT_LOCKFUNC, shareLock);
+    curl_share_setopt(share, CURLSHOPT_UNLOCKFUNC, shareUnlock);
+    curl_share_setopt(share, CURLSHOPT_USERDATA, locks_.get());
+
+    if (shareDns) {
+        curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+    }
+    if (shareTlsSessions) {
+        curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+    }
+    if (shareConnections) {
+        curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+    }
+
+    shareHandle_ = share;
+}
+
+HttpTransportContext::~HttpTransportContext() {
+    if (shareHandle_) {
+        curl_share_cleanup(static_cast<CURLSH*>(shareHandle_));
+        shareHandle_ = nullptr;
+    }
+}
+
+std::shared_ptr<HttpTransportContext> HttpTransportContext::shared() {
+    static std::shared_ptr<HttpTransportContext> context = std::make_shared<HttpTransportContext>();
+    return context;
+}
+
+} // namespace messaging
+} // namespace hmdev
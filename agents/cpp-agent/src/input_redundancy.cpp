@@ -0,0 +1,110 @@
+#include "hmdev/messaging/util/input_redundancy.h"
+#include <algorithm>
+
+namespace hmdev {
+namespace messaging {
+
+RedundantInputSender::RedundantInputSender(const InputRedundancyConfig& config)
+    : config_(config), sequence_(0), acked_(0) {
+    config_.depth = std::max<size_t>(1, config_.depth);
+}
+
+std::string RedundantInputSender::encode(const json& input) {
+    sequence_++;
+    pending_.push_back(Pending{sequence_, input.dump()});
+    if (pending_.size() > config_.depth) {
+        pending_.pop_front();
+    }
+
+    // Newest first; older inputs are added while they fit the budget
+    std::string content = "{\"s\":" + std::to_string(sequence_) + ",\"i\":[" + pending_.back().encoded;
+    for (auto it = pending_.rbegin() + 1; it != pending_.rend(); ++it) {
+        if (content.size() + it->encoded.size() + 3 > config_.maxBytes) {
+            break;
+        }
+        content += ',';
+        content += it->encoded;
+        stats_.redundantCopies++;
+    }
+    content += "]}";
+
+    stats_.inputs++;
+    stats_.bytes += content.size();
+    return content;
+}
+
+bool RedundantInputSender::acknowledge(uint64_t sequence) {
+    if (sequence > sequence_) {
+        return false;
+    }
+    if (sequence > acked_) {
+        acked_ = sequence;
+        while (!pending_.empty() && pending_.front().sequence <= acked_) {
+            pending_.pop_front();
+        }
+        stats_.acks++;
+    }
+    return true;
+}
+
+bool RedundantInputSender::acknowledge(const std::string& content) {
+    json ack = json::parse(content, nullptr, false);
+    if (ack.is_discarded() || !ack.is_object() || !ack.contains("inputAck") ||
+        !ack["inputAck"].is_number_unsigned()) {
+        return false;
+    }
+    return acknowledge(ack["inputAck"].get<uint64_t>());
+}
+
+InputRedundancySenderStats RedundantInputSender::getStats() const {
+    InputRedundancySenderStats stats = stats_;
+    stats.pending = pending_.size();
+    return stats;
+}
+
+RedundantInputReceiver::RedundantInputReceiver() : lastSequence_(0) {}
+
+bool RedundantInputReceiver::isEncoded(const std::string& content) {
+    json encoded = json::parse(content, nullptr, false);
+    return encoded.is_object() && encoded.contains("s") && encoded.contains("i") && encoded["i"].is_array();
+}
+
+size_t RedundantInputReceiver::receive(const std::string& content, std::vector<json>& inputs) {
+    json encoded = json::parse(content, nullptr, false);
+    if (encoded.is_discarded() || !encoded.is_object() || !encoded.contains("s") ||
+        !encoded["s"].is_number_unsigned() || !encoded.contains("i") || !encoded["i"].is_array() ||
+        encoded["i"].empty() || encoded["i"].size() > encoded["s"].get<uint64_t>()) {
+        stats_.malformed++;
+        return 0;
+    }
+    stats_.datagrams++;
+
+    // Entry k of "i" is sequence s - k
+    uint64_t newest = encoded["s"].get<uint64_t>();
+    json& carried = encoded["i"];
+    uint64_t oldest = newest - (carried.size() - 1);
+    if (newest <= lastSequence_) {
+        stats_.duplicates += carried.size();
+        return 0;
+    }
+
+    uint64_t first = std::max(oldest, lastSequence_ + 1);
+    stats_.duplicates += first - oldest;
+    stats_.lost += first - (lastSequence_ + 1);
+    for (uint64_t sequence = first; sequence <= newest; sequence++) {
+        inputs.push_back(std::move(carried[newest - sequence]));
+    }
+
+    size_t delivered = newest - first + 1;
+    stats_.delivered += delivered;
+    stats_.recovered += delivered - 1;
+    lastSequence_ = newest;
+    return delivered;
+}
+
+std::string RedundantInputReceiver::ack() const {
+    return json{{"inputAck", lastSequence_}}.dump();
+}
+
+} // namespace messaging
+} // namespace hmdev
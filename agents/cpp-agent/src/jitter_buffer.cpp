@@ -0,0 +1,196 @@
+#include "hmdev/messaging/util/jitter_buffer.h"
+#include <algorithm>
+#include <cmath>
+
+namespace hmdev {
+namespace messaging {
+
+// RFC 3550 jitter gain, and the playout delay gains towards a higher / lower target
+static constexpr double JITTER_GAIN = 1.0 / 16.0;
+static constexpr double INTERVAL_GAIN = 1.0 / 8.0;
+static constexpr double DELAY_RISE_GAIN = 1.0 / 4.0;
+static constexpr double DELAY_DECAY_GAIN = 1.0 / 64.0;
+
+static bool snapshotBefore(const EventMessage& a, const EventMessage& b) {
+    if (a.timestamp != b.timestamp) {
+        return a.timestamp < b.timestamp;
+    }
+    return a.localOffset < b.localOffset;
+}
+
+SnapshotJitterBuffer::SnapshotJitterBuffer(const JitterBufferConfig& config) : config_(config) {
+    config_.maxSnapshots = std::max<size_t>(2, config_.maxSnapshots);
+    config_.maxSenders = std::max<size_t>(1, config_.maxSenders);
+    config_.transitWindow = std::max<size_t>(1, config_.transitWindow);
+    config_.minDelayMs = std::max(0, config_.minDelayMs);
+    config_.maxDelayMs = std::max(config_.minDelayMs, config_.maxDelayMs);
+}
+
+bool SnapshotJitterBuffer::push(const EventMessage& message, Clock::time_point now) {
+    if (message.type != EventType::GAME_STATE) {
+        return false;
+    }
+
+    auto found = senders_.find(message.from);
+    if (found == senders_.end()) {
+        evictIfFull();
+        found = senders_.emplace(message.from, Sender()).first;
+    }
+    Sender& sender = found->second;
+
+    auto position = std::lower_bound(
+        sender.snapshots.begin(), sender.snapshots.end(), message,
+        [](const std::shared_ptr<const EventMessage>& a, const EventMessage& b) { return snapshotBefore(*a, b); });
+    if (position != sender.snapshots.end() && !snapshotBefore(message, **position)) {
+        stats_.duplicates++;
+        return false;
+    }
+
+    // Late arrivals still count towards jitter; they are what the delay must cover
+    updateTiming(sender, message, now);
+    if (position == sender.snapshots.begin() && !sender.snapshots.empty() &&
+        static_cast<double>(sender.snapshots.front()->timestamp) <= sender.renderedMs) {
+        stats_.late++;
+        return false;
+    }
+
+    sender.snapshots.insert(position, std::make_shared<const EventMessage>(message));
+    if (sender.snapshots.size() > config_.maxSnapshots) {
+        sender.snapshots.pop_front();
+        stats_.overflows++;
+    }
+    stats_.received++;
+    return true;
+}
+
+size_t SnapshotJitterBuffer::push(const EventMessageResult& result, Clock::time_point now) {
+    size_t buffered = 0;
+    for (const EventMessage& message : result.messages) {
+        buffered += push(message, now) ? 1 : 0;
+    }
+    for (const EventMessage& message : result.ephemeralMessages) {
+        buffered += push(message, now) ? 1 : 0;
+    }
+    return buffered;
+}
+
+bool SnapshotJitterBuffer::sample(const std::string& sender, Clock::time_point now, SnapshotPair& pair) {
+    auto found = senders_.find(sender);
+    if (found == senders_.end() || found->second.snapshots.empty()) {
+        return false;
+    }
+    Sender& state = found->second;
+    auto& snapshots = state.snapshots;
+
+    double renderMs = static_cast<double>(toUs(now) - state.minTransitUs - static_cast<int64_t>(state.delayUs)) / 1000.0;
+    renderMs = std::max(renderMs, state.renderedMs);
+    state.renderedMs = renderMs;
+
+    auto after = std::upper_bound(
+        snapshots.begin(), snapshots.end(), renderMs,
+        [](double time, const std::shared_ptr<const EventMessage>& snapshot) {
+            return time < static_cast<double>(snapshot->timestamp);
+        });
+
+    pair = SnapshotPair();
+    pair.renderTimestampMs = renderMs;
+    if (after == snapshots.begin()) {
+        // Still before the oldest snapshot (start-up)
+        pair.from = snapshots.front();
+        pair.to = snapshots.front();
+        return true;
+    }
+    if (after == snapshots.end()) {
+        pair.from = snapshots.back();
+        pair.to = snapshots.back();
+        pair.underrun = true;
+        stats_.underruns++;
+        snapshots.erase(snapshots.begin(), snapshots.end() - 1);
+        return true;
+    }
+
+    auto before = after - 1;
+    pair.from = *before;
+    pair.to = *after;
+    double span = static_cast<double>(pair.to->timestamp - pair.from->timestamp);
+    pair.alpha = std::min(1.0, (renderMs - static_cast<double>(pair.from->timestamp)) / span);
+
+    // Only the snapshot being interpolated from is needed from the past
+    snapshots.erase(snapshots.begin(), before);
+    return true;
+}
+
+void SnapshotJitterBuffer::remove(const std::string& sender) {
+    senders_.erase(sender);
+}
+
+JitterBufferStats SnapshotJitterBuffer::getStats() const {
+    JitterBufferStats stats = stats_;
+    stats.senders = senders_.size();
+    return stats;
+}
+
+JitterBufferSenderStats SnapshotJitterBuffer::getSenderStats(const std::string& sender) const {
+    JitterBufferSenderStats stats;
+    auto found = senders_.find(sender);
+    if (found != senders_.end()) {
+        stats.depth = found->second.snapshots.size();
+        stats.delayMs = found->second.delayUs / 1000.0;
+        stats.jitterMs = found->second.jitterUs / 1000.0;
+        stats.intervalMs = found->second.intervalUs / 1000.0;
+    }
+    return stats;
+}
+
+int64_t SnapshotJitterBuffer::toUs(Clock::time_point time) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(time.time_since_epoch()).count();
+}
+
+void SnapshotJitterBuffer::updateTiming(Sender& sender, const EventMessage& message, Clock::time_point now) {
+    // Transit includes the unknown clock offset; only its variation and minimum matter
+    int64_t transit = toUs(now) - message.timestamp * 1000;
+    sender.transits.push_back(transit);
+    if (sender.transits.size() > config_.transitWindow) {
+        sender.transits.pop_front();
+    }
+    sender.minTransitUs = *std::min_element(sender.transits.begin(), sender.transits.end());
+
+    if (sender.hasTransit) {
+        double difference = std::fabs(static_cast<double>(transit - sender.lastTransitUs));
+        sender.jitterUs += (difference - sender.jitterUs) * JITTER_GAIN;
+        if (message.timestamp > sender.newestTimestampMs) {
+            double interval = static_cast<double>(message.timestamp - sender.newestTimestampMs) * 1000.0;
+            sender.intervalUs = sender.intervalUs == 0.0
+                ? interval : sender.intervalUs + (interval - sender.intervalUs) * INTERVAL_GAIN;
+        }
+    }
+    sender.newestTimestampMs = std::max(sender.newestTimestampMs, message.timestamp);
+    sender.lastTransitUs = transit;
+    sender.lastArrival = now;
+
+    // One interval to have the next snapshot in hand, plus headroom for its jitter
+    double target = sender.intervalUs + config_.jitterMultiplier * sender.jitterUs;
+    target = std::max(config_.minDelayMs * 1000.0, std::min(config_.maxDelayMs * 1000.0, target));
+    if (!sender.hasTransit) {
+        sender.delayUs = target;
+    } else {
+        double gain = target > sender.delayUs ? DELAY_RISE_GAIN : DELAY_DECAY_GAIN;
+        sender.delayUs += (target - sender.delayUs) * gain;
+    }
+    sender.hasTransit = true;
+}
+
+void SnapshotJitterBuffer::evictIfFull() {
+    while (senders_.size() >= config_.maxSenders) {
+        auto oldest = std::min_element(senders_.begin(), senders_.end(),
+                                       [](const std::pair<const std::string, Sender>& a,
+                                          const std::pair<const std::string, Sender>& b) {
+                                           return a.second.lastArrival < b.second.lastArrival;
+                                       });
+        senders_.erase(oldest);
+        stats_.evictions++;
+    }
+}
+
+} // namespace messaging
+} // namespace hmdev
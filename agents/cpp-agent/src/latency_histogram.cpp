@@ -0,0 +1,63 @@
+#include "hmdev/messaging/util/latency_histogram.h"
+#include <algorithm>
+
+namespace hmdev {
+namespace messaging {
+
+uint64_t LatencyHistogramSnapshot::percentileUs(double p) const {
+    if (count == 0) {
+        return 0;
+    }
+
+    uint64_t rank = static_cast<uint64_t>(p / 100.0 * (count - 1)) + 1;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < buckets.size(); i++) {
+        seen += buckets[i];
+        if (seen >= rank) {
+            // The open-ended bucket has no upper bound; report the largest sample
+            return i + 1 == buckets.size() ? maxUs : std::min(bucketUpperBoundUs(i), maxUs);
+        }
+    }
+    return maxUs;
+}
+
+LatencyHistogram::LatencyHistogram() : count_(0), sumUs_(0), maxUs_(0) {
+    for (auto& bucket : buckets_) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+}
+
+void LatencyHistogram::record(int64_t us) {
+    if (us < 0) {
+        return;
+    }
+
+    uint64_t value = static_cast<uint64_t>(us);
+    size_t index = 0;
+    while (index + 1 < BUCKET_COUNT && value >= (uint64_t(1) << index)) {
+        index++;
+    }
+
+    buckets_[index].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    sumUs_.fetch_add(value, std::memory_order_relaxed);
+
+    uint64_t max = maxUs_.load(std::memory_order_relaxed);
+    while (value > max && !maxUs_.compare_exchange_weak(max, value, std::memory_order_relaxed)) {
+    }
+}
+
+LatencyHistogramSnapshot LatencyHistogram::snapshot() const {
+    LatencyHistogramSnapshot snapshot;
+    snapshot.buckets.resize(BUCKET_COUNT);
+    for (size_t i = 0; i < BUCKET_COUNT; i++) {
+        snapshot.buckets[i] = buckets_[i].load(std::memory_order_relaxed);
+        snapshot.count += snapshot.buckets[i];
+    }
+    snapshot.sumUs = sumUs_.load(std::memory_order_relaxed);
+    snapshot.maxUs = maxUs_.load(std::memory_order_relaxed);
+    return snapshot;
+}
+
+} // namespace messaging
+} // namespace hmdev
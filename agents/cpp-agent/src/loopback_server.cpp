@@ -0,0 +1,548 @@
+#include "hmdev/messaging/api/loopback_server.h"
+#include "hmdev/messaging/util/utils.h"
+#include <thread>
+#include <algorithm>
+#include <limits>
+
+namespace hmdev {
+namespace messaging {
+
+// Action name from a path such as "/push" or "/api/v1/push"
+static std::string actionFromPath(const std::string& path) {
+    size_t slash = path.find_last_of('/');
+    return slash == std::string::npos ? path : path.substr(slash + 1);
+}
+
+static std::string stringField(const json& body, const char* key) {
+    if (body.contains(key) && body[key].is_string()) {
+        return body[key].get<std::string>();
+    }
+    return "";
+}
+
+// Missing or null fields keep the fallback; false if the field holds anything but an integer
+static bool integerField(const json& body, const char* key, long long fallback, long long& value) {
+    value = fallback;
+    if (!body.contains(key) || body[key].is_null()) {
+        return true;
+    }
+    if (!body[key].is_number_integer()) {
+        return false;
+    }
+    if (body[key].is_number_unsigned()) {
+        value = static_cast<long long>(std::min<uint64_t>(body[key].get<uint64_t>(),
+                                                          std::numeric_limits<long long>::max()));
+    } else {
+        value = body[key].get<long long>();
+    }
+    return true;
+}
+
+static json errorResponse(const std::string& message) {
+    return json{{"status", "error"}, {"message", message}};
+}
+
+/**
+ * HTTP transport calling straight into a LoopbackServer
+ *
+ * Synchronous requests run on the caller's thread. Asynchronous requests are
+ * queued to a dispatcher thread that parks empty pulls until the server
+ * changes or their long-poll deadline passes, like the curl event loop.
+ */
+class LoopbackHttpTransport : public HttpTransport {
+public:
+    explicit LoopbackHttpTransport(std::shared_ptr<LoopbackServer> server)
+        : server_(std::move(server)), stopping_(false) {
+        thread_ = std::thread(&LoopbackHttpTransport::run, this);
+    }
+
+    ~LoopbackHttpTransport() override {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        server_->notifyChange();
+        thread_.join();
+    }
+
+    void setDefaultHeader(const std::string&, const std::string&) override {}
+
+    HttpClientResult post(const std::string& path, const json& body, int timeoutMs) override {
+        return server_->handleHttp(path, body, timeoutMs);
+    }
+
+    void postAsync(const std::string& path,
+                   const json& body,
+                   int timeoutMs,
+                   HttpCallback callback) override {
+        Pending pending;
+        pending.path = path;
+        pending.body = body;
+        pending.start = std::chrono::steady_clock::now();
+        pending.deadline = server_->pollDeadline(pending.start, timeoutMs);
+        pending.callback = std::move(callback);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            queued_.push_back(std::move(pending));
+        }
+        server_->notifyChange();
+    }
+
+private:
+    struct Pending {
+        std::string path;
+        json body;
+        LoopbackServer::TimePoint start;
+        LoopbackServer::TimePoint deadline;
+        HttpCallback callback;
+    };
+
+    std::shared_ptr<LoopbackServer> server_;
+    std::thread thread_;
+    std::mutex mutex_;             // Guards queued_ and stopping_
+    std::vector<Pending> queued_;
+    bool stopping_;
+
+    void run() {
+        std::vector<Pending> waiting;
+        std::vector<std::pair<HttpCallback, HttpClientResult>> completed;
+
+        while (true) {
+            // Read the version first so a submit after this point always wakes the wait below
+            uint64_t version = server_->getVersion();
+            bool stopping;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                for (auto& pending : queued_) {
+                    waiting.push_back(std::move(pending));
+                }
+                queued_.clear();
+                stopping = stopping_;
+            }
+
+            auto now = std::chrono::steady_clock::now();
+            auto nextDeadline = now + std::chrono::hours(1);
+            size_t kept = 0;
+            for (size_t i = 0; i < waiting.size(); i++) {
+                Pending& pending = waiting[i];
+                HttpClientResult result;
+                bool allowWait = !stopping && now < pending.deadline;
+                if (server_->tryHandle(pending.path, pending.body, allowWait, result)) {
+                    result.timings.totalUs = std::chrono::duration_cast<std::chrono::microseconds>(
+                        std::chrono::steady_clock::now() - pending.start).count();
+                    result.timings.starttransferUs = result.timings.totalUs;
+                    completed.emplace_back(std::move(pending.callback), std::move(result));
+                } else {
+                    nextDeadline = std::min(nextDeadline, pending.deadline);
+                    if (kept != i) {
+                        waiting[kept] = std::move(pending);
+                    }
+                    kept++;
+                }
+            }
+            waiting.resize(kept);
+
+            for (auto& entry : completed) {
+                if (entry.first) {
+                    entry.first(entry.second);
+                }
+            }
+            completed.clear();
+
+            if (stopping) {
+                break;
+            }
+            server_->waitForChange(version, nextDeadline);
+        }
+    }
+};
+
+/**
+ * UDP transport calling straight into a LoopbackServer
+ */
+class LoopbackUdpTransport : public UdpTransport {
+public:
+    explicit LoopbackUdpTransport(std::shared_ptr<LoopbackServer> server)
+        : server_(std::move(server)) {}
+
+    bool send(const UdpEnvelope& envelope) override {
+        server_->handleUdp(envelope);
+        return true;
+    }
+
+    json sendAndWait(const UdpEnvelope& envelope, int) override {
+        return server_->handleUdp(envelope);
+    }
+
+private:
+    std::shared_ptr<LoopbackServer> server_;
+};
+
+// LoopbackServer
+
+LoopbackServer::LoopbackServer(int maxPollWaitMs)
+    : maxPollWaitMs_(std::max(0, maxPollWaitMs)), version_(0), shutdown_(false),
+      nextChannelId_(1), nextSessionId_(1), globalOffset_(0), requests_(0) {
+}
+
+LoopbackServer::~LoopbackServer() {
+    shutdown();
+}
+
+std::unique_ptr<HttpTransport> LoopbackServer::createHttpTransport() {
+    return std::make_unique<LoopbackHttpTransport>(shared_from_this());
+}
+
+std::unique_ptr<UdpTransport> LoopbackServer::createUdpTransport() {
+    return std::make_unique<LoopbackUdpTransport>(shared_from_this());
+}
+
+void LoopbackServer::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        shutdown_ = true;
+        version_++;
+    }
+    changed_.notify_all();
+}
+
+LoopbackServerStats LoopbackServer::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    LoopbackServerStats stats;
+    stats.channels = channels_.size();
+    stats.sessions = sessions_.size();
+    stats.messages = static_cast<uint64_t>(globalOffset_);
+    stats.requests = requests_;
+    return stats;
+}
+
+HttpClientResult LoopbackServer::handleHttp(const std::string& path, const json& body, int timeoutMs) {
+    auto start = std::chrono::steady_clock::now();
+    TimePoint deadline = pollDeadline(start, timeoutMs);
+
+    HttpClientResult result;
+    while (true) {
+        uint64_t version = getVersion();
+        if (tryHandle(path, body, std::chrono::steady_clock::now() < deadline, result)) {
+            break;
+        }
+        waitForChange(version, deadline);
+    }
+
+    result.timings.totalUs = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    result.timings.starttransferUs = result.timings.totalUs;
+    return result;
+}
+
+json LoopbackServer::handleUdp(const UdpEnvelope& envelope) {
+    HttpClientResult result;
+    if (envelope.action == "push") {
+        tryHandle("push", envelope.payload, false, result);
+        return nullptr;
+    }
+    if (envelope.action == "push-batch") {
+        const json& messages = envelope.payload.contains("messages") ? envelope.payload["messages"] : json();
+        if (messages.is_array()) {
+            for (const auto& message : messages) {
+                tryHandle("push", message, false, result);
+            }
+        }
+        return nullptr;
+    }
+    if (envelope.action == "pull") {
+        tryHandle("pull", envelope.payload, false, result);
+        json reply = {{"status", "ok"}, {"result", result.dataAsJson()}};
+        if (!envelope.requestId.empty()) {
+            reply["requestId"] = envelope.requestId;
+        }
+        return reply;
+    }
+    if (envelope.action == "hello") {
+        // Accept the first offered encoding; the in-process transport never serializes
+        json reply = {{"status", "ok"}, {"encoding", "json"}};
+        const json& offered = envelope.payload.contains("encodings") ? envelope.payload["encodings"] : json();
+        UdpEncoding encoding;
+        if (offered.is_array() && !offered.empty() && offered[0].is_string() &&
+            stringToUdpEncoding(offered[0].get<std::string>(), encoding)) {
+            reply["encoding"] = offered[0];
+        }
+        if (!envelope.requestId.empty()) {
+            reply["requestId"] = envelope.requestId;
+        }
+        return reply;
+    }
+    if (envelope.action == "time") {
+        // Same instant for receive and send: handling is synchronous
+        int64_t nowUs = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        const json& t0 = envelope.payload.contains("t0") ? envelope.payload["t0"] : json();
+        return json{{"action", "time"}, {"t0", t0}, {"t1", nowUs}, {"t2", nowUs}};
+    }
+    return json{{"status", "error"}, {"message", "Unknown action"}};
+}
+
+bool LoopbackServer::tryHandle(const std::string& path, const json& body,
+                               bool allowWait, HttpClientResult& result) {
+    std::string action = actionFromPath(path);
+    json response;
+    int status = 200;
+    bool changed = false;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (shutdown_) {
+            allowWait = false;
+        }
+
+        if (action == "pull") {
+            if (!pull(body, allowWait, status, response)) {
+                return false;
+            }
+        } else if (action == "push") {
+            status = push(body, response);
+            changed = true;
+        } else if (action == "create-channel") {
+            status = createChannel(body, response);
+        } else if (action == "connect") {
+            status = connect(body, response);
+            changed = true;
+        } else if (action == "list-agents") {
+            status = listAgents(body, response);
+        } else if (action == "list-system-agents") {
+            status = findSession(body) ? 200 : 401;
+            response = status == 200 ? json{{"status", "success"}, {"data", json::array()}}
+                                     : errorResponse("Invalid session");
+        } else if (action == "disconnect") {
+            status = disconnect(body, response);
+            changed = true;
+        } else {
+            status = 404;
+            response = errorResponse("Unknown action: " + action);
+        }
+
+        requests_++;
+        if (changed) {
+            version_++;
+        }
+    }
+
+    if (changed) {
+        changed_.notify_all();
+    }
+
+    result.statusCode = status;
+    result.data = response.dump();
+    result.success = true;
+    return true;
+}
+
+uint64_t LoopbackServer::getVersion() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return version_;
+}
+
+void LoopbackServer::waitForChange(uint64_t version, TimePoint deadline) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    changed_.wait_until(lock, deadline, [&]() { return version_ != version; });
+}
+
+void LoopbackServer::notifyChange() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        version_++;
+    }
+    changed_.notify_all();
+}
+
+LoopbackServer::TimePoint LoopbackServer::pollDeadline(TimePoint start, int timeoutMs) const {
+    return start + std::chrono::milliseconds(std::min(std::max(0, timeoutMs), maxPollWaitMs_));
+}
+
+int LoopbackServer::createChannel(const json& body, json& response) {
+    std::string name = stringField(body, "channelName");
+    std::string password = stringField(body, "channelPassword");
+    if (name.empty()) {
+        response = errorResponse("Missing channelName");
+        return 400;
+    }
+
+    auto existing = channelsByName_.find(name);
+    if (existing != channelsByName_.end()) {
+        if (channels_[existing->second].password != password) {
+            response = errorResponse("Invalid channel password");
+            return 401;
+        }
+        response = json{{"status", "success"}, {"data", {{"channelId", existing->second}}}};
+        return 200;
+    }
+
+    std::string channelId = "loopback-channel-" + std::to_string(nextChannelId_++);
+    Channel& channel = channels_[channelId];
+    channel.name = name;
+    channel.password = password;
+    channelsByName_[name] = channelId;
+
+    response = json{{"status", "success"}, {"data", {{"channelId", channelId}}}};
+    return 200;
+}
+
+int LoopbackServer::connect(const json& body, json& response) {
+    std::string channelId = stringField(body, "channelId");
+    if (channelId.empty()) {
+        auto byName = channelsByName_.find(stringField(body, "channelName"));
+        if (byName != channelsByName_.end()) {
+            channelId = byName->second;
+        }
+    }
+
+    auto channel = channels_.find(channelId);
+    if (channel == channels_.end()) {
+        response = json{{"status", "success"}, {"data", errorResponse("Channel not found")}};
+        return 200;
+    }
+
+    std::string password = stringField(body, "channelPassword");
+    if (!password.empty() && password != channel->second.password) {
+        response = json{{"status", "success"}, {"data", errorResponse("Invalid channel password")}};
+        return 200;
+    }
+
+    std::string sessionId = stringField(body, "sessionId");
+    if (sessionId.empty() || sessions_.count(sessionId) == 0) {
+        sessionId = "loopback-session-" + std::to_string(nextSessionId_++);
+    }
+
+    Session& session = sessions_[sessionId];
+    session.channelId = channelId;
+    session.agent.agentName = stringField(body, "agentName");
+    if (body.contains("agentContext") && body["agentContext"].is_object()) {
+        session.agent.metadata = body["agentContext"].get<std::map<std::string, std::string>>();
+        session.agent.agentType = session.agent.metadata["agentType"];
+        session.agent.descriptor = session.agent.metadata["descriptor"];
+    }
+
+    response = json{{"status", "success"}, {"data", {
+        {"status", "success"},
+        {"sessionId", sessionId},
+        {"channelId", channelId},
+        {"globalOffset", globalOffset_},
+        {"localOffset", static_cast<long long>(channel->second.log.size())}
+    }}};
+    return 200;
+}
+
+int LoopbackServer::push(const json& body, json& response) {
+    auto session = sessions_.find(stringField(body, "sessionId"));
+    if (session == sessions_.end()) {
+        response = errorResponse("Invalid session");
+        return 401;
+    }
+
+    Channel& channel = channels_[session->second.channelId];
+
+    StoredMessage stored;
+    stored.senderSessionId = session->first;
+    stored.message.timestamp = Utils::getCurrentTimeMillis();
+    stored.message.from = session->second.agent.agentName;
+    stored.message.to = stringField(body, "to");
+    stored.message.type = stringToEventType(stringField(body, "type"));
+    stored.message.content = stringField(body, "content");
+    stored.message.encrypted = body.contains("encrypted") && body["encrypted"].is_boolean() &&
+                               body["encrypted"].get<bool>();
+    stored.message.globalOffset = globalOffset_++;
+    stored.message.localOffset = static_cast<long long>(channel.log.size());
+    channel.log.push_back(std::move(stored));
+
+    response = json{{"status", "success"}};
+    return 200;
+}
+
+bool LoopbackServer::pull(const json& body, bool allowWait, int& status, json& response) {
+    auto session = sessions_.find(stringField(body, "sessionId"));
+    if (session == sessions_.end()) {
+        status = 401;
+        response = errorResponse("Invalid session");
+        return true;
+    }
+
+    const Channel& channel = channels_[session->second.channelId];
+    const std::string& agentName = session->second.agent.agentName;
+
+    long long localOffset = -1;
+    long long limit = 10;
+    if (body.contains("receiveConfig") && body["receiveConfig"].is_object()) {
+        const json& config = body["receiveConfig"];
+        if (!integerField(config, "localOffset", -1, localOffset) ||
+            !integerField(config, "limit", 10, limit)) {
+            status = 400;
+            response = errorResponse("Invalid receiveConfig");
+            return true;
+        }
+        limit = std::max(1LL, limit);
+    }
+
+    size_t index = localOffset < 0 ? channel.log.size()
+                                   : std::min(static_cast<size_t>(localOffset), channel.log.size());
+
+    json events = json::array();
+    for (; index < channel.log.size() && events.size() < static_cast<size_t>(limit); index++) {
+        const StoredMessage& stored = channel.log[index];
+        if (stored.senderSessionId == session->first) {
+            continue;
+        }
+        const std::string& to = stored.message.to;
+        if (to.empty() || to == "*" || to == agentName || to == session->first) {
+            events.push_back(stored.message.toJson());
+        }
+    }
+
+    if (events.empty() && allowWait) {
+        return false;
+    }
+
+    long long nextGlobalOffset = index < channel.log.size() ? channel.log[index].message.globalOffset
+                                                            : globalOffset_;
+    status = 200;
+    response = json{{"status", "success"}, {"data", {
+        {"events", events},
+        {"nextGlobalOffset", nextGlobalOffset},
+        {"nextLocalOffset", static_cast<long long>(index)}
+    }}};
+    return true;
+}
+
+int LoopbackServer::listAgents(const json& body, json& response) {
+    Session* session = findSession(body);
+    if (!session) {
+        response = errorResponse("Invalid session");
+        return 401;
+    }
+
+    json agents = json::array();
+    for (const auto& entry : sessions_) {
+        if (entry.second.channelId == session->channelId) {
+            agents.push_back(entry.second.agent.toJson());
+        }
+    }
+
+    response = json{{"status", "success"}, {"data", agents}};
+    return 200;
+}
+
+int LoopbackServer::disconnect(const json& body, json& response) {
+    if (sessions_.erase(stringField(body, "sessionId")) == 0) {
+        response = errorResponse("Invalid session");
+        return 401;
+    }
+    response = json{{"status", "success"}};
+    return 200;
+}
+
+LoopbackServer::Session* LoopbackServer::findSession(const json& body) {
+    auto it = sessions_.find(stringField(body, "sessionId"));
+    return it == sessions_.end() ? nullptr : &it->second;
+}
+
+} // namespace messaging
+} // namespace hmdev
@@ -8,11 +8,15 @@ namespace hmdev {
 namespace messaging {
 
 MessagingChannelApi::MessagingChannelApi(const std::string& remoteUrl,
-                                        const std::string& developerApiKey)
+                                        const std::string& developerApiKey,
+                                        const HttpClientConfig& httpConfig,
+                                        const UdpClientConfig& udpConfig)
     : usePublicKey_(false), defaultPollSource_("AUTO") {
 
+    initLatencyStats();
+
     // Create HTTP client
-    httpClient_ = std::make_unique<HttpClient>(remoteUrl);
+    httpClient_ = std::make_unique<HttpClient>(remoteUrl, httpConfig);
 
     // Set developer API key if provided
     if (!developerApiKey.empty()) {
@@ -48,11 +52,59 @@ MessagingChannelApi::MessagingChannelApi(const std::string& remoteUrl,
     }
 
     // Create UDP client
-    udpClient_ = std::make_unique<UdpClient>(host, udpPort);
+    udpClient_ = std::make_unique<UdpClient>(host, udpPort, udpConfig);
+
+    if (httpConfig.prewarmConnections > 0) {
+        prewarm(httpConfig.prewarmConnections);
+    }
+}
+
+MessagingChannelApi::MessagingChannelApi(std::unique_ptr<HttpTransport> httpTransport,
+                                         std::unique_ptr<UdpTransport> udpTransport)
+    : httpClient_(std::move(httpTransport)), udpClient_(std::move(udpTransport)),
+      usePublicKey_(false), defaultPollSource_("AUTO") {
+
+    if (!httpClient_ || !udpClient_) {
+        throw std::invalid_argument("MessagingChannelApi requires HTTP and UDP transports");
+    }
+
+    initLatencyStats();
 }
 
 MessagingChannelApi::~MessagingChannelApi() {
-    // Unique pointers will auto-cleanup
+    // Prewarm uses both clients; unique pointers will auto-cleanup after it finishes
+    {
+        std::lock_guard<std::mutex> lock(prewarmMutex_);
+        if (prewarmThread_.joinable()) {
+            prewarmThread_.join();
+        }
+    }
+
+    // Outstanding async callbacks record latency, so stop HTTP before the histograms go
+    httpClient_.reset();
+}
+
+std::future<bool> MessagingChannelApi::prewarm(int connections) {
+    // Concurrent callers wait for each other; the previous run is joined before starting the next
+    std::lock_guard<std::mutex> lock(prewarmMutex_);
+    if (prewarmThread_.joinable()) {
+        prewarmThread_.join();
+    }
+
+    auto promise = std::make_shared<std::promise<bool>>();
+    std::future<bool> future = promise->get_future();
+
+    prewarmThread_ = std::thread([this, connections, promise]() {
+        if (!udpClient_->resolve()) {
+            std::cerr << "Prewarm: failed to resolve UDP endpoint" << std::endl;
+        } else {
+            udpClient_->negotiateEncoding(PREWARM_TIMEOUT_MS / 10);
+        }
+        int opened = httpClient_->prewarm(connections, PREWARM_TIMEOUT_MS);
+        promise->set_value(opened > 0);
+    });
+
+    return future;
 }
 
 ConnectResponse MessagingChannelApi::connect(const std::string& channelName,
@@ -128,6 +180,7 @@ ConnectResponse MessagingChannelApi::connect(const std::string& channelName,
         HttpClientResult result = httpClient_->post(getActionUrl("connect"),
                                                      connectRequest.toJson(),
                                                      POLLING_TIMEOUT_MS);
+        recordLatency("connect", result.timings);
 
         if (result.isHttpOk()) {
             json responseJson = result.dataAsJson();
@@ -181,26 +234,14 @@ EventMessageResult MessagingChannelApi::receive(const std::string& sessionId,
     EventMessageResult result;
 
     try {
-        MessageReceiveRequest request;
-        request.sessionId = sessionId;
-
-        // Apply default poll source if not specified in config
-        ReceiveConfig effectiveConfig = config;
-        if (effectiveConfig.pollSource.empty()) {
-            effectiveConfig.pollSource = defaultPollSource_;
-        }
-        request.receiveConfig = effectiveConfig;
+        MessageReceiveRequest request = buildReceiveRequest(sessionId, config);
 
         HttpClientResult httpResult = httpClient_->post(getActionUrl("pull"),
                                                         request.toJson(),
                                                         POLLING_TIMEOUT_MS);
+        recordLatency("pull", httpResult.timings);
 
-        if (httpResult.isHttpOk()) {
-            json responseJson = httpResult.dataAsJson();
-            if (responseJson.contains("data")) {
-                return EventMessageResult::fromJson(responseJson["data"]);
-            }
-        }
+        return parseReceiveResult(httpResult);
     } catch (const std::exception& e) {
         std::cerr << "Exception in receive operation: " << e.what() << std::endl;
     }
@@ -208,6 +249,45 @@ EventMessageResult MessagingChannelApi::receive(const std::string& sessionId,
     return result;
 }
 
+std::future<EventMessageResult> MessagingChannelApi::receiveAsync(const std::string& sessionId,
+                                                                  const ReceiveConfig& config) {
+    auto promise = std::make_shared<std::promise<EventMessageResult>>();
+    std::future<EventMessageResult> future = promise->get_future();
+
+    receiveAsync(sessionId, config, [promise](const EventMessageResult& result) {
+        promise->set_value(result);
+    });
+
+    return future;
+}
+
+void MessagingChannelApi::receiveAsync(const std::string& sessionId,
+                                       const ReceiveConfig& config,
+                                       ReceiveCallback callback) {
+    try {
+        MessageReceiveRequest request = buildReceiveRequest(sessionId, config);
+
+        httpClient_->postAsync(getActionUrl("pull"), request.toJson(), POLLING_TIMEOUT_MS,
+                               [this, callback](const HttpClientResult& httpResult) {
+                                   recordLatency("pull", httpResult.timings);
+                                   EventMessageResult result;
+                                   try {
+                                       result = parseReceiveResult(httpResult);
+                                   } catch (const std::exception& e) {
+                                       std::cerr << "Exception in receiveAsync operation: " << e.what() << std::endl;
+                                   }
+                                   if (callback) {
+                                       callback(result);
+                                   }
+                               });
+    } catch (const std::exception& e) {
+        std::cerr << "Exception in receiveAsync operation: " << e.what() << std::endl;
+        if (callback) {
+            callback(EventMessageResult());
+        }
+    }
+}
+
 std::vector<AgentInfo> MessagingChannelApi::getActiveAgents(const std::string& sessionId) {
     std::vector<AgentInfo> agents;
 
@@ -215,6 +295,7 @@ std::vector<AgentInfo> MessagingChannelApi::getActiveAgents(const std::string& s
         SessionRequest request(sessionId);
         HttpClientResult result = httpClient_->post(getActionUrl("list-agents"),
                                                      request.toJson());
+        recordLatency("list-agents", result.timings);
 
         if (result.isHttpOk()) {
             json responseJson = result.dataAsJson();
@@ -238,6 +319,7 @@ std::vector<AgentInfo> MessagingChannelApi::getSystemAgents(const std::string& s
         SessionRequest request(sessionId);
         HttpClientResult result = httpClient_->post(getActionUrl("list-system-agents"),
                                                      request.toJson());
+        recordLatency("list-system-agents", result.timings);
 
         if (result.isHttpOk()) {
             json responseJson = result.dataAsJson();
@@ -269,6 +351,7 @@ bool MessagingChannelApi::send(EventType eventType,
 
         HttpClientResult result = httpClient_->post(getActionUrl("push"),
                                                      request.toJson());
+        recordLatency("push", result.timings);
 
         return result.isHttpOk();
     } catch (const std::exception& e) {
@@ -277,6 +360,50 @@ bool MessagingChannelApi::send(EventType eventType,
     }
 }
 
+std::future<bool> MessagingChannelApi::sendAsync(EventType eventType,
+                                                 const std::string& message,
+                                                 const std::string& destination,
+                                                 const std::string& sessionId,
+                                                 bool encrypted) {
+    auto promise = std::make_shared<std::promise<bool>>();
+    std::future<bool> future = promise->get_future();
+
+    sendAsync(eventType, message, destination, sessionId, encrypted, [promise](bool sent) {
+        promise->set_value(sent);
+    });
+
+    return future;
+}
+
+void MessagingChannelApi::sendAsync(EventType eventType,
+                                    const std::string& message,
+                                    const std::string& destination,
+                                    const std::string& sessionId,
+                                    bool encrypted,
+                                    SendCallback callback) {
+    try {
+        EventMessageRequest request;
+        request.sessionId = sessionId;
+        request.type = eventType;
+        request.to = destination;
+        request.content = message;
+        request.encrypted = encrypted;
+
+        httpClient_->postAsync(getActionUrl("push"), request.toJson(), REQUEST_TIMEOUT_MS,
+                               [this, callback](const HttpClientResult& result) {
+                                   recordLatency("push", result.timings);
+                                   if (callback) {
+                                       callback(result.isHttpOk());
+                                   }
+                               });
+    } catch (const std::exception& e) {
+        std::cerr << "Exception in sendAsync operation: " << e.what() << std::endl;
+        if (callback) {
+            callback(false);
+        }
+    }
+}
+
 bool MessagingChannelApi::disconnect(const std::string& sessionId) {
     try {
         udpClient_->close();
@@ -288,6 +415,7 @@ bool MessagingChannelApi::disconnect(const std::string& sessionId) {
         SessionRequest request(sessionId);
         HttpClientResult result = httpClient_->post(getActionUrl("disconnect"),
                                                      request.toJson());
+        recordLatency("disconnect", result.timings);
 
         httpClient_->closeAll();
 
@@ -318,6 +446,112 @@ bool MessagingChannelApi::udpPush(const std::string& message,
     }
 }
 
+bool MessagingChannelApi::udpPush(const std::string& message,
+                                  const std::string& destination,
+                                  const std::string& sessionId,
+                                  EventType eventType,
+                                  UdpDelivery delivery,
+                                  uint8_t channel) {
+    try {
+        EventMessageRequest request;
+        request.sessionId = sessionId;
+        request.type = eventType;
+        request.to = destination;
+        request.content = message;
+        request.encrypted = false;
+
+        UdpEnvelope envelope("push", request.toJson());
+
+        switch (delivery) {
+            case UdpDelivery::RELIABLE:
+                return udpClient_->sendReliable(envelope, channel, false);
+            case UdpDelivery::RELIABLE_ORDERED:
+                return udpClient_->sendReliable(envelope, channel, true);
+            default:
+                return udpClient_->send(envelope);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Exception in udpPush operation: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+size_t MessagingChannelApi::udpPushMany(const std::vector<std::string>& messages,
+                                        const std::string& destination,
+                                        const std::string& sessionId,
+                                        EventType eventType) {
+    try {
+        EventMessageRequest request;
+        request.sessionId = sessionId;
+        request.type = eventType;
+        request.to = destination;
+        request.encrypted = false;
+
+        std::vector<UdpEnvelope> envelopes;
+        envelopes.reserve(messages.size());
+        for (const auto& message : messages) {
+            request.content = message;
+            envelopes.emplace_back("push", request.toJson());
+        }
+
+        return udpClient_->sendBatch(envelopes);
+    } catch (const std::exception& e) {
+        std::cerr << "Exception in udpPushMany operation: " << e.what() << std::endl;
+        return 0;
+    }
+}
+
+bool MessagingChannelApi::udpPushCoalesced(const std::string& message,
+                                           const std::string& destination,
+                                           const std::string& sessionId,
+                                           EventType eventType) {
+    try {
+        EventMessageRequest request;
+        request.sessionId = sessionId;
+        request.type = eventType;
+        request.to = destination;
+        request.content = message;
+        request.encrypted = false;
+
+        return udpClient_->pushCoalesced(request.toJson());
+    } catch (const std::exception& e) {
+        std::cerr << "Exception in udpPushCoalesced operation: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+bool MessagingChannelApi::udpFlush() {
+    return udpClient_->flush();
+}
+
+bool MessagingChannelApi::startUdpReceiver(UdpMessageCallback callback) {
+    return udpClient_->startReceiver(std::move(callback));
+}
+
+size_t MessagingChannelApi::udpReceive(std::vector<json>& messages, int timeoutMs) {
+    return udpClient_->receiveBatch(messages, timeoutMs);
+}
+
+void MessagingChannelApi::stopUdpReceiver() {
+    udpClient_->stopReceiver();
+}
+
+UdpEncoding MessagingChannelApi::negotiateUdpEncoding(int timeoutMs) {
+    return udpClient_->negotiateEncoding(timeoutMs);
+}
+
+bool MessagingChannelApi::startUdpClockSync() {
+    return udpClient_->startClockSync();
+}
+
+void MessagingChannelApi::stopUdpClockSync() {
+    udpClient_->stopClockSync();
+}
+
+int64_t MessagingChannelApi::serverNow() {
+    return udpClient_->serverNow();
+}
+
 EventMessageResult MessagingChannelApi::udpPull(const std::string& sessionId,
                                                const ReceiveConfig& config) {
     EventMessageResult result;
@@ -367,6 +601,67 @@ std::string MessagingChannelApi::getActionUrl(const std::string& action) const {
     return "/" + action;
 }
 
+void MessagingChannelApi::initLatencyStats() {
+    // One histogram set per action; the map is never modified afterwards
+    for (const char* action : {"connect", "pull", "push", "list-agents",
+                               "list-system-agents", "disconnect"}) {
+        latency_[action] = std::make_unique<ActionLatency>();
+    }
+}
+
+void MessagingChannelApi::recordLatency(const std::string& action, const HttpTimings& timings) {
+    // Requests that never started (e.g. pool timeout) carry no timings
+    auto it = latency_.find(action);
+    if (it == latency_.end() || timings.totalUs <= 0) {
+        return;
+    }
+    ActionLatency& latency = *it->second;
+    latency.namelookup.record(timings.namelookupUs);
+    latency.connect.record(timings.connectUs);
+    latency.appconnect.record(timings.appconnectUs);
+    latency.starttransfer.record(timings.starttransferUs);
+    latency.total.record(timings.totalUs);
+}
+
+std::map<std::string, ActionLatencyStats> MessagingChannelApi::getLatencyStats() const {
+    std::map<std::string, ActionLatencyStats> stats;
+    for (const auto& entry : latency_) {
+        ActionLatencyStats& action = stats[entry.first];
+        action.namelookup = entry.second->namelookup.snapshot();
+        action.connect = entry.second->connect.snapshot();
+        action.appconnect = entry.second->appconnect.snapshot();
+        action.starttransfer = entry.second->starttransfer.snapshot();
+        action.total = entry.second->total.snapshot();
+    }
+    return stats;
+}
+
+MessageReceiveRequest MessagingChannelApi::buildReceiveRequest(const std::string& sessionId,
+                                                               const ReceiveConfig& config) const {
+    MessageReceiveRequest request;
+    request.sessionId = sessionId;
+
+    // Apply default poll source if not specified in config
+    ReceiveConfig effectiveConfig = config;
+    if (effectiveConfig.pollSource.empty()) {
+        effectiveConfig.pollSource = defaultPollSource_;
+    }
+    request.receiveConfig = effectiveConfig;
+
+    return request;
+}
+
+EventMessageResult MessagingChannelApi::parseReceiveResult(const HttpClientResult& httpResult) {
+    if (httpResult.isHttpOk()) {
+        json responseJson = httpResult.dataAsJson();
+        if (responseJson.contains("data")) {
+            return EventMessageResult::fromJson(responseJson["data"]);
+        }
+    }
+
+    return EventMessageResult();
+}
+
 } // namespace messaging
 } // namespace hmdev
 
@@ -0,0 +1,40 @@
+#include "hmdev/messaging/api/receive_pipeline.h"
+#include "hmdev/messaging/api/messaging_channel_api.h"
+
+namespace hmdev {
+namespace messaging {
+
+ReceivePipeline::ReceivePipeline(MessagingChannelApi& api,
+                                 const std::string& sessionId,
+                                 const ReceiveConfig& config)
+    : api_(api), sessionId_(sessionId), config_(config),
+      startTime_(std::chrono::steady_clock::now()) {
+    inFlight_ = api_.receiveAsync(sessionId_, config_);
+}
+
+EventMessageResult ReceivePipeline::next() {
+    EventMessageResult result = inFlight_.get();
+
+    // Chain offsets before the caller sees the batch so the next pull overlaps processing
+    if (result.globalOffset >= 0 || result.localOffset >= 0) {
+        if (result.globalOffset >= 0) config_.globalOffset = result.globalOffset;
+        if (result.localOffset >= 0) config_.localOffset = result.localOffset;
+    } else {
+        stats_.failures++;
+    }
+    inFlight_ = api_.receiveAsync(sessionId_, config_);
+
+    stats_.batches++;
+    stats_.messages += result.messages.size() + result.ephemeralMessages.size();
+    return result;
+}
+
+ReceivePipelineStats ReceivePipeline::getStats() const {
+    ReceivePipelineStats stats = stats_;
+    stats.elapsedSec = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - startTime_).count();
+    return stats;
+}
+
+} // namespace messaging
+} // namespace hmdev
@@ -0,0 +1,341 @@
+#include "hmdev/messaging/util/reliable_udp.h"
+#include <algorithm>
+
+namespace hmdev {
+namespace messaging {
+
+static constexpr int ACK_BITS = 64;
+static constexpr int64_t CLOCK_GRANULARITY_US = 1000;
+static constexpr int MAX_BACKOFF_SHIFT = 16;
+
+ReliableUdpEndpoint::ReliableUdpEndpoint(const ReliableUdpConfig& config)
+    : config_(config), inFlight_(0), ackPending_(false), srttUs_(0), rttVarUs_(0),
+      rtoUs_(static_cast<int64_t>(config.initialRtoMs) * 1000) {
+}
+
+bool ReliableUdpEndpoint::prepare(json& datagram, uint8_t channel, bool ordered, Clock::time_point now) {
+    if (inFlight_ >= config_.maxInFlight) {
+        return false;
+    }
+
+    SendChannel& sendChannel = sendChannels_[channel];
+    uint64_t seq = sendChannel.nextSeq++;
+    uint64_t floor = sendChannel.inFlight.empty() ? seq : sendChannel.floor();
+    datagram["reliable"] = {{"channel", channel}, {"seq", seq}, {"ordered", ordered}, {"floor", floor}};
+
+    InFlight entry;
+    entry.datagram = datagram;
+    entry.lastSent = now;
+    entry.deadline = retransmitDeadline(now, 0);
+    entry.retransmits = 0;
+    sendChannel.inFlight.emplace(seq, std::move(entry));
+
+    inFlight_++;
+    stats_.sent++;
+    return true;
+}
+
+bool ReliableUdpEndpoint::isReliable(const json& datagram) {
+    if (!datagram.is_object()) {
+        return false;
+    }
+    if (datagram.contains("reliable")) {
+        return true;
+    }
+    auto action = datagram.find("action");
+    if (action == datagram.end() || !datagram.contains("payload") || !datagram["payload"].is_object()) {
+        return false;
+    }
+    return (*action == "ack" && datagram["payload"].contains("cumulative")) ||
+           (*action == "skip" && datagram["payload"].contains("floor"));
+}
+
+void ReliableUdpEndpoint::receive(json& datagram, Clock::time_point now, std::vector<json>& deliver) {
+    try {
+        if (datagram.contains("reliable")) {
+            receiveData(datagram, deliver);
+        } else if (datagram["action"] == "skip") {
+            receiveSkip(datagram["payload"], deliver);
+        } else {
+            receiveAck(datagram["payload"], now);
+        }
+    } catch (const json::exception&) {
+        // Malformed tag or acknowledgement from the peer; ignore the datagram
+    }
+}
+
+void ReliableUdpEndpoint::receiveData(json& datagram, std::vector<json>& deliver) {
+    const json& tag = datagram["reliable"];
+    uint8_t channel = tag.at("channel").get<uint8_t>();
+    uint64_t seq = tag.at("seq").get<uint64_t>();
+    bool ordered = tag.value("ordered", true);
+    uint64_t floor = tag.value("floor", static_cast<uint64_t>(0));
+    if (seq == 0 || floor > seq) {
+        return;
+    }
+
+    // Acknowledge duplicates too: the earlier acknowledgement may have been lost
+    ReceiveChannel& receiveChannel = receiveChannels_[channel];
+    receiveChannel.ackPending = true;
+    ackPending_ = true;
+    advanceFloor(receiveChannel, floor, deliver);
+
+    if (seq <= receiveChannel.cumulative || receiveChannel.above.count(seq) != 0) {
+        stats_.duplicates++;
+        return;
+    }
+
+    // Leave it unacknowledged when the buffer is full; the retransmission finds room once the gap fills
+    if (seq != receiveChannel.cumulative + 1 && receiveChannel.above.size() >= config_.maxReorderBuffer) {
+        stats_.overflows++;
+        return;
+    }
+    receiveChannel.highest = std::max(receiveChannel.highest, seq);
+    datagram.erase("reliable");
+
+    if (ordered) {
+        receiveChannel.above.emplace(seq, std::move(datagram));
+    } else {
+        stats_.delivered++;
+        deliver.push_back(std::move(datagram));
+        receiveChannel.above.emplace(seq, json());
+    }
+
+    deliverInOrder(receiveChannel, deliver);
+}
+
+void ReliableUdpEndpoint::receiveSkip(const json& payload, std::vector<json>& deliver) {
+    uint8_t channel = payload.at("channel").get<uint8_t>();
+    uint64_t floor = payload.at("floor").get<uint64_t>();
+
+    // Always answer so the sender learns the new cumulative sequence number
+    ReceiveChannel& receiveChannel = receiveChannels_[channel];
+    receiveChannel.ackPending = true;
+    ackPending_ = true;
+    advanceFloor(receiveChannel, floor, deliver);
+    deliverInOrder(receiveChannel, deliver);
+}
+
+void ReliableUdpEndpoint::deliverInOrder(ReceiveChannel& receiveChannel, std::vector<json>& deliver) {
+    while (!receiveChannel.above.empty() &&
+           receiveChannel.above.begin()->first == receiveChannel.cumulative + 1) {
+        auto it = receiveChannel.above.begin();
+        receiveChannel.cumulative++;
+        if (!it->second.is_null()) {
+            stats_.delivered++;
+            deliver.push_back(std::move(it->second));
+        }
+        receiveChannel.above.erase(it);
+    }
+}
+
+void ReliableUdpEndpoint::advanceFloor(ReceiveChannel& receiveChannel, uint64_t floor,
+                                       std::vector<json>& deliver) {
+    if (floor <= receiveChannel.cumulative + 1) {
+        return;
+    }
+
+    // The sender no longer retransmits anything below its floor: deliver what arrived, pass over the rest
+    while (!receiveChannel.above.empty() && receiveChannel.above.begin()->first < floor) {
+        auto it = receiveChannel.above.begin();
+        stats_.skipped += it->first - receiveChannel.cumulative - 1;
+        receiveChannel.cumulative = it->first;
+        if (!it->second.is_null()) {
+            stats_.delivered++;
+            deliver.push_back(std::move(it->second));
+        }
+        receiveChannel.above.erase(it);
+    }
+    stats_.skipped += floor - 1 - receiveChannel.cumulative;
+    receiveChannel.cumulative = floor - 1;
+    receiveChannel.highest = std::max(receiveChannel.highest, receiveChannel.cumulative);
+}
+
+void ReliableUdpEndpoint::receiveAck(const json& payload, Clock::time_point now) {
+    uint8_t channel = payload.at("channel").get<uint8_t>();
+    uint64_t cumulative = payload.at("cumulative").get<uint64_t>();
+    uint64_t highest = payload.value("ack", static_cast<uint64_t>(0));
+    uint64_t bits = payload.value("ackBits", static_cast<uint64_t>(0));
+
+    auto found = sendChannels_.find(channel);
+    if (found == sendChannels_.end()) {
+        return;
+    }
+    SendChannel& sendChannel = found->second;
+    sendChannel.peerCumulative = std::max(sendChannel.peerCumulative, cumulative);
+
+    // Karn's rule: only never-retransmitted messages give RTT samples; use the newest
+    bool sampled = false;
+    Clock::time_point newestSent;
+    auto acknowledgeEntry = [&](std::map<uint64_t, InFlight>::iterator it) {
+        if (it->second.retransmits == 0 && (!sampled || it->second.lastSent > newestSent)) {
+            newestSent = it->second.lastSent;
+            sampled = true;
+        }
+        stats_.acked++;
+        inFlight_--;
+        return sendChannel.inFlight.erase(it);
+    };
+
+    for (auto it = sendChannel.inFlight.begin();
+         it != sendChannel.inFlight.end() && it->first <= cumulative;) {
+        it = acknowledgeEntry(it);
+    }
+
+    if (highest > cumulative) {
+        auto it = sendChannel.inFlight.find(highest);
+        if (it != sendChannel.inFlight.end()) {
+            acknowledgeEntry(it);
+        }
+        for (int i = 0; i < ACK_BITS && static_cast<uint64_t>(i) + 1 < highest; i++) {
+            uint64_t seq = highest - 1 - static_cast<uint64_t>(i);
+            if (seq <= cumulative) {
+                break;
+            }
+            if ((bits >> i) & 1) {
+                it = sendChannel.inFlight.find(seq);
+                if (it != sendChannel.inFlight.end()) {
+                    acknowledgeEntry(it);
+                }
+            }
+        }
+    }
+
+    if (sampled) {
+        updateRto(std::chrono::duration_cast<std::chrono::microseconds>(now - newestSent).count());
+    }
+
+    // The peer has passed every message given up on
+    if (sendChannel.skipPending && sendChannel.peerCumulative + 1 >= sendChannel.floor()) {
+        sendChannel.skipPending = false;
+    }
+}
+
+void ReliableUdpEndpoint::poll(Clock::time_point now, std::vector<json>& outgoing) {
+    if (ackPending_) {
+        for (auto& entry : receiveChannels_) {
+            ReceiveChannel& receiveChannel = entry.second;
+            if (!receiveChannel.ackPending) {
+                continue;
+            }
+
+            uint64_t bits = 0;
+            for (int i = 0; i < ACK_BITS && static_cast<uint64_t>(i) + 1 < receiveChannel.highest; i++) {
+                uint64_t seq = receiveChannel.highest - 1 - static_cast<uint64_t>(i);
+                if (seq <= receiveChannel.cumulative) {
+                    break;
+                }
+                if (receiveChannel.above.count(seq) != 0) {
+                    bits |= static_cast<uint64_t>(1) << i;
+                }
+            }
+
+            outgoing.push_back(json{
+                {"action", "ack"},
+                {"payload", {
+                    {"channel", entry.first},
+                    {"cumulative", receiveChannel.cumulative},
+                    {"ack", receiveChannel.highest},
+                    {"ackBits", bits}
+                }}
+            });
+            receiveChannel.ackPending = false;
+            stats_.acksSent++;
+        }
+        ackPending_ = false;
+    }
+
+    for (auto& entry : sendChannels_) {
+        SendChannel& sendChannel = entry.second;
+        auto& inFlight = sendChannel.inFlight;
+        for (auto it = inFlight.begin(); it != inFlight.end();) {
+            InFlight& message = it->second;
+            if (message.deadline > now) {
+                ++it;
+                continue;
+            }
+            if (message.retransmits >= config_.maxRetransmits) {
+                stats_.failed++;
+                inFlight_--;
+                it = inFlight.erase(it);
+                sendChannel.skipPending = true;
+                sendChannel.skipDeadline = now;
+                sendChannel.skipNotices = 0;
+                continue;
+            }
+            message.retransmits++;
+            message.lastSent = now;
+            message.deadline = retransmitDeadline(now, message.retransmits);
+            message.datagram["reliable"]["floor"] = sendChannel.floor();
+            outgoing.push_back(message.datagram);
+            stats_.retransmits++;
+            ++it;
+        }
+
+        // Tell the peer to stop waiting for given-up messages; repeated like a retransmission
+        if (sendChannel.skipPending && sendChannel.skipDeadline <= now) {
+            if (sendChannel.peerCumulative + 1 >= sendChannel.floor() ||
+                sendChannel.skipNotices > config_.maxRetransmits) {
+                sendChannel.skipPending = false;
+                continue;
+            }
+            outgoing.push_back(json{
+                {"action", "skip"},
+                {"payload", {{"channel", entry.first}, {"floor", sendChannel.floor()}}}
+            });
+            sendChannel.skipDeadline = retransmitDeadline(now, sendChannel.skipNotices);
+            sendChannel.skipNotices++;
+        }
+    }
+}
+
+ReliableUdpEndpoint::Clock::time_point ReliableUdpEndpoint::nextDeadline() const {
+    if (ackPending_) {
+        return Clock::time_point();
+    }
+
+    Clock::time_point earliest = Clock::time_point::max();
+    for (const auto& entry : sendChannels_) {
+        for (const auto& message : entry.second.inFlight) {
+            earliest = std::min(earliest, message.second.deadline);
+        }
+        if (entry.second.skipPending) {
+            earliest = std::min(earliest, entry.second.skipDeadline);
+        }
+    }
+    return earliest;
+}
+
+ReliableUdpStats ReliableUdpEndpoint::getStats() const {
+    ReliableUdpStats stats = stats_;
+    stats.inFlight = inFlight_;
+    stats.srttUs = srttUs_;
+    stats.rtoUs = rtoUs_;
+    return stats;
+}
+
+void ReliableUdpEndpoint::updateRto(int64_t sampleUs) {
+    // RFC 6298 section 2
+    if (srttUs_ == 0) {
+        srttUs_ = sampleUs;
+        rttVarUs_ = sampleUs / 2;
+    } else {
+        int64_t deviation = srttUs_ > sampleUs ? srttUs_ - sampleUs : sampleUs - srttUs_;
+        rttVarUs_ = (3 * rttVarUs_ + deviation) / 4;
+        srttUs_ = (7 * srttUs_ + sampleUs) / 8;
+    }
+
+    int64_t rto = srttUs_ + std::max(CLOCK_GRANULARITY_US, 4 * rttVarUs_);
+    rtoUs_ = std::min(std::max(rto, static_cast<int64_t>(config_.minRtoMs) * 1000),
+                      static_cast<int64_t>(config_.maxRtoMs) * 1000);
+}
+
+ReliableUdpEndpoint::Clock::time_point ReliableUdpEndpoint::retransmitDeadline(Clock::time_point sent,
+                                                                                int retransmits) const {
+    int64_t timeout = rtoUs_ << std::min(retransmits, MAX_BACKOFF_SHIFT);
+    timeout = std::min(timeout, static_cast<int64_t>(config_.maxRtoMs) * 1000);
+    return sent + std::chrono::microseconds(timeout);
+}
+
+} // namespace messaging
+} // namespace hmdev
@@ -0,0 +1,296 @@
+#include "hmdev/messaging/util/state_delta.h"
+#include <algorithm>
+#include <vector>
+
+namespace hmdev {
+namespace messaging {
+
+StateDeltaEncoder::StateDeltaEncoder(const StateDeltaConfig& config)
+    : config_(config), sequence_(0), forceFull_(false), tickFull_(false), tickRawBytes_(0),
+      totalEncodeUs_(0.0) {
+    config_.historySize = std::max<size_t>(2, config_.historySize);
+    config_.maxPeers = std::max<size_t>(1, config_.maxPeers);
+}
+
+uint64_t StateDeltaEncoder::commit(const json& state) {
+    auto start = Clock::now();
+    history_.push_back(state);
+    if (history_.size() > config_.historySize) {
+        history_.pop_front();
+    }
+    sequence_++;
+
+    bool keyframe = config_.keyframeInterval > 0 && sequence_ % config_.keyframeInterval == 0;
+    tickFull_ = forceFull_ || keyframe;
+    forceFull_ = false;
+    tickRawBytes_ = state.dump().size();
+    tickEncodings_.clear();
+
+    double encodeUs = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+    totalEncodeUs_ += encodeUs;
+    stats_.ticks++;
+    stats_.lastEncodeUs = encodeUs;
+    return sequence_;
+}
+
+std::string StateDeltaEncoder::encode(const json& state, Clock::time_point now) {
+    commit(state);
+    auto start = Clock::now();
+
+    uint64_t baseline = 0;
+    if (!tickFull_) {
+        chooseBaseline(now, baseline);
+    }
+    std::string content = encodeAgainst(baseline);
+
+    double encodeUs = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+    totalEncodeUs_ += encodeUs;
+    stats_.lastEncodeUs += encodeUs;
+    return content;
+}
+
+std::string StateDeltaEncoder::encodeFor(const std::string& peer, Clock::time_point now) {
+    if (sequence_ == 0) {
+        return std::string();
+    }
+    auto start = Clock::now();
+
+    // The newest state in history the receiver has decoded
+    uint64_t baseline = 0;
+    auto found = peers_.find(peer);
+    if (!tickFull_ && found != peers_.end() && isLive(found->second, now)) {
+        for (uint64_t age = 1; age < history_.size(); age++) {
+            if (found->second.has(sequence_ - age)) {
+                baseline = sequence_ - age;
+                break;
+            }
+        }
+    }
+    std::string content = encodeAgainst(baseline);
+
+    double encodeUs = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+    totalEncodeUs_ += encodeUs;
+    stats_.lastEncodeUs += encodeUs;
+    return content;
+}
+
+bool StateDeltaEncoder::Peer::has(uint64_t sequence) const {
+    if (acked == 0 || sequence == 0 || sequence > acked) {
+        return false;
+    }
+    uint64_t age = acked - sequence;
+    return age == 0 || (age <= 64 && (mask >> (age - 1)) & 1);
+}
+
+bool StateDeltaEncoder::acknowledge(const std::string& peer, uint64_t sequence, uint64_t mask,
+                                    Clock::time_point now) {
+    if (sequence > sequence_) {
+        return false;
+    }
+
+    auto found = peers_.find(peer);
+    if (found == peers_.end()) {
+        if (peers_.size() >= config_.maxPeers) {
+            auto silent = std::min_element(peers_.begin(), peers_.end(),
+                                           [](const std::pair<const std::string, Peer>& a,
+                                              const std::pair<const std::string, Peer>& b) {
+                                               return a.second.lastAck < b.second.lastAck;
+                                           });
+            peers_.erase(silent);
+        }
+        found = peers_.emplace(peer, Peer{0, 0, now}).first;
+    }
+
+    // Acknowledgements are cumulative; a reordered older one says nothing new
+    Peer& state = found->second;
+    if (sequence != 0 && sequence < state.acked) {
+        state.lastAck = now;
+        return true;
+    }
+    state.acked = sequence;
+    state.mask = mask;
+    state.lastAck = now;
+    stats_.acks++;
+    if (sequence != 0 && !baselineState(sequence)) {
+        stats_.staleAcks++;
+    }
+    return true;
+}
+
+bool StateDeltaEncoder::acknowledge(const std::string& peer, const std::string& content, Clock::time_point now) {
+    json ack = json::parse(content, nullptr, false);
+    if (ack.is_discarded() || !ack.is_object() || !ack.contains("stateAck") ||
+        !ack["stateAck"].is_number_unsigned()) {
+        return false;
+    }
+    uint64_t mask = ack.contains("mask") && ack["mask"].is_number_unsigned() ? ack["mask"].get<uint64_t>() : 0;
+    return acknowledge(peer, ack["stateAck"].get<uint64_t>(), mask, now);
+}
+
+StateDeltaStats StateDeltaEncoder::getStats(Clock::time_point now) const {
+    StateDeltaStats stats = stats_;
+    stats.compressionRatio = stats.encodedBytes > 0
+        ? static_cast<double>(stats.rawBytes) / static_cast<double>(stats.encodedBytes) : 0.0;
+    stats.meanEncodeUs = stats.ticks > 0 ? totalEncodeUs_ / static_cast<double>(stats.ticks) : 0.0;
+    for (const auto& entry : peers_) {
+        stats.peers += isLive(entry.second, now) ? 1 : 0;
+    }
+    return stats;
+}
+
+json StateDeltaEncoder::diff(const json& from, const json& to) {
+    if (!from.is_object() || !to.is_object()) {
+        return to;
+    }
+
+    json patch = json::object();
+    for (auto it = from.begin(); it != from.end(); ++it) {
+        if (!to.contains(it.key())) {
+            patch[it.key()] = nullptr;
+        }
+    }
+    for (auto it = to.begin(); it != to.end(); ++it) {
+        auto previous = from.find(it.key());
+        if (previous == from.end()) {
+            patch[it.key()] = it.value();
+        } else if (*previous != it.value()) {
+            patch[it.key()] = diff(*previous, it.value());
+        }
+    }
+    return patch;
+}
+
+const json* StateDeltaEncoder::baselineState(uint64_t sequence) const {
+    // history_.back() is sequence_
+    if (sequence == 0 || sequence > sequence_ || sequence_ - sequence >= history_.size()) {
+        return nullptr;
+    }
+    return &history_[history_.size() - 1 - (sequence_ - sequence)];
+}
+
+bool StateDeltaEncoder::isLive(const Peer& peer, Clock::time_point now) const {
+    return now - peer.lastAck < std::chrono::milliseconds(config_.peerTimeoutMs);
+}
+
+bool StateDeltaEncoder::chooseBaseline(Clock::time_point now, uint64_t& baseline) const {
+    std::vector<const Peer*> live;
+    for (const auto& entry : peers_) {
+        if (isLive(entry.second, now)) {
+            if (entry.second.acked == 0) {
+                return false;
+            }
+            live.push_back(&entry.second);
+        }
+    }
+    if (live.empty()) {
+        return false;
+    }
+
+    // The newest state in history every live receiver has decoded
+    for (uint64_t age = 1; age < history_.size(); age++) {
+        baseline = sequence_ - age;
+        if (std::all_of(live.begin(), live.end(), [&](const Peer* peer) { return peer->has(baseline); })) {
+            return true;
+        }
+    }
+    baseline = 0;
+    return false;
+}
+
+const std::string& StateDeltaEncoder::encodeAgainst(uint64_t baseline) {
+    auto cached = tickEncodings_.find(baseline);
+    if (cached == tickEncodings_.end()) {
+        Encoding encoding;
+        if (baseline != 0) {
+            json delta = {{"s", sequence_}, {"b", baseline}, {"d", diff(*baselineState(baseline), history_.back())}};
+            encoding.content = delta.dump();
+        }
+
+        // A delta is only worth it when smaller than the state it replaces
+        encoding.full = baseline == 0 || encoding.content.size() >= tickRawBytes_ + 16;
+        if (encoding.full) {
+            auto full = tickEncodings_.find(0);
+            if (full == tickEncodings_.end()) {
+                Encoding snapshot;
+                snapshot.content = json{{"s", sequence_}, {"f", history_.back()}}.dump();
+                snapshot.full = true;
+                full = tickEncodings_.emplace(0, std::move(snapshot)).first;
+            }
+            encoding = full->second;
+        }
+        cached = tickEncodings_.emplace(baseline, std::move(encoding)).first;
+    }
+
+    const Encoding& encoding = cached->second;
+    if (encoding.full) {
+        stats_.fullSnapshots++;
+    } else {
+        stats_.deltas++;
+    }
+    stats_.rawBytes += tickRawBytes_;
+    stats_.encodedBytes += encoding.content.size();
+    stats_.lastRawBytes = tickRawBytes_;
+    stats_.lastEncodedBytes = encoding.content.size();
+    return encoding.content;
+}
+
+StateDeltaDecoder::StateDeltaDecoder(size_t historySize)
+    : historySize_(std::max<size_t>(1, historySize)), lastSequence_(0), needsFull_(false) {}
+
+bool StateDeltaDecoder::isEncoded(const std::string& content) {
+    json encoded = json::parse(content, nullptr, false);
+    return encoded.is_object() && encoded.contains("s") && (encoded.contains("f") || encoded.contains("d"));
+}
+
+bool StateDeltaDecoder::decode(const std::string& content, json& state) {
+    json encoded = json::parse(content, nullptr, false);
+    if (encoded.is_discarded() || !encoded.is_object() || !encoded.contains("s") ||
+        !encoded["s"].is_number_unsigned() || encoded["s"].get<uint64_t>() == 0) {
+        stats_.malformed++;
+        return false;
+    }
+    uint64_t sequence = encoded["s"].get<uint64_t>();
+
+    if (encoded.contains("f")) {
+        state = std::move(encoded["f"]);
+        needsFull_ = false;
+        stats_.fullSnapshots++;
+    } else if (encoded.contains("b") && encoded["b"].is_number_unsigned() && encoded.contains("d")) {
+        auto baseline = history_.find(encoded["b"].get<uint64_t>());
+        if (baseline == history_.end()) {
+            needsFull_ = true;
+            stats_.missingBaselines++;
+            return false;
+        }
+        state = baseline->second;
+        state.merge_patch(encoded["d"]);
+        stats_.deltas++;
+    } else {
+        stats_.malformed++;
+        return false;
+    }
+
+    history_[sequence] = state;
+    while (history_.size() > historySize_) {
+        history_.erase(history_.begin());
+    }
+    lastSequence_ = std::max(lastSequence_, sequence);
+    return true;
+}
+
+std::string StateDeltaDecoder::ack() const {
+    if (needsFull_) {
+        return json{{"stateAck", 0}, {"mask", 0}}.dump();
+    }
+    uint64_t mask = 0;
+    for (const auto& entry : history_) {
+        uint64_t age = lastSequence_ - entry.first;
+        if (age >= 1 && age <= 64) {
+            mask |= uint64_t(1) << (age - 1);
+        }
+    }
+    return json{{"stateAck", lastSequence_}, {"mask", mask}}.dump();
+}
+
+} // namespace messaging
+} // namespace hmdev
@@ -1,142 +1,1201 @@
 #include "hmdev/messaging/api/udp_client.h"
+#include "hmdev/messaging/util/udp_codec.h"
+#include "hmdev/messaging/util/udp_fragmentation.h"
+#include "hmdev/messaging/util/reliable_udp.h"
 #include <sys/socket.h>
 #include <netinet/in.h>
+#include <netinet/udp.h>
 #include <arpa/inet.h>
 #include <netdb.h>
 #include <unistd.h>
+#include <cerrno>
 #include <cstring>
 #include <stdexcept>
-#include <sys/select.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/uio.h>
+#include <linux/net_tstamp.h>
+#include <linux/errqueue.h>
+#include <time.h>
+#include <poll.h>
+#include <algorithm>
+#include <iostream>
+#include <random>
+
+// UDP offload options, missing from older C library headers (Linux 4.18 / 5.0)
+#ifndef SOL_UDP
+#define SOL_UDP 17
+#endif
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103
+#endif
+#ifndef UDP_GRO
+#define UDP_GRO 104
+#endif
 
 namespace hmdev {
 namespace messaging {
 
-UdpClient::UdpClient(const std::string& host, int port)
-    : host_(host), port_(port), socketFd_(-1), isOpen_(false) {
+// Kernel limits of one UDP_SEGMENT message: segment count and total payload
+static constexpr size_t MAX_SEGMENTS = 64;
+static constexpr size_t MAX_SEGMENTED_BYTES = 65000;
+
+// Wait after a failed lookup before sends try again; the connected socket stays in use meanwhile
+static constexpr int RESOLVE_RETRY_MS = 1000;
+
+// Control space per received message: UDP_GRO size, timestamps and SO_RXQ_OVFL count
+static constexpr size_t RECEIVE_CONTROL_SIZE =
+    CMSG_SPACE(sizeof(int)) + CMSG_SPACE(sizeof(struct scm_timestamping)) + CMSG_SPACE(sizeof(uint32_t));
+
+static int64_t toNanoseconds(const struct timespec& time) {
+    return static_cast<int64_t>(time.tv_sec) * 1000000000LL + time.tv_nsec;
+}
+
+UdpClient::UdpClient(const std::string& host, int port, const UdpClientConfig& config)
+    : host_(host), port_(port), config_(config), socketFd_(-1), isOpen_(false),
+      needsResolve_(false), socketGeneration_(0), wakeFd_(-1), segmentOffloadFd_(-1),
+      receiveOffloadFd_(-1), timestampFd_(-1), dropCountFd_(-1), dropCountSocket_(-1), dropCountSeen_(0),
+      kernelDrops_(0), receiveBufferSize_(0), sendBufferSize_(0), reassembler_(config.reassembly),
+      readerActive_(false), nextRequestId_(1), receiverRunning_(false),
+      activeEncoding_(UdpEncoding::JSON), fragmentsSent_(0), reliable_(config.reliability),
+      coalescer_(config.coalescing), clockSync_(config.clockSync) {
+    std::memset(&serverAddr_, 0, sizeof(serverAddr_));
+
+    // Random start so a restarted client does not collide with fragments the server still holds
+    std::random_device seed;
+    nextMessageId_ = seed();
 }
 
 UdpClient::~UdpClient() {
+    stopReceiver();
     close();
 }
 
-void UdpClient::ensureSocketOpen() {
-    if (isOpen_) {
-        return;
+bool UdpClient::resolveDueLocked() const {
+    auto now = std::chrono::steady_clock::now();
+    bool expired = config_.resolveTtlMs > 0 &&
+                   now - resolvedAt_ > std::chrono::milliseconds(config_.resolveTtlMs);
+    if (isOpen_ && !needsResolve_ && !expired) {
+        return false;
+    }
+    return now >= resolveRetryAt_;
+}
+
+int UdpClient::connectedSocket() {
+    std::unique_lock<std::mutex> resolveLock(resolveMutex_, std::defer_lock);
+    {
+        std::lock_guard<std::mutex> lock(socketMutex_);
+        if (!resolveDueLocked()) {
+            return socketFd_;
+        }
+        // An open socket keeps serving sends while another thread looks the host up
+        if (isOpen_ && !resolveLock.try_lock()) {
+            return socketFd_;
+        }
     }
 
-    // Create UDP socket
-    socketFd_ = socket(AF_INET, SOCK_DGRAM, 0);
-    if (socketFd_ < 0) {
-        throw std::runtime_error("Failed to create UDP socket");
+    if (!resolveLock.owns_lock()) {
+        // Nothing to send on yet: wait for a lookup in progress, which may make ours unnecessary
+        resolveLock.lock();
+        std::lock_guard<std::mutex> lock(socketMutex_);
+        if (!resolveDueLocked()) {
+            return socketFd_;
+        }
     }
 
-    isOpen_ = true;
+    // A failed re-resolve keeps the previous connection usable
+    lookupAndConnect();
+    std::lock_guard<std::mutex> lock(socketMutex_);
+    return socketFd_;
 }
 
-bool UdpClient::send(const UdpEnvelope& envelope) {
-    try {
-        ensureSocketOpen();
+bool UdpClient::resolve() {
+    std::lock_guard<std::mutex> resolveLock(resolveMutex_);
+    return lookupAndConnect();
+}
 
-        // Serialize envelope to JSON
-        std::string jsonStr = envelope.toJson().dump();
+bool UdpClient::lookupAndConnect() {
+    struct addrinfo hints;
+    std::memset(&hints, 0, sizeof(hints));
+    hints.ai_family = config_.addressFamily;
+    hints.ai_socktype = SOCK_DGRAM;
+    hints.ai_flags = AI_ADDRCONFIG;
 
-        // Resolve hostname
-        struct hostent* server = gethostbyname(host_.c_str());
-        if (server == nullptr) {
-            return false;
+    // getaddrinfo may block for seconds, so it runs without socketMutex_ held
+    std::string service = std::to_string(port_);
+    struct addrinfo* results = nullptr;
+    if (getaddrinfo(host_.c_str(), service.c_str(), &hints, &results) != 0) {
+        results = nullptr;
+    }
+
+    bool connected = false;
+    {
+        std::lock_guard<std::mutex> lock(socketMutex_);
+        connected = results != nullptr && connectLocked(results);
+        if (!connected) {
+            resolveRetryAt_ = std::chrono::steady_clock::now() + std::chrono::milliseconds(RESOLVE_RETRY_MS);
+        }
+    }
+    if (results != nullptr) {
+        freeaddrinfo(results);
+    }
+    return connected;
+}
+
+bool UdpClient::connectLocked(const struct addrinfo* results) {
+    // Connect to the first usable address in resolver order (RFC 6724 prefers IPv6)
+    bool connected = false;
+    for (const struct addrinfo* ai = results; ai != nullptr && !connected; ai = ai->ai_next) {
+        int fd = socketFd_;
+        bool reuse = isOpen_ && serverAddr_.ss_family == ai->ai_family;
+        if (!reuse) {
+            fd = socket(ai->ai_family, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+            if (fd < 0) {
+                continue;
+            }
         }
 
-        // Setup server address
-        struct sockaddr_in serverAddr;
-        std::memset(&serverAddr, 0, sizeof(serverAddr));
-        serverAddr.sin_family = AF_INET;
-        std::memcpy(&serverAddr.sin_addr.s_addr, server->h_addr, server->h_length);
-        serverAddr.sin_port = htons(port_);
+        // Re-connecting an existing UDP socket just changes its peer
+        if (::connect(fd, ai->ai_addr, ai->ai_addrlen) != 0) {
+            if (!reuse) {
+                ::close(fd);
+            }
+            continue;
+        }
 
-        // Send data
-        ssize_t sent = sendto(socketFd_, jsonStr.c_str(), jsonStr.length(), 0,
-                             reinterpret_cast<struct sockaddr*>(&serverAddr),
-                             sizeof(serverAddr));
+        if (!reuse) {
+            ring_.reset();
+            if (socketFd_ >= 0) {
+                ::close(socketFd_);
+            }
+            if (config_.backend == UdpBackend::IO_URING) {
+                ring_ = UdpIoUring::create(fd, config_.ioUring);  // Null: fall back to socket calls
+            }
+            if (!ring_) {
+                configureOffloadLocked(fd);
+            }
+            configureSocketLocked(fd, !ring_);
+            socketGeneration_++;
+            wakeReceiverLocked();
+        }
+        socketFd_ = fd;
+        std::memcpy(&serverAddr_, ai->ai_addr, ai->ai_addrlen);
+        connected = true;
+    }
 
-        return sent > 0;
+    if (connected) {
+        isOpen_ = true;
+        needsResolve_ = false;
+        resolvedAt_ = std::chrono::steady_clock::now();
+    }
+    return connected;
+}
+
+void UdpClient::configureOffloadLocked(int fd) {
+    segmentOffloadFd_ = -1;
+    receiveOffloadFd_ = -1;
+
+    // UDP_SEGMENT is set per message; a readable option means the kernel knows it
+    int value = 0;
+    socklen_t length = sizeof(value);
+    if (config_.segmentOffload && getsockopt(fd, SOL_UDP, UDP_SEGMENT, &value, &length) == 0) {
+        segmentOffloadFd_ = fd;
+    }
+
+    value = 1;
+    if (config_.receiveOffload && setsockopt(fd, SOL_UDP, UDP_GRO, &value, sizeof(value)) == 0) {
+        receiveOffloadFd_ = fd;
+    }
+}
+
+void UdpClient::configureSocketLocked(int fd, bool control) {
+    // The FORCE variants exceed rmem_max/wmem_max but need CAP_NET_ADMIN
+    if (config_.receiveBufferSize > 0 &&
+        setsockopt(fd, SOL_SOCKET, SO_RCVBUFFORCE, &config_.receiveBufferSize, sizeof(int)) != 0) {
+        setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &config_.receiveBufferSize, sizeof(int));
+    }
+    if (config_.sendBufferSize > 0 &&
+        setsockopt(fd, SOL_SOCKET, SO_SNDBUFFORCE, &config_.sendBufferSize, sizeof(int)) != 0) {
+        setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &config_.sendBufferSize, sizeof(int));
+    }
+
+    // The kernel doubles the request for its bookkeeping and caps it; report what it granted
+    int size = 0;
+    socklen_t length = sizeof(size);
+    receiveBufferSize_ = getsockopt(fd, SOL_SOCKET, SO_RCVBUF, &size, &length) == 0 ? size : 0;
+    length = sizeof(size);
+    sendBufferSize_ = getsockopt(fd, SOL_SOCKET, SO_SNDBUF, &size, &length) == 0 ? size : 0;
+
+    // Timestamps and overflow counts arrive as control messages, which io_uring receives drop
+    timestampFd_ = -1;
+    dropCountFd_ = -1;
+    if (!control) {
+        return;
+    }
+
+    int enabled = 1;
+    if (config_.timestamping == UdpTimestamping::SOFTWARE) {
+        if (setsockopt(fd, SOL_SOCKET, SO_TIMESTAMPNS, &enabled, sizeof(enabled)) == 0) {
+            timestampFd_ = fd;
+        }
+    } else if (config_.timestamping == UdpTimestamping::HARDWARE) {
+        // Hardware stamps also need the NIC switched on (SIOCSHWTSTAMP); software stamps always come
+        int flags = SOF_TIMESTAMPING_RX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE |
+                    SOF_TIMESTAMPING_RX_HARDWARE | SOF_TIMESTAMPING_RAW_HARDWARE;
+        if (setsockopt(fd, SOL_SOCKET, SO_TIMESTAMPING, &flags, sizeof(flags)) == 0) {
+            timestampFd_ = fd;
+        }
+    }
+
+    if (config_.countKernelDrops && setsockopt(fd, SOL_SOCKET, SO_RXQ_OVFL, &enabled, sizeof(enabled)) == 0) {
+        dropCountFd_ = fd;
+    }
+}
+
+void UdpClient::handleSendError(int error) {
+    // ICMP unreachable is reported on connected sockets; the address may have moved
+    if (error == ECONNREFUSED || error == EHOSTUNREACH || error == ENETUNREACH ||
+        error == EDESTADDRREQ || error == EADDRNOTAVAIL) {
+        std::lock_guard<std::mutex> lock(socketMutex_);
+        needsResolve_ = true;
+    }
+}
+
+bool UdpClient::send(const UdpEnvelope& envelope) {
+    try {
+        int fd = connectedSocket();
+        if (fd < 0) {
+            return false;
+        }
+
+        std::vector<std::string> datagrams;
+        size_t count = encodeDatagrams(envelope.toJson(), activeEncoding_, datagrams, 0);
+        return count > 0 && sendEncoded(fd, datagrams, count);
     } catch (const std::exception& e) {
         return false;
     }
 }
 
 json UdpClient::sendAndWait(const UdpEnvelope& envelope, int timeoutMs) {
-    try {
-        ensureSocketOpen();
+    return sendRequest(envelope.toJson(), activeEncoding_, timeoutMs);
+}
+
+UdpEncoding UdpClient::negotiateEncoding(int timeoutMs) {
+    if (config_.encoding == UdpEncoding::JSON) {
+        return activeEncoding_;
+    }
 
-        // Serialize envelope to JSON
-        std::string jsonStr = envelope.toJson().dump();
+    // Offered in JSON, which every server understands; no reply keeps JSON
+    json hello = {
+        {"action", "hello"},
+        {"payload", {{"encodings", {udpEncodingToString(config_.encoding), "json"}}}}
+    };
+    json reply = sendRequest(hello, UdpEncoding::JSON, timeoutMs);
+
+    UdpEncoding accepted;
+    if (reply.is_object() && reply.contains("encoding") && reply["encoding"].is_string() &&
+        stringToUdpEncoding(reply["encoding"].get<std::string>(), accepted)) {
+        activeEncoding_ = accepted;
+    }
+    return activeEncoding_;
+}
+
+UdpEncoding UdpClient::getEncoding() const {
+    return activeEncoding_;
+}
 
-        // Resolve hostname
-        struct hostent* server = gethostbyname(host_.c_str());
-        if (server == nullptr) {
+json UdpClient::sendRequest(json request, UdpEncoding encoding, int timeoutMs) {
+    try {
+        int fd = connectedSocket();
+        if (fd < 0) {
             return nullptr;
         }
 
-        // Setup server address
-        struct sockaddr_in serverAddr;
-        std::memset(&serverAddr, 0, sizeof(serverAddr));
-        serverAddr.sin_family = AF_INET;
-        std::memcpy(&serverAddr.sin_addr.s_addr, server->h_addr, server->h_length);
-        serverAddr.sin_port = htons(port_);
+        // Tag the request so its reply can be told apart from late replies to earlier ones
+        std::string requestId = std::to_string(nextRequestId_.fetch_add(1));
+        request["requestId"] = requestId;
+        std::vector<std::string> datagrams;
+        size_t count = encodeDatagrams(request, encoding, datagrams, 0);
 
-        // Send data
-        ssize_t sent = sendto(socketFd_, jsonStr.c_str(), jsonStr.length(), 0,
-                             reinterpret_cast<struct sockaddr*>(&serverAddr),
-                             sizeof(serverAddr));
+        auto entry = std::make_shared<PendingRequest>();
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+        {
+            std::lock_guard<std::mutex> lock(pendingMutex_);
+            pending_[requestId] = entry;
+        }
 
-        if (sent <= 0) {
+        if (count == 0 || !sendEncoded(fd, datagrams, count)) {
+            std::lock_guard<std::mutex> lock(pendingMutex_);
+            pending_.erase(requestId);
             return nullptr;
         }
 
-        // Wait for response with timeout
-        fd_set readSet;
-        FD_ZERO(&readSet);
-        FD_SET(socketFd_, &readSet);
+        std::unique_lock<std::mutex> lock(pendingMutex_);
+        stats_.requests++;
 
-        struct timeval timeout;
-        timeout.tv_sec = timeoutMs / 1000;
-        timeout.tv_usec = (timeoutMs % 1000) * 1000;
+        // Leader/follower: one waiter reads the socket for everyone, the rest sleep
+        while (!entry->done) {
+            auto now = std::chrono::steady_clock::now();
+            if (now >= deadline) {
+                break;
+            }
 
-        int selectResult = select(socketFd_ + 1, &readSet, nullptr, nullptr, &timeout);
+            if (!readerActive_) {
+                readerActive_ = true;
+                lock.unlock();
+                int remainingMs = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                    deadline - now).count()) + 1;
+                readReplies(fd, remainingMs);
+                lock.lock();
+                readerActive_ = false;
+                pendingChanged_.notify_all();
+            } else {
+                pendingChanged_.wait_until(lock, deadline);
+            }
+        }
 
-        if (selectResult <= 0) {
-            // Timeout or error
+        pending_.erase(requestId);
+        if (!entry->done) {
+            stats_.timeouts++;
             return nullptr;
         }
+        return std::move(entry->response);
+    } catch (const std::exception& e) {
+        return nullptr;
+    }
+}
 
-        // Receive response
-        char buffer[65536];
-        struct sockaddr_in fromAddr;
-        socklen_t fromLen = sizeof(fromAddr);
+void UdpClient::readReplies(int fd, int timeoutMs) {
+    struct pollfd pfd;
+    pfd.fd = waitFd(fd);
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    if (poll(&pfd, 1, timeoutMs) <= 0) {
+        return;
+    }
 
-        ssize_t received = recvfrom(socketFd_, buffer, sizeof(buffer) - 1, 0,
-                                   reinterpret_cast<struct sockaddr*>(&fromAddr),
-                                   &fromLen);
+    // Drain everything queued so replies for other waiters are handed over in one pass;
+    // without the receiver thread there is no one to hand server pushes to
+    std::vector<json> datagrams;
+    std::vector<json> messages;
+    while (readDatagrams(fd, datagrams) > 0) {
+        for (auto& datagram : datagrams) {
+            routeDatagram(datagram, messages);
+        }
+        datagrams.clear();
+    }
+}
+
+void UdpClient::routeDatagram(json& datagram, std::vector<json>& messages) {
+    if (ClockSync::isTimeReply(datagram)) {
+        std::lock_guard<std::mutex> lock(clockMutex_);
+        clockSync_.receive(datagram, std::chrono::steady_clock::now());
+        return;
+    }
+
+    if (ReliableUdpEndpoint::isReliable(datagram)) {
+        std::lock_guard<std::mutex> lock(reliableMutex_);
+        reliable_.receive(datagram, std::chrono::steady_clock::now(), messages);
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(pendingMutex_);
+    std::string requestId;
+    bool hasRequestId = UdpEnvelope::readRequestId(datagram, requestId);
+    bool isReply = hasRequestId || (datagram.is_object() && datagram.contains("status"));
+
+    std::map<std::string, std::shared_ptr<PendingRequest>>::iterator it = pending_.end();
+    if (!isReply) {
+        // Neither a request ID nor a status: the datagram was pushed by the server
+        messages.push_back(std::move(datagram));
+        return;
+    } else if (hasRequestId) {
+        it = pending_.find(requestId);
+    } else if (pending_.size() == 1) {
+        // Servers that do not echo request IDs: unambiguous only with one request in flight
+        it = pending_.begin();
+    }
+
+    if (it == pending_.end() || it->second->done) {
+        stats_.staleReplies++;
+        return;
+    }
+
+    it->second->response = std::move(datagram);
+    it->second->done = true;
+    stats_.replies++;
+    pendingChanged_.notify_all();
+}
+
+size_t UdpClient::sendBatch(const std::vector<UdpEnvelope>& envelopes) {
+    if (envelopes.empty()) {
+        return 0;
+    }
+
+    int fd = connectedSocket();
+    if (fd < 0) {
+        return 0;
+    }
+
+    std::lock_guard<std::mutex> lock(sendBatchMutex_);
+    size_t count = envelopes.size();
+    sendEnvelopeEnds_.resize(count);
+
+    // Large envelopes become several fragments; remember where each envelope ends
+    size_t total = 0;
+    try {
+        UdpEncoding encoding = activeEncoding_;
+        for (size_t i = 0; i < count; i++) {
+            size_t encoded = encodeDatagrams(envelopes[i].toJson(), encoding, sendPayloads_, total);
+            if (encoded == 0) {
+                count = i;
+                break;
+            }
+            total += encoded;
+            sendEnvelopeEnds_[i] = total;
+        }
+    } catch (const std::exception& e) {
+        return 0;
+    }
+
+    size_t sent = sendDatagrams(fd, sendPayloads_, total);
+    return static_cast<size_t>(std::upper_bound(sendEnvelopeEnds_.begin(), sendEnvelopeEnds_.begin() + count, sent) -
+                               sendEnvelopeEnds_.begin());
+}
+
+size_t UdpClient::encodeDatagrams(const json& datagram, UdpEncoding encoding,
+                                  std::vector<std::string>& out, size_t index) {
+    if (out.size() <= index) {
+        out.resize(index + 1);
+    }
+    UdpCodec::encode(datagram, encoding, out[index]);
+
+    if (config_.maxDatagramSize == 0 || out[index].size() <= config_.maxDatagramSize) {
+        return 1;
+    }
+
+    std::vector<std::string> fragments;
+    size_t count = UdpFragmentation::split(out[index], config_.maxDatagramSize, nextMessageId_++, fragments);
+    if (count == 0) {
+        std::cerr << "UDP datagram of " << out[index].size() << " bytes is too large to fragment" << std::endl;
+        return 0;
+    }
+
+    if (out.size() < index + count) {
+        out.resize(index + count);
+    }
+    for (size_t i = 0; i < count; i++) {
+        out[index + i] = std::move(fragments[i]);
+    }
+    fragmentsSent_ += count;
+    return count;
+}
+
+bool UdpClient::sendEncoded(int fd, const std::vector<std::string>& datagrams, size_t count) {
+    if (count == 1 && config_.backend == UdpBackend::SOCKET) {
+        ssize_t sent = ::send(fd, datagrams[0].data(), datagrams[0].size(), 0);
+        if (sent < 0) {
+            handleSendError(errno);
+            return false;
+        }
+        return sent > 0;
+    }
+
+    std::lock_guard<std::mutex> lock(sendBatchMutex_);
+    return sendDatagrams(fd, datagrams, count) == count;
+}
+
+size_t UdpClient::sendDatagrams(int fd, const std::vector<std::string>& datagrams, size_t count) {
+    if (auto ring = ringFor(fd)) {
+        size_t sent = ring->send(datagrams, count);
+        if (sent < count) {
+            handleSendError(errno);
+        }
+        return sent;
+    }
+
+    if (sendMsgs_.size() < count) {
+        sendIov_.resize(count);
+        sendMsgs_.resize(count);
+    }
+    for (size_t i = 0; i < count; i++) {
+        sendIov_[i].iov_base = const_cast<char*>(datagrams[i].data());
+        sendIov_[i].iov_len = datagrams[i].size();
+    }
+
+    // The kernel may accept fewer messages than offered; continue from there
+    bool segment = count > 1 && segmentOffloadFd_ == fd;
+    size_t sent = 0;
+    while (sent < count) {
+        size_t messages = prepareMessages(sent, count, segment);
+        unsigned int chunk = static_cast<unsigned int>(std::min<size_t>(messages, UIO_MAXIOV));
+        int result = sendmmsg(fd, sendMsgs_.data(), chunk, 0);
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (sendMsgs_[0].msg_hdr.msg_controllen > 0) {
+                // No checksum offload on the route, segment larger than the path MTU, ...:
+                // resend as single datagrams and stop offloading on this socket
+                int expected = fd;
+                segmentOffloadFd_.compare_exchange_strong(expected, -1);
+                offloadStats_.segmentFallbacks++;
+                segment = false;
+                continue;
+            }
+            handleSendError(errno);
+            break;
+        }
 
-        if (received > 0) {
-            buffer[received] = '\0';
-            return json::parse(buffer);
+        for (int m = 0; m < result; m++) {
+            size_t carried = sendMsgs_[m].msg_hdr.msg_iovlen;
+            if (sendMsgs_[m].msg_hdr.msg_controllen > 0) {
+                offloadStats_.segmentSends++;
+                offloadStats_.segmentDatagrams += carried;
+            }
+            sent += carried;
         }
+    }
 
+    return sent;
+}
+
+size_t UdpClient::prepareMessages(size_t first, size_t count, bool segment) {
+    if (segment && sendControl_.size() < (count - first) * CMSG_SPACE(sizeof(uint16_t))) {
+        sendControl_.resize((count - first) * CMSG_SPACE(sizeof(uint16_t)));
+    }
+
+    size_t messages = 0;
+    for (size_t i = first; i < count; messages++) {
+        // A run shares one segment size; only its last datagram may be shorter
+        size_t run = 1;
+        size_t size = sendIov_[i].iov_len;
+        if (segment && size > 0) {
+            size_t bytes = size;
+            while (i + run < count && run < MAX_SEGMENTS) {
+                size_t next = sendIov_[i + run].iov_len;
+                if (next == 0 || next > size || bytes + next > MAX_SEGMENTED_BYTES) {
+                    break;
+                }
+                bytes += next;
+                run++;
+                if (next < size) {
+                    break;
+                }
+            }
+        }
+
+        // Connected socket: no per-message address
+        struct msghdr& header = sendMsgs_[messages].msg_hdr;
+        std::memset(&sendMsgs_[messages], 0, sizeof(sendMsgs_[messages]));
+        header.msg_iov = &sendIov_[i];
+        header.msg_iovlen = run;
+        if (run > 1) {
+            header.msg_control = &sendControl_[messages * CMSG_SPACE(sizeof(uint16_t))];
+            header.msg_controllen = CMSG_SPACE(sizeof(uint16_t));
+            struct cmsghdr* control = CMSG_FIRSTHDR(&header);
+            control->cmsg_level = SOL_UDP;
+            control->cmsg_type = UDP_SEGMENT;
+            control->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+            uint16_t segmentSize = static_cast<uint16_t>(size);
+            std::memcpy(CMSG_DATA(control), &segmentSize, sizeof(segmentSize));
+        }
+        i += run;
+    }
+    return messages;
+}
+
+std::shared_ptr<UdpIoUring> UdpClient::ringFor(int fd) {
+    if (config_.backend != UdpBackend::IO_URING) {
         return nullptr;
+    }
+    std::lock_guard<std::mutex> lock(socketMutex_);
+    return ring_ && ring_->socket() == fd ? ring_ : nullptr;
+}
+
+int UdpClient::waitFd(int fd) {
+    auto ring = ringFor(fd);
+    return ring ? ring->eventFd() : fd;
+}
+
+void UdpClient::decodeDatagram(const char* data, size_t length, std::vector<json>& datagrams) {
+    if (UdpFragmentation::isFragment(data, length)) {
+        if (!reassembler_.add(data, length, reassembled_)) {
+            return;
+        }
+        data = reassembled_.data();
+        length = reassembled_.size();
+    }
+    json datagram = UdpCodec::decode(data, length);
+    if (!datagram.is_discarded()) {
+        datagrams.push_back(std::move(datagram));
+    }
+}
+
+int UdpClient::readDatagrams(int fd, std::vector<json>& datagrams) {
+    std::lock_guard<std::mutex> lock(receiveBatchMutex_);
+    size_t batchSize = static_cast<size_t>(std::max(1, config_.receiveBatchSize));
+    if (auto ring = ringFor(fd)) {
+        return static_cast<int>(ring->receive([&](const char* data, size_t length) {
+            decodeDatagram(data, length, datagrams);
+        }, batchSize));
+    }
+
+    if (receiveMsgs_.size() != batchSize) {
+        receiveBuffer_.resize(batchSize * MAX_DATAGRAM_SIZE);
+        receiveIov_.resize(batchSize);
+        receiveMsgs_.resize(batchSize);
+        receiveControl_.resize(batchSize * RECEIVE_CONTROL_SIZE);
+        for (size_t i = 0; i < batchSize; i++) {
+            receiveIov_[i].iov_base = &receiveBuffer_[i * MAX_DATAGRAM_SIZE];
+            receiveIov_[i].iov_len = MAX_DATAGRAM_SIZE;
+        }
+    }
+
+    bool coalesced = receiveOffloadFd_ == fd;
+    bool timestamped = timestampFd_ == fd;
+    bool countDrops = dropCountFd_ == fd;
+    bool control = coalesced || timestamped || countDrops;
+    for (size_t i = 0; i < batchSize; i++) {
+        std::memset(&receiveMsgs_[i], 0, sizeof(receiveMsgs_[i]));
+        receiveMsgs_[i].msg_hdr.msg_iov = &receiveIov_[i];
+        receiveMsgs_[i].msg_hdr.msg_iovlen = 1;
+        if (control) {
+            receiveMsgs_[i].msg_hdr.msg_control = &receiveControl_[i * RECEIVE_CONTROL_SIZE];
+            receiveMsgs_[i].msg_hdr.msg_controllen = RECEIVE_CONTROL_SIZE;
+        }
+    }
+
+    int received = recvmmsg(fd, receiveMsgs_.data(), static_cast<unsigned int>(batchSize),
+                            MSG_DONTWAIT, nullptr);
+    if (received <= 0) {
+        if (received < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+            handleSendError(errno);
+        }
+        return 0;
+    }
+
+    struct timespec readTime;
+    if (timestamped) {
+        clock_gettime(CLOCK_REALTIME, &readTime);
+    }
+    if (countDrops && dropCountSocket_ != fd) {
+        dropCountSocket_ = fd;  // A new socket counts from zero
+        dropCountSeen_ = 0;
+    }
+
+    int datagramCount = 0;
+    for (int i = 0; i < received; i++) {
+        const char* data = static_cast<const char*>(receiveIov_[i].iov_base);
+        size_t length = receiveMsgs_[i].msg_len;
+
+        // A GRO buffer holds datagrams of segmentSize bytes, the last one possibly shorter
+        size_t segmentSize = 0;
+        int64_t kernelNs = 0;
+        int64_t hardwareNs = 0;
+        if (control) {
+            struct msghdr& header = receiveMsgs_[i].msg_hdr;
+            for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&header); cmsg != nullptr; cmsg = CMSG_NXTHDR(&header, cmsg)) {
+                if (cmsg->cmsg_level == SOL_UDP && cmsg->cmsg_type == UDP_GRO) {
+                    int value;
+                    std::memcpy(&value, CMSG_DATA(cmsg), sizeof(value));
+                    segmentSize = value > 0 ? static_cast<size_t>(value) : 0;
+                } else if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_TIMESTAMPNS) {
+                    struct timespec stamp;
+                    std::memcpy(&stamp, CMSG_DATA(cmsg), sizeof(stamp));
+                    kernelNs = toNanoseconds(stamp);
+                } else if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_TIMESTAMPING) {
+                    // ts[0] is the software stamp, ts[2] the raw hardware stamp (zero if none)
+                    struct scm_timestamping stamps;
+                    std::memcpy(&stamps, CMSG_DATA(cmsg), sizeof(stamps));
+                    kernelNs = toNanoseconds(stamps.ts[0]);
+                    hardwareNs = toNanoseconds(stamps.ts[2]);
+                } else if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SO_RXQ_OVFL) {
+                    // Cumulative drops of the socket, reported with each datagram
+                    uint32_t dropped;
+                    std::memcpy(&dropped, CMSG_DATA(cmsg), sizeof(dropped));
+                    kernelDrops_ += dropped - dropCountSeen_;
+                    dropCountSeen_ = dropped;
+                }
+            }
+        }
+
+        size_t first = datagrams.size();
+        if (segmentSize == 0 || segmentSize >= length) {
+            decodeDatagram(data, length, datagrams);
+            datagramCount++;
+        } else {
+            offloadStats_.groReceives++;
+            for (size_t offset = 0; offset < length; offset += segmentSize) {
+                decodeDatagram(data + offset, std::min(segmentSize, length - offset), datagrams);
+                offloadStats_.groDatagrams++;
+                datagramCount++;
+            }
+        }
+
+        if (timestamped && kernelNs != 0) {
+            for (size_t d = first; d < datagrams.size(); d++) {
+                if (!datagrams[d].is_object()) {
+                    continue;
+                }
+                json& stamp = datagrams[d]["rxTimestamp"];
+                stamp["kernelNs"] = kernelNs;
+                stamp["readNs"] = toNanoseconds(readTime);
+                if (hardwareNs != 0) {
+                    stamp["hardwareNs"] = hardwareNs;
+                }
+            }
+        }
+    }
+
+    return datagramCount;
+}
+
+size_t UdpClient::receiveBatch(std::vector<json>& messages, int timeoutMs) {
+    if (receiverRunning_) {
+        // The receiver thread owns the socket; hand over what it has queued
+        std::unique_lock<std::mutex> lock(pendingMutex_);
+        if (timeoutMs > 0) {
+            receiveQueueChanged_.wait_for(lock, std::chrono::milliseconds(timeoutMs), [this]() {
+                return !receiveQueue_.empty() || !receiverRunning_;
+            });
+        }
+        size_t count = receiveQueue_.size();
+        for (auto& message : receiveQueue_) {
+            messages.push_back(std::move(message));
+        }
+        receiveQueue_.clear();
+        return count;
+    }
+
+    int fd = connectedSocket();
+    if (fd < 0) {
+        return 0;
+    }
+
+    if (timeoutMs > 0) {
+        struct pollfd pfd;
+        pfd.fd = waitFd(fd);
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+        if (poll(&pfd, 1, timeoutMs) <= 0) {
+            return 0;
+        }
+    }
+
+    // Replies to outstanding requests go to their waiters, not to the caller
+    std::vector<json> datagrams;
+    readDatagrams(fd, datagrams);
+    size_t count = messages.size();
+    for (auto& datagram : datagrams) {
+        routeDatagram(datagram, messages);
+    }
+    return messages.size() - count;
+}
+
+bool UdpClient::sendReliable(const UdpEnvelope& envelope, uint8_t channel, bool ordered) {
+    // Acknowledgements and retransmissions are handled on the receiver thread
+    if (!receiverRunning_ && !startReceiver() && !receiverRunning_) {
+        return false;
+    }
+
+    try {
+        int fd = connectedSocket();
+        if (fd < 0) {
+            return false;
+        }
+
+        json datagram = envelope.toJson();
+        bool wasIdle;
+        {
+            std::lock_guard<std::mutex> lock(reliableMutex_);
+            wasIdle = reliable_.nextDeadline() == std::chrono::steady_clock::time_point::max();
+            if (!reliable_.prepare(datagram, channel, ordered, std::chrono::steady_clock::now())) {
+                return false;
+            }
+        }
+
+        // The message is in flight now; a lost first transmission is retransmitted
+        std::vector<std::string> datagrams;
+        size_t count = encodeDatagrams(datagram, activeEncoding_, datagrams, 0);
+        if (count > 0) {
+            sendEncoded(fd, datagrams, count);
+        }
+
+        scheduleTimer(wasIdle);
+        return count > 0;
     } catch (const std::exception& e) {
-        return nullptr;
+        return false;
+    }
+}
+
+bool UdpClient::pushCoalesced(const json& request) {
+    try {
+        bool sent = true;
+        bool started;
+        {
+            std::lock_guard<std::mutex> lock(coalesceMutex_);
+            bool wasIdle = coalescer_.nextDeadline() == std::chrono::steady_clock::time_point::max();
+            std::vector<json> ready;
+            coalescer_.add(request, activeEncoding_, std::chrono::steady_clock::now(), ready);
+            if (!ready.empty()) {
+                sent = sendGenerated(ready);
+            }
+            started = wasIdle && coalescer_.nextDeadline() != std::chrono::steady_clock::time_point::max();
+        }
+
+        // A new batch has a deadline the receiver thread must wait for
+        if (started) {
+            scheduleTimer(true);
+        }
+        return sent;
+    } catch (const std::exception& e) {
+        return false;
     }
 }
 
+bool UdpClient::flush() {
+    try {
+        std::lock_guard<std::mutex> lock(coalesceMutex_);
+        std::vector<json> ready;
+        coalescer_.flush(ready);
+        return ready.empty() || sendGenerated(ready);
+    } catch (const std::exception& e) {
+        return false;
+    }
+}
+
+bool UdpClient::startClockSync() {
+    {
+        std::lock_guard<std::mutex> lock(clockMutex_);
+        clockSync_.start(std::chrono::steady_clock::now());
+    }
+    return scheduleTimer(true);
+}
+
+void UdpClient::stopClockSync() {
+    std::lock_guard<std::mutex> lock(clockMutex_);
+    clockSync_.stop();
+}
+
+int64_t UdpClient::serverNow() {
+    std::lock_guard<std::mutex> lock(clockMutex_);
+    return clockSync_.serverTimeUs(std::chrono::steady_clock::now());
+}
+
+bool UdpClient::scheduleTimer(bool wake) {
+    // A newly started receiver computes its timeout before its first wait
+    if (!receiverRunning_) {
+        return startReceiver() || receiverRunning_;
+    }
+    if (wake) {
+        std::lock_guard<std::mutex> lock(socketMutex_);
+        wakeReceiverLocked();
+    }
+    return true;
+}
+
+bool UdpClient::sendGenerated(const std::vector<json>& outgoing) {
+    int fd = connectedSocket();
+    if (fd < 0) {
+        return false;
+    }
+
+    std::vector<std::string> datagrams;
+    size_t count = 0;
+    UdpEncoding encoding = activeEncoding_;
+    for (const auto& datagram : outgoing) {
+        count += encodeDatagrams(datagram, encoding, datagrams, count);
+    }
+    if (count == 0) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(sendBatchMutex_);
+    return sendDatagrams(fd, datagrams, count) == count;
+}
+
+int UdpClient::serviceTimers() {
+    std::vector<json> outgoing;
+    std::chrono::steady_clock::time_point deadline;
+    auto now = std::chrono::steady_clock::now();
+    {
+        std::lock_guard<std::mutex> lock(reliableMutex_);
+        reliable_.poll(now, outgoing);
+        deadline = reliable_.nextDeadline();
+    }
+    if (!outgoing.empty()) {
+        sendGenerated(outgoing);
+        outgoing.clear();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(coalesceMutex_);
+        coalescer_.poll(now, outgoing);
+        if (!outgoing.empty()) {
+            sendGenerated(outgoing);
+        }
+        deadline = std::min(deadline, coalescer_.nextDeadline());
+    }
+
+    outgoing.clear();
+    {
+        std::lock_guard<std::mutex> lock(clockMutex_);
+        clockSync_.poll(std::chrono::steady_clock::now(), outgoing);
+        deadline = std::min(deadline, clockSync_.nextDeadline());
+    }
+    if (!outgoing.empty()) {
+        sendGenerated(outgoing);
+    }
+
+    if (deadline == std::chrono::steady_clock::time_point::max()) {
+        return -1;
+    }
+    auto waitUs = std::chrono::duration_cast<std::chrono::microseconds>(deadline - now).count();
+    return waitUs <= 0 ? 0 : static_cast<int>((waitUs + 999) / 1000);
+}
+
+bool UdpClient::startReceiver(UdpMessageCallback callback) {
+    std::unique_lock<std::mutex> lock(pendingMutex_);
+    if (receiverRunning_) {
+        return false;
+    }
+
+    int epollFd = epoll_create1(EPOLL_CLOEXEC);
+    int wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    struct epoll_event event;
+    std::memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN;
+    event.data.fd = wakeFd;
+    if (epollFd < 0 || wakeFd < 0 || epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &event) != 0) {
+        std::cerr << "Failed to start UDP receiver: " << std::strerror(errno) << std::endl;
+        if (epollFd >= 0) ::close(epollFd);
+        if (wakeFd >= 0) ::close(wakeFd);
+        return false;
+    }
+
+    // Take over the reader role once a sendAndWait caller reading the socket finishes
+    pendingChanged_.wait(lock, [this]() { return !readerActive_; });
+    readerActive_ = true;
+    receiverRunning_ = true;
+    messageCallback_ = std::move(callback);
+    lock.unlock();
+
+    {
+        std::lock_guard<std::mutex> socketLock(socketMutex_);
+        wakeFd_ = wakeFd;
+    }
+    receiverThread_ = std::thread(&UdpClient::runReceiver, this, epollFd, wakeFd);
+
+    // Open the socket so server pushes can arrive before the first send
+    connectedSocket();
+    return true;
+}
+
+void UdpClient::stopReceiver() {
+    {
+        std::lock_guard<std::mutex> lock(pendingMutex_);
+        if (!receiverRunning_) {
+            return;
+        }
+        receiverRunning_ = false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(socketMutex_);
+        wakeReceiverLocked();
+    }
+    receiverThread_.join();
+
+    {
+        std::lock_guard<std::mutex> lock(socketMutex_);
+        ::close(wakeFd_);
+        wakeFd_ = -1;
+    }
+
+    std::lock_guard<std::mutex> lock(pendingMutex_);
+    readerActive_ = false;
+    messageCallback_ = nullptr;
+    pendingChanged_.notify_all();
+    receiveQueueChanged_.notify_all();
+}
+
+void UdpClient::wakeReceiverLocked() {
+    if (wakeFd_ >= 0) {
+        uint64_t one = 1;
+        ssize_t written = ::write(wakeFd_, &one, sizeof(one));
+        (void)written;  // Counter overflow only means a wakeup is already pending
+    }
+}
+
+void UdpClient::runReceiver(int epollFd, int wakeFd) {
+    int registeredFd = -1;
+    int registeredWaitFd = -1;  // The socket, or its ring's eventfd
+    uint64_t registeredGeneration = 0;
+    std::vector<json> datagrams;
+    std::vector<json> messages;
+
+    while (receiverRunning_) {
+        // Follow the socket across re-resolves and close()
+        int fd;
+        int watchFd;
+        uint64_t generation;
+        {
+            std::lock_guard<std::mutex> lock(socketMutex_);
+            fd = isOpen_ ? socketFd_ : -1;
+            watchFd = fd >= 0 && ring_ ? ring_->eventFd() : fd;
+            generation = socketGeneration_;
+        }
+        if (fd != registeredFd || generation != registeredGeneration) {
+            if (registeredWaitFd >= 0) {
+                epoll_ctl(epollFd, EPOLL_CTL_DEL, registeredWaitFd, nullptr);  // Fails harmlessly if closed
+            }
+            registeredFd = -1;
+            registeredWaitFd = -1;
+            if (watchFd >= 0) {
+                struct epoll_event event;
+                std::memset(&event, 0, sizeof(event));
+                event.events = EPOLLIN;
+                event.data.fd = watchFd;
+                if (epoll_ctl(epollFd, EPOLL_CTL_ADD, watchFd, &event) == 0) {
+                    registeredFd = fd;
+                    registeredWaitFd = watchFd;
+                }
+            }
+            registeredGeneration = generation;
+        }
+
+        // Sleep until the next datagram, wakeup, retransmission or flush deadline
+        struct epoll_event events[2];
+        int ready = epoll_wait(epollFd, events, 2, serviceTimers());
+        for (int i = 0; i < ready; i++) {
+            if (events[i].data.fd == wakeFd) {
+                uint64_t counter;
+                ssize_t drained = ::read(wakeFd, &counter, sizeof(counter));
+                (void)drained;
+                continue;
+            }
+
+            if (events[i].data.fd != registeredWaitFd) {
+                continue;  // Socket replaced since epoll_wait returned
+            }
+
+            // Drain the socket, then deliver server pushes outside the lock
+            while (readDatagrams(registeredFd, datagrams) > 0) {
+                for (auto& datagram : datagrams) {
+                    routeDatagram(datagram, messages);
+                }
+                datagrams.clear();
+            }
+            deliverMessages(messages);
+            messages.clear();
+        }
+    }
+
+    ::close(epollFd);
+}
+
+void UdpClient::deliverMessages(std::vector<json>& messages) {
+    if (messages.empty()) {
+        return;
+    }
+
+    // The callback is only replaced while the receiver thread is stopped
+    if (messageCallback_) {
+        for (const auto& message : messages) {
+            try {
+                messageCallback_(message);
+            } catch (const std::exception& e) {
+                std::cerr << "Exception in UDP message callback: " << e.what() << std::endl;
+            }
+        }
+        std::lock_guard<std::mutex> lock(pendingMutex_);
+        stats_.messages += messages.size();
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(pendingMutex_);
+    size_t capacity = std::max<size_t>(1, config_.receiveQueueCapacity);
+    for (auto& message : messages) {
+        // Keep the newest datagrams: for state updates the oldest are the least useful
+        if (receiveQueue_.size() >= capacity) {
+            receiveQueue_.pop_front();
+            stats_.queueDrops++;
+        }
+        receiveQueue_.push_back(std::move(message));
+    }
+    stats_.messages += messages.size();
+    receiveQueueChanged_.notify_all();
+}
+
+UdpClientStats UdpClient::getStats() const {
+    UdpClientStats stats;
+    {
+        std::lock_guard<std::mutex> lock(pendingMutex_);
+        stats = stats_;
+    }
+    stats.fragmentsSent = fragmentsSent_;
+
+    {
+        std::lock_guard<std::mutex> lock(receiveBatchMutex_);
+        stats.reassembly = reassembler_.getStats();
+        stats.offload.groReceives = offloadStats_.groReceives;
+        stats.offload.groDatagrams = offloadStats_.groDatagrams;
+        stats.kernelDrops = kernelDrops_;
+    }
+    stats.receiveBufferSize = receiveBufferSize_;
+    stats.sendBufferSize = sendBufferSize_;
+
+    {
+        std::lock_guard<std::mutex> lock(sendBatchMutex_);
+        stats.offload.segmentSends = offloadStats_.segmentSends;
+        stats.offload.segmentDatagrams = offloadStats_.segmentDatagrams;
+        stats.offload.segmentFallbacks = offloadStats_.segmentFallbacks;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(reliableMutex_);
+        stats.reliability = reliable_.getStats();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(coalesceMutex_);
+        stats.coalescing = coalescer_.getStats();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(clockMutex_);
+        stats.clockSync = clockSync_.getStats(std::chrono::steady_clock::now());
+    }
+
+    std::shared_ptr<UdpIoUring> ring;
+    {
+        std::lock_guard<std::mutex> lock(socketMutex_);
+        ring = ring_;
+    }
+    if (ring) {
+        stats.ioUring = ring->getStats();
+    }
+    return stats;
+}
+
 void UdpClient::close() {
-    if (isOpen_ && socketFd_ >= 0) {
+    flush();
+
+    std::lock_guard<std::mutex> lock(socketMutex_);
+    ring_.reset();
+    segmentOffloadFd_ = -1;
+    receiveOffloadFd_ = -1;
+    timestampFd_ = -1;
+    dropCountFd_ = -1;
+    if (socketFd_ >= 0) {
         ::close(socketFd_);
         socketFd_ = -1;
-        isOpen_ = false;
+        socketGeneration_++;
+        wakeReceiverLocked();
     }
+    isOpen_ = false;
 }
 
 } // namespace messaging
 } // namespace hmdev
-
@@ -0,0 +1,86 @@
+#include "hmdev/messaging/util/udp_coalescer.h"
+#include <algorithm>
+
+namespace hmdev {
+namespace messaging {
+
+UdpCoalescer::UdpCoalescer(const UdpCoalescingConfig& config)
+    : config_(config), batch_(json::array()), batchBytes_(0) {
+    json empty = {{"action", "push-batch"}, {"payload", {{"messages", json::array()}}}};
+    for (UdpEncoding encoding : {UdpEncoding::JSON, UdpEncoding::MSGPACK, UdpEncoding::CBOR}) {
+        overhead_[static_cast<int>(encoding)] = measure(empty, encoding);
+    }
+}
+
+void UdpCoalescer::add(json request, UdpEncoding encoding, Clock::time_point now, std::vector<json>& ready) {
+    size_t size = measure(request, encoding);
+
+    // One byte per element covers JSON commas; two more cover a longer binary array header
+    size_t overhead = overhead_[static_cast<int>(encoding)] + 2;
+    if (!batch_.empty() && overhead + batchBytes_ + size + batch_.size() + 1 > config_.maxDatagramSize) {
+        stats_.sizeFlushes++;
+        close(ready);
+    }
+
+    if (batch_.empty() && config_.flushDeadlineMs > 0) {
+        deadline_ = now + std::chrono::milliseconds(config_.flushDeadlineMs);
+    }
+    batch_.push_back(std::move(request));
+    batchBytes_ += size;
+
+    // A request too large to share a datagram goes out alone
+    if (overhead + batchBytes_ + batch_.size() > config_.maxDatagramSize) {
+        stats_.sizeFlushes++;
+        close(ready);
+    }
+}
+
+void UdpCoalescer::flush(std::vector<json>& ready) {
+    if (!batch_.empty()) {
+        stats_.explicitFlushes++;
+        close(ready);
+    }
+}
+
+void UdpCoalescer::poll(Clock::time_point now, std::vector<json>& ready) {
+    if (!batch_.empty() && config_.flushDeadlineMs > 0 && deadline_ <= now) {
+        stats_.deadlineFlushes++;
+        close(ready);
+    }
+}
+
+UdpCoalescer::Clock::time_point UdpCoalescer::nextDeadline() const {
+    if (batch_.empty() || config_.flushDeadlineMs <= 0) {
+        return Clock::time_point::max();
+    }
+    return deadline_;
+}
+
+UdpCoalescingStats UdpCoalescer::getStats() const {
+    UdpCoalescingStats stats = stats_;
+    stats.pending = batch_.size();
+    return stats;
+}
+
+size_t UdpCoalescer::measure(const json& value, UdpEncoding encoding) {
+    UdpCodec::encode(value, encoding, scratch_);
+    return scratch_.size();
+}
+
+void UdpCoalescer::close(std::vector<json>& ready) {
+    size_t count = batch_.size();
+    stats_.messages += count;
+    stats_.datagrams++;
+    stats_.maxPerDatagram = std::max(stats_.maxPerDatagram, count);
+
+    if (count == 1) {
+        ready.push_back(json{{"action", "push"}, {"payload", std::move(batch_[0])}});
+    } else {
+        ready.push_back(json{{"action", "push-batch"}, {"payload", {{"messages", std::move(batch_)}}}});
+    }
+    batch_ = json::array();
+    batchBytes_ = 0;
+}
+
+} // namespace messaging
+} // namespace hmdev
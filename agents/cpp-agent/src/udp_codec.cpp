@@ -0,0 +1,179 @@
+#include "hmdev/messaging/util/udp_codec.h"
+#include <unordered_map>
+#include <utility>
+
+namespace hmdev {
+namespace messaging {
+
+// Envelope, request, reply, reliability and batch field names with their short keys
+static const std::pair<const char*, const char*> SHORT_KEYS[] = {
+    {"action", "a"},
+    {"payload", "p"},
+    {"requestId", "i"},
+    {"sessionId", "s"},
+    {"type", "t"},
+    {"to", "d"},
+    {"content", "c"},
+    {"encrypted", "e"},
+    {"receiveConfig", "r"},
+    {"globalOffset", "g"},
+    {"localOffset", "l"},
+    {"limit", "n"},
+    {"pollSource", "ps"},
+    {"status", "st"},
+    {"result", "rs"},
+    {"data", "dt"},
+    {"events", "ev"},
+    {"from", "f"},
+    {"timestamp", "ts"},
+    {"nextGlobalOffset", "ng"},
+    {"nextLocalOffset", "nl"},
+    {"ephemeral", "ep"},
+    {"message", "m"},
+    {"reliable", "rl"},
+    {"channel", "ch"},
+    {"seq", "sq"},
+    {"ordered", "od"},
+    {"cumulative", "cu"},
+    {"ack", "ak"},
+    {"ackBits", "ab"},
+    {"floor", "fl"},
+    {"messages", "ms"}
+};
+
+using KeyMap = std::unordered_map<std::string, std::string>;
+
+static const KeyMap& shortKeys() {
+    static const KeyMap keys = []() {
+        KeyMap map;
+        for (const auto& entry : SHORT_KEYS) {
+            map[entry.first] = entry.second;
+        }
+        return map;
+    }();
+    return keys;
+}
+
+static const KeyMap& fullKeys() {
+    static const KeyMap keys = []() {
+        KeyMap map;
+        for (const auto& entry : SHORT_KEYS) {
+            map[entry.second] = entry.first;
+        }
+        return map;
+    }();
+    return keys;
+}
+
+static json renameKeys(const json& value, const KeyMap& names) {
+    if (value.is_object()) {
+        json renamed = json::object();
+        for (auto it = value.begin(); it != value.end(); ++it) {
+            auto name = names.find(it.key());
+            renamed[name != names.end() ? name->second : it.key()] = renameKeys(it.value(), names);
+        }
+        return renamed;
+    }
+    if (value.is_array()) {
+        json renamed = json::array();
+        for (const auto& element : value) {
+            renamed.push_back(renameKeys(element, names));
+        }
+        return renamed;
+    }
+    return value;
+}
+
+// Decoded datagrams are consumed, so their values are moved rather than copied
+static void renameKeysInPlace(json& value, const KeyMap& names) {
+    if (value.is_object()) {
+        json renamed = json::object();
+        for (auto it = value.begin(); it != value.end(); ++it) {
+            renameKeysInPlace(it.value(), names);
+            auto name = names.find(it.key());
+            renamed[name != names.end() ? name->second : it.key()] = std::move(it.value());
+        }
+        value = std::move(renamed);
+    } else if (value.is_array()) {
+        for (auto& element : value) {
+            renameKeysInPlace(element, names);
+        }
+    }
+}
+
+std::string udpEncodingToString(UdpEncoding encoding) {
+    switch (encoding) {
+        case UdpEncoding::MSGPACK: return "msgpack";
+        case UdpEncoding::CBOR: return "cbor";
+        default: return "json";
+    }
+}
+
+bool stringToUdpEncoding(const std::string& str, UdpEncoding& encoding) {
+    if (str == "json") encoding = UdpEncoding::JSON;
+    else if (str == "msgpack") encoding = UdpEncoding::MSGPACK;
+    else if (str == "cbor") encoding = UdpEncoding::CBOR;
+    else return false;
+    return true;
+}
+
+json UdpCodec::shortenKeys(const json& value) {
+    return renameKeys(value, shortKeys());
+}
+
+json UdpCodec::expandKeys(const json& value) {
+    return renameKeys(value, fullKeys());
+}
+
+void UdpCodec::encode(const json& datagram, UdpEncoding encoding, std::string& output) {
+    output.clear();
+    switch (encoding) {
+        case UdpEncoding::MSGPACK:
+            json::to_msgpack(shortenKeys(datagram), output);
+            break;
+        case UdpEncoding::CBOR:
+            json::to_cbor(shortenKeys(datagram), output);
+            break;
+        default:
+            output = datagram.dump();
+            break;
+    }
+}
+
+UdpEncoding UdpCodec::detect(const char* data, size_t length) {
+    if (length == 0) {
+        return UdpEncoding::JSON;
+    }
+
+    // Datagrams are always maps: MessagePack fixmap/map16/map32 and CBOR major
+    // type 5 never collide with '{' or whitespace
+    unsigned char first = static_cast<unsigned char>(data[0]);
+    if ((first >= 0x80 && first <= 0x8f) || first == 0xde || first == 0xdf) {
+        return UdpEncoding::MSGPACK;
+    }
+    if ((first >= 0xa0 && first <= 0xbb) || first == 0xbf) {
+        return UdpEncoding::CBOR;
+    }
+    return UdpEncoding::JSON;
+}
+
+json UdpCodec::decode(const char* data, size_t length) {
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
+    switch (detect(data, length)) {
+        case UdpEncoding::MSGPACK: {
+            json value = json::from_msgpack(bytes, bytes + length, true, false);
+            renameKeysInPlace(value, fullKeys());
+            return value;
+        }
+        case UdpEncoding::CBOR: {
+            json value = json::from_cbor(bytes, bytes + length, true, false);
+            renameKeysInPlace(value, fullKeys());
+            return value;
+        }
+        default:
+            return json::parse(data, data + length, nullptr, false);
+    }
+}
+
+} // namespace messaging
+} // namespace hmdev
@@ -0,0 +1,197 @@
+#include "hmdev/messaging/util/udp_fragmentation.h"
+#include <algorithm>
+
+namespace hmdev {
+namespace messaging {
+
+static constexpr unsigned char FRAGMENT_MAGIC = 0xF7;
+static constexpr unsigned char FRAGMENT_VERSION = 1;
+
+static void putUint16(std::string& out, uint16_t value) {
+    out.push_back(static_cast<char>(value >> 8));
+    out.push_back(static_cast<char>(value & 0xFF));
+}
+
+static void putUint32(std::string& out, uint32_t value) {
+    putUint16(out, static_cast<uint16_t>(value >> 16));
+    putUint16(out, static_cast<uint16_t>(value & 0xFFFF));
+}
+
+static uint16_t getUint16(const unsigned char* in) {
+    return static_cast<uint16_t>((in[0] << 8) | in[1]);
+}
+
+// Memory of a partial message's fragment slots and received bitmap
+static size_t slotOverhead(size_t count) {
+    return count * sizeof(std::string) + (count + 7) / 8;
+}
+
+static uint32_t getUint32(const unsigned char* in) {
+    return (static_cast<uint32_t>(in[0]) << 24) | (static_cast<uint32_t>(in[1]) << 16) |
+           (static_cast<uint32_t>(in[2]) << 8) | static_cast<uint32_t>(in[3]);
+}
+
+size_t UdpFragmentation::split(const std::string& datagram, size_t maxDatagramSize, uint32_t messageId,
+                               std::vector<std::string>& fragments) {
+    if (maxDatagramSize <= HEADER_SIZE) {
+        return 0;
+    }
+
+    size_t chunk = maxDatagramSize - HEADER_SIZE;
+    size_t count = std::max<size_t>(1, (datagram.size() + chunk - 1) / chunk);
+    if (count > MAX_FRAGMENTS) {
+        return 0;
+    }
+
+    for (size_t index = 0; index < count; index++) {
+        size_t offset = index * chunk;
+        size_t length = std::min(chunk, datagram.size() - offset);
+
+        std::string fragment;
+        fragment.reserve(HEADER_SIZE + length);
+        fragment.push_back(static_cast<char>(FRAGMENT_MAGIC));
+        fragment.push_back(static_cast<char>(FRAGMENT_VERSION));
+        putUint32(fragment, messageId);
+        putUint16(fragment, static_cast<uint16_t>(index));
+        putUint16(fragment, static_cast<uint16_t>(count));
+        fragment.append(datagram, offset, length);
+        fragments.push_back(std::move(fragment));
+    }
+
+    return count;
+}
+
+bool UdpFragmentation::isFragment(const char* data, size_t length) {
+    return length >= HEADER_SIZE &&
+           static_cast<unsigned char>(data[0]) == FRAGMENT_MAGIC &&
+           static_cast<unsigned char>(data[1]) == FRAGMENT_VERSION;
+}
+
+// UdpReassembler
+
+UdpReassembler::UdpReassembler(const UdpReassemblyConfig& config) : config_(config) {
+}
+
+bool UdpReassembler::add(const char* data, size_t length, std::string& message) {
+    auto now = Clock::now();
+    expire(now);
+
+    if (!UdpFragmentation::isFragment(data, length)) {
+        stats_.rejected++;
+        return false;
+    }
+    stats_.fragments++;
+
+    const unsigned char* header = reinterpret_cast<const unsigned char*>(data);
+    uint32_t messageId = getUint32(header + 2);
+    size_t index = getUint16(header + 6);
+    size_t count = getUint16(header + 8);
+    size_t payloadLength = length - UdpFragmentation::HEADER_SIZE;
+    bool last = index + 1 == count;
+
+    // split() never sends an empty fragment; a full-size one bounds the count
+    if (count == 0 || index >= count || payloadLength == 0 ||
+        (!last && (count - 1) * payloadLength > config_.maxMessageSize)) {
+        stats_.rejected++;
+        return false;
+    }
+
+    auto it = partial_.find(messageId);
+    if (it == partial_.end()) {
+        PartialMessage entry;
+        entry.firstSeen = now;
+        entry.parts.resize(count);
+        entry.have.assign(count, false);
+        entry.received = 0;
+        entry.chunk = 0;
+        entry.payloadBytes = 0;
+        entry.bytes = slotOverhead(count);
+        if (entry.bytes > config_.maxBytes) {
+            stats_.rejected++;
+            return false;
+        }
+        stats_.bufferedBytes += entry.bytes;
+        it = partial_.emplace(messageId, std::move(entry)).first;
+    }
+
+    // All non-final fragments have the chunk size and the final one is no larger
+    PartialMessage& entry = it->second;
+    bool chunkMismatch = entry.chunk != 0 && (last ? payloadLength > entry.chunk : payloadLength != entry.chunk);
+    bool lastTooLarge = !last && entry.chunk == 0 && entry.have[count - 1] &&
+                        entry.parts[count - 1].size() > payloadLength;
+    if (entry.parts.size() != count || chunkMismatch || lastTooLarge ||
+        entry.payloadBytes + payloadLength > config_.maxMessageSize) {
+        stats_.rejected++;
+        drop(it);
+        return false;
+    }
+    if (entry.have[index]) {
+        return false;  // Duplicate
+    }
+
+    if (!last) {
+        entry.chunk = payloadLength;
+    }
+    entry.parts[index].assign(data + UdpFragmentation::HEADER_SIZE, payloadLength);
+    entry.have[index] = true;
+    entry.received++;
+    entry.payloadBytes += payloadLength;
+    entry.bytes += payloadLength;
+    stats_.bufferedBytes += payloadLength;
+
+    if (entry.received == count) {
+        message.clear();
+        message.reserve(entry.payloadBytes);
+        for (const auto& part : entry.parts) {
+            message += part;
+        }
+        stats_.messages++;
+        drop(it);
+        return true;
+    }
+
+    while (stats_.bufferedBytes > config_.maxBytes && !partial_.empty()) {
+        evictOldest();
+    }
+    return false;
+}
+
+void UdpReassembler::expire() {
+    expire(Clock::now());
+}
+
+void UdpReassembler::expire(Clock::time_point now) {
+    auto timeout = std::chrono::milliseconds(config_.timeoutMs);
+    for (auto it = partial_.begin(); it != partial_.end();) {
+        if (now - it->second.firstSeen > timeout) {
+            stats_.bufferedBytes -= it->second.bytes;
+            stats_.timeouts++;
+            it = partial_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void UdpReassembler::evictOldest() {
+    auto oldest = partial_.begin();
+    for (auto it = partial_.begin(); it != partial_.end(); ++it) {
+        if (it->second.firstSeen < oldest->second.firstSeen) {
+            oldest = it;
+        }
+    }
+    stats_.evictions++;
+    drop(oldest);
+}
+
+void UdpReassembler::drop(std::map<uint32_t, PartialMessage>::iterator it) {
+    stats_.bufferedBytes -= it->second.bytes;
+    partial_.erase(it);
+}
+
+UdpReassemblyStats UdpReassembler::getStats() const {
+    return stats_;
+}
+
+} // namespace messaging
+} // namespace hmdev
@@ -0,0 +1,417 @@
+#include "hmdev/messaging/api/udp_io_uring.h"
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+#ifdef HMDEV_MESSAGING_IO_URING
+#include <linux/io_uring.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <algorithm>
+#endif
+
+namespace hmdev {
+namespace messaging {
+
+#ifdef HMDEV_MESSAGING_IO_URING
+
+static constexpr uint64_t SEND_TAG = 1;
+static constexpr uint64_t RECEIVE_TAG = 2;
+static constexpr uint16_t BUFFER_GROUP = 0;
+
+static int ioUringSetup(unsigned entries, struct io_uring_params* params) {
+    return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+static int ioUringEnter(int ringFd, unsigned submit, unsigned waitFor, unsigned flags) {
+    return static_cast<int>(syscall(__NR_io_uring_enter, ringFd, submit, waitFor, flags, nullptr, 0));
+}
+
+static int ioUringRegister(int ringFd, unsigned opcode, void* arg, unsigned count) {
+    return static_cast<int>(syscall(__NR_io_uring_register, ringFd, opcode, arg, count));
+}
+
+static void* mapRing(int ringFd, size_t size, off_t offset) {
+    void* memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, offset);
+    return memory == MAP_FAILED ? nullptr : memory;
+}
+
+static void* mapAnonymous(size_t size) {
+    void* memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    return memory == MAP_FAILED ? nullptr : memory;
+}
+
+template <typename T>
+static T* at(void* base, size_t offset) {
+    return reinterpret_cast<T*>(static_cast<char*>(base) + offset);
+}
+
+std::unique_ptr<UdpIoUring> UdpIoUring::create(int socketFd, const UdpIoUringConfig& config) {
+    std::unique_ptr<UdpIoUring> ring(new UdpIoUring(socketFd, config));
+    if (!ring->setup()) {
+        std::cerr << "io_uring UDP backend unavailable: " << std::strerror(errno) << std::endl;
+        return nullptr;
+    }
+    return ring;
+}
+
+UdpIoUring::UdpIoUring(int socketFd, const UdpIoUringConfig& config)
+    : config_(config), socketFd_(socketFd), ringFd_(-1), eventFd_(-1),
+      sqRing_(nullptr), sqRingSize_(0), cqRing_(nullptr), cqRingSize_(0), sqes_(nullptr), sqesSize_(0),
+      sqHead_(nullptr), sqTail_(nullptr), sqMask_(0), sqArray_(nullptr), sqEntries_(0),
+      cqHead_(nullptr), cqTail_(nullptr), cqMask_(0), cqFlags_(nullptr), cqes_(nullptr),
+      sendMemory_(nullptr), sendMemorySize_(0), receiveMemory_(nullptr), receiveMemorySize_(0),
+      bufferRing_(nullptr), bufferRingSize_(0), receiveEntries_(0), bufferRingTail_(0),
+      sendsInFlight_(0), sendsSucceeded_(0), sendError_(0), receiveArmed_(false) {
+    config_.sendBuffers = std::max(1u, config_.sendBuffers);
+    config_.bufferSize = std::max<size_t>(1, config_.bufferSize);
+}
+
+UdpIoUring::~UdpIoUring() {
+    // Closing the ring cancels the multishot receive before its buffers go away
+    if (ringFd_ >= 0) ::close(ringFd_);
+    if (eventFd_ >= 0) ::close(eventFd_);
+    if (sqes_) munmap(sqes_, sqesSize_);
+    if (cqRing_ && cqRing_ != sqRing_) munmap(cqRing_, cqRingSize_);
+    if (sqRing_) munmap(sqRing_, sqRingSize_);
+    if (bufferRing_) munmap(bufferRing_, bufferRingSize_);
+    if (receiveMemory_) munmap(receiveMemory_, receiveMemorySize_);
+    if (sendMemory_) munmap(sendMemory_, sendMemorySize_);
+}
+
+bool UdpIoUring::setup() {
+    struct io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+    unsigned depth = std::max(config_.queueDepth, config_.sendBuffers + 1);
+    ringFd_ = ioUringSetup(depth, &params);
+    if (ringFd_ < 0) {
+        return false;
+    }
+
+    sqRingSize_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cqRingSize_ = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        sqRingSize_ = cqRingSize_ = std::max(sqRingSize_, cqRingSize_);
+    }
+    sqRing_ = mapRing(ringFd_, sqRingSize_, IORING_OFF_SQ_RING);
+    if (!sqRing_) {
+        return false;
+    }
+    cqRing_ = (params.features & IORING_FEAT_SINGLE_MMAP) ? sqRing_
+                                                          : mapRing(ringFd_, cqRingSize_, IORING_OFF_CQ_RING);
+    sqesSize_ = params.sq_entries * sizeof(struct io_uring_sqe);
+    sqes_ = mapRing(ringFd_, sqesSize_, IORING_OFF_SQES);
+    if (!cqRing_ || !sqes_) {
+        return false;
+    }
+
+    sqHead_ = at<unsigned>(sqRing_, params.sq_off.head);
+    sqTail_ = at<unsigned>(sqRing_, params.sq_off.tail);
+    sqMask_ = *at<unsigned>(sqRing_, params.sq_off.ring_mask);
+    sqArray_ = at<unsigned>(sqRing_, params.sq_off.array);
+    sqEntries_ = params.sq_entries;
+    cqHead_ = at<unsigned>(cqRing_, params.cq_off.head);
+    cqTail_ = at<unsigned>(cqRing_, params.cq_off.tail);
+    cqMask_ = *at<unsigned>(cqRing_, params.cq_off.ring_mask);
+    cqFlags_ = at<unsigned>(cqRing_, params.cq_off.flags);
+    cqes_ = at<void>(cqRing_, params.cq_off.cqes);
+
+    // Send buffers are pinned once; WRITE_FIXED then skips the per-call page mapping
+    sendMemorySize_ = static_cast<size_t>(config_.sendBuffers) * config_.bufferSize;
+    sendMemory_ = static_cast<char*>(mapAnonymous(sendMemorySize_));
+    if (!sendMemory_) {
+        return false;
+    }
+    std::vector<struct iovec> iovecs(config_.sendBuffers);
+    for (unsigned i = 0; i < config_.sendBuffers; i++) {
+        iovecs[i].iov_base = sendMemory_ + i * config_.bufferSize;
+        iovecs[i].iov_len = config_.bufferSize;
+    }
+    if (ioUringRegister(ringFd_, IORING_REGISTER_BUFFERS, iovecs.data(), config_.sendBuffers) != 0) {
+        return false;
+    }
+
+    // Receive buffers hold one byte more than bufferSize so truncation is detectable
+    receiveEntries_ = 1;
+    while (receiveEntries_ < config_.receiveBuffers && receiveEntries_ < 32768) {
+        receiveEntries_ <<= 1;
+    }
+    receiveMemorySize_ = static_cast<size_t>(receiveEntries_) * (config_.bufferSize + 1);
+    receiveMemory_ = static_cast<char*>(mapAnonymous(receiveMemorySize_));
+    bufferRingSize_ = static_cast<size_t>(receiveEntries_) * sizeof(struct io_uring_buf);
+    bufferRing_ = mapAnonymous(bufferRingSize_);
+    if (!receiveMemory_ || !bufferRing_) {
+        return false;
+    }
+
+    struct io_uring_buf_reg registration;
+    std::memset(&registration, 0, sizeof(registration));
+    registration.ring_addr = reinterpret_cast<uint64_t>(bufferRing_);
+    registration.ring_entries = receiveEntries_;
+    registration.bgid = BUFFER_GROUP;
+    if (ioUringRegister(ringFd_, IORING_REGISTER_PBUF_RING, &registration, 1) != 0) {
+        return false;
+    }
+    for (unsigned i = 0; i < receiveEntries_; i++) {
+        recycleLocked(static_cast<uint16_t>(i));
+    }
+    publishBuffersLocked();
+
+    eventFd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (eventFd_ < 0 || ioUringRegister(ringFd_, IORING_REGISTER_EVENTFD, &eventFd_, 1) != 0) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    armReceiveLocked();
+    return receiveArmed_;
+}
+
+size_t UdpIoUring::send(const std::vector<std::string>& datagrams, size_t count) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t sent = 0;
+    int firstError = 0;
+    size_t index = 0;
+
+    // Send completions are reaped here; keep them from waking eventFd() pollers
+    size_t receivedBefore = received_.size();
+    __atomic_store_n(cqFlags_, *cqFlags_ | IORING_CQ_EVENTFD_DISABLED, __ATOMIC_RELEASE);
+
+    while (index < count) {
+        // Fill the registered buffers, submit them in one call and wait for all of them
+        unsigned queued = 0;
+        sendsSucceeded_ = 0;
+        sendError_ = 0;
+        while (index < count && queued < config_.sendBuffers && datagrams[index].size() <= config_.bufferSize) {
+            const std::string& datagram = datagrams[index];
+            char* buffer = sendMemory_ + queued * config_.bufferSize;
+            std::memcpy(buffer, datagram.data(), datagram.size());
+
+            struct io_uring_sqe* sqe = static_cast<struct io_uring_sqe*>(nextSqeLocked());
+            sqe->opcode = IORING_OP_WRITE_FIXED;
+            sqe->fd = socketFd_;
+            sqe->addr = reinterpret_cast<uint64_t>(buffer);
+            sqe->len = static_cast<uint32_t>(datagram.size());
+            sqe->off = static_cast<uint64_t>(-1);
+            sqe->buf_index = static_cast<uint16_t>(queued);
+            sqe->user_data = SEND_TAG;
+            queued++;
+            index++;
+        }
+
+        if (queued > 0) {
+            sendsInFlight_ += queued;
+            int result = enterLocked(queued, queued);
+            reapLocked();
+            while (result >= 0 && sendsInFlight_ > 0) {
+                // Resubmit whatever the kernel did not consume, or nothing would complete
+                unsigned unsubmitted = *sqTail_ - __atomic_load_n(sqHead_, __ATOMIC_ACQUIRE);
+                result = enterLocked(unsubmitted, 1);
+                reapLocked();
+            }
+            sent += sendsSucceeded_;
+            stats_.sent += sendsSucceeded_;
+            if (sendError_ != 0 && firstError == 0) {
+                firstError = sendError_;
+            }
+            if (result < 0) {
+                firstError = firstError != 0 ? firstError : errno;
+                break;
+            }
+        }
+
+        // Too large for a registered buffer: plain send() from the caller's memory
+        if (index < count && datagrams[index].size() > config_.bufferSize) {
+            ssize_t result = ::send(socketFd_, datagrams[index].data(), datagrams[index].size(), 0);
+            if (result < 0) {
+                firstError = firstError != 0 ? firstError : errno;
+            } else {
+                sent++;
+            }
+            stats_.oversizeSends++;
+            index++;
+        }
+    }
+
+    // Datagrams that arrived while notifications were off must still wake a poller
+    __atomic_store_n(cqFlags_, *cqFlags_ & ~IORING_CQ_EVENTFD_DISABLED, __ATOMIC_RELEASE);
+    reapLocked();
+    if (received_.size() > receivedBefore) {
+        uint64_t one = 1;
+        ssize_t written = ::write(eventFd_, &one, sizeof(one));
+        (void)written;
+    }
+
+    if (sent < count) {
+        errno = firstError;
+    }
+    return sent;
+}
+
+size_t UdpIoUring::receive(const DatagramHandler& handler, size_t maxDatagrams) {
+    std::vector<Received> batch;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        uint64_t counter;
+        ssize_t drained = ::read(eventFd_, &counter, sizeof(counter));
+        (void)drained;  // EAGAIN when nothing completed asynchronously
+
+        reapLocked();
+        if (!receiveArmed_) {
+            armReceiveLocked();
+            reapLocked();
+        }
+
+        size_t take = std::min(maxDatagrams, received_.size());
+        batch.assign(received_.begin(), received_.begin() + static_cast<std::ptrdiff_t>(take));
+        received_.erase(received_.begin(), received_.begin() + static_cast<std::ptrdiff_t>(take));
+        if (!received_.empty()) {
+            // The eventfd was drained above; keep it readable for what is still queued
+            uint64_t one = 1;
+            ssize_t written = ::write(eventFd_, &one, sizeof(one));
+            (void)written;
+        }
+    }
+
+    // The kernel does not reuse a buffer until it is recycled, so handle it unlocked
+    for (const Received& entry : batch) {
+        if (static_cast<size_t>(entry.length) > config_.bufferSize) {
+            continue;
+        }
+        handler(receiveMemory_ + static_cast<size_t>(entry.bufferId) * (config_.bufferSize + 1),
+                static_cast<size_t>(entry.length));
+    }
+
+    if (!batch.empty()) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const Received& entry : batch) {
+            recycleLocked(entry.bufferId);
+        }
+        publishBuffersLocked();
+        // Datagrams taken by a re-arm here are reaped by the caller's next call
+        if (!receiveArmed_) {
+            armReceiveLocked();
+        }
+    }
+    return batch.size();
+}
+
+UdpIoUringStats UdpIoUring::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+void UdpIoUring::armReceiveLocked() {
+    struct io_uring_sqe* sqe = static_cast<struct io_uring_sqe*>(nextSqeLocked());
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = socketFd_;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = BUFFER_GROUP;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->user_data = RECEIVE_TAG;
+    if (enterLocked(1, 0) == 1) {
+        receiveArmed_ = true;
+        stats_.rearms++;
+    }
+}
+
+int UdpIoUring::enterLocked(unsigned submit, unsigned waitFor) {
+    int result;
+    do {
+        result = ioUringEnter(ringFd_, submit, waitFor, waitFor > 0 ? IORING_ENTER_GETEVENTS : 0);
+        stats_.enters++;
+    } while (result < 0 && errno == EINTR);
+    return result;
+}
+
+void UdpIoUring::reapLocked() {
+    unsigned head = *cqHead_;
+    unsigned tail = __atomic_load_n(cqTail_, __ATOMIC_ACQUIRE);
+    struct io_uring_cqe* cqes = static_cast<struct io_uring_cqe*>(cqes_);
+
+    for (; head != tail; head++) {
+        const struct io_uring_cqe& cqe = cqes[head & cqMask_];
+        if (cqe.user_data == SEND_TAG) {
+            sendsInFlight_--;
+            if (cqe.res >= 0) {
+                sendsSucceeded_++;
+            } else if (sendError_ == 0) {
+                sendError_ = -cqe.res;
+            }
+            continue;
+        }
+
+        if (!(cqe.flags & IORING_CQE_F_MORE)) {
+            receiveArmed_ = false;  // Ended (e.g. ENOBUFS); re-armed once buffers are back
+        }
+        if (cqe.res >= 0 && (cqe.flags & IORING_CQE_F_BUFFER)) {
+            Received entry;
+            entry.bufferId = static_cast<uint16_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT);
+            entry.length = cqe.res;
+            received_.push_back(entry);
+            stats_.received++;
+            if (static_cast<size_t>(cqe.res) > config_.bufferSize) {
+                stats_.truncated++;
+            }
+        }
+    }
+    __atomic_store_n(cqHead_, head, __ATOMIC_RELEASE);
+}
+
+// io_uring_buf_ring::bufs is offset by its empty-struct member under C++, so index the entries directly
+void UdpIoUring::recycleLocked(uint16_t bufferId) {
+    struct io_uring_buf* buffer = static_cast<struct io_uring_buf*>(bufferRing_) +
+                                  (bufferRingTail_ & (receiveEntries_ - 1));
+    buffer->addr = reinterpret_cast<uint64_t>(receiveMemory_ + static_cast<size_t>(bufferId) * (config_.bufferSize + 1));
+    buffer->len = static_cast<uint32_t>(config_.bufferSize + 1);
+    buffer->bid = bufferId;
+    bufferRingTail_++;
+}
+
+void UdpIoUring::publishBuffersLocked() {
+    // The ring tail overlays the reserved field of the first entry
+    struct io_uring_buf* first = static_cast<struct io_uring_buf*>(bufferRing_);
+    __atomic_store_n(&first->resv, bufferRingTail_, __ATOMIC_RELEASE);
+}
+
+void* UdpIoUring::nextSqeLocked() {
+    unsigned tail = *sqTail_;
+    unsigned index = tail & sqMask_;
+    struct io_uring_sqe* sqe = &static_cast<struct io_uring_sqe*>(sqes_)[index];
+    std::memset(sqe, 0, sizeof(*sqe));
+    sqArray_[index] = index;
+    // No SQPOLL: the kernel reads the entry only in the next io_uring_enter, after it is filled in
+    __atomic_store_n(sqTail_, tail + 1, __ATOMIC_RELEASE);
+    return sqe;
+}
+
+#else // HMDEV_MESSAGING_IO_URING
+
+std::unique_ptr<UdpIoUring> UdpIoUring::create(int, const UdpIoUringConfig&) {
+    std::cerr << "io_uring UDP backend not built (ENABLE_IO_URING=OFF)" << std::endl;
+    return nullptr;
+}
+
+UdpIoUring::~UdpIoUring() = default;
+
+size_t UdpIoUring::send(const std::vector<std::string>&, size_t) {
+    errno = ENOSYS;
+    return 0;
+}
+
+size_t UdpIoUring::receive(const DatagramHandler&, size_t) {
+    return 0;
+}
+
+UdpIoUringStats UdpIoUring::getStats() const {
+    return stats_;
+}
+
+#endif // HMDEV_MESSAGING_IO_URING
+
+} // namespace messaging
+} // namespace hmdev
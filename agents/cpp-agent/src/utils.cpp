@@ -13,12 +13,15 @@ long long Utils::getCurrentTimeMillis() {
 }
 
 bool Utils::parseUrl(const std::string& url, std::string& host, int& port) {
-    // Simple URL parser: protocol://host:port/path
-    std::regex urlRegex(R"(^(https?://)?([^:/]+)(:(\d+))?(/.*)?$)");
+    // Simple URL parser: protocol://host:port/path (IPv6 hosts in brackets)
+    std::regex urlRegex(R"(^(https?://)?(\[[0-9A-Fa-f:.]+\]|[^:/\[\]]+)(:(\d+))?(/.*)?$)");
     std::smatch match;
 
     if (std::regex_match(url, match, urlRegex)) {
         host = match[2].str();
+        if (host.front() == '[') {
+            host = host.substr(1, host.size() - 2);
+        }
         if (match[4].matched) {
             port = std::stoi(match[4].str());
         } else {
@@ -0,0 +1,202 @@
+/**
+ * Reliable UDP Test
+ * Gaps are only passed over after the sender gives up on them; a
+ * retransmission that arrives after the reorder buffer filled up is still
+ * delivered, once, and in order on ordered channels
+ */
+
+#include "hmdev/messaging/util/reliable_udp.h"
+#include <iostream>
+#include <functional>
+#include <atomic>
+#include <vector>
+
+using namespace hmdev::messaging;
+
+static std::atomic<int> failures(0);
+
+#define CHECK(condition)                                                        \
+    do {                                                                        \
+        if (!(condition)) {                                                     \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK failed: "      \
+                      << #condition << std::endl;                               \
+            failures++;                                                         \
+        }                                                                       \
+    } while (0)
+
+using Clock = ReliableUdpEndpoint::Clock;
+
+// Decides per datagram from sender to receiver whether it is lost
+using LossRule = std::function<bool(const json& datagram)>;
+
+static bool isData(const json& datagram, uint64_t seq) {
+    return datagram.contains("reliable") && datagram["reliable"]["seq"] == seq;
+}
+
+/**
+ * Sender and receiver endpoints joined by a link that loses chosen
+ * sender datagrams; time advances only when step() is called
+ */
+struct Link {
+    ReliableUdpEndpoint sender;
+    ReliableUdpEndpoint receiver;
+    Clock::time_point now;
+    std::vector<json> delivered;
+
+    explicit Link(const ReliableUdpConfig& config)
+        : sender(config), receiver(config), now(Clock::now()) {}
+
+    void send(int value, bool ordered, const LossRule& lost) {
+        json datagram = {{"action", "push"}, {"payload", {{"value", value}}}};
+        CHECK(sender.prepare(datagram, 0, ordered, now));
+        transmit({datagram}, lost);
+    }
+
+    void transmit(const std::vector<json>& datagrams, const LossRule& lost) {
+        for (json datagram : datagrams) {
+            if (ReliableUdpEndpoint::isReliable(datagram) && lost && lost(datagram)) {
+                continue;
+            }
+            receiver.receive(datagram, now, delivered);
+        }
+
+        // Acknowledgements always arrive
+        std::vector<json> acks;
+        receiver.poll(now, acks);
+        std::vector<json> ignored;
+        for (auto& ack : acks) {
+            sender.receive(ack, now, ignored);
+        }
+    }
+
+    void step(int ms, const LossRule& lost) {
+        now += std::chrono::milliseconds(ms);
+        std::vector<json> outgoing;
+        sender.poll(now, outgoing);
+        transmit(outgoing, lost);
+    }
+
+    std::vector<int> values() const {
+        std::vector<int> result;
+        for (const auto& message : delivered) {
+            result.push_back(message["payload"]["value"].get<int>());
+        }
+        return result;
+    }
+};
+
+static ReliableUdpConfig smallBufferConfig() {
+    ReliableUdpConfig config;
+    config.initialRtoMs = 100;
+    config.maxReorderBuffer = 4;
+    return config;
+}
+
+static std::vector<int> range(int first, int last) {
+    std::vector<int> values;
+    for (int value = first; value <= last; value++) {
+        values.push_back(value);
+    }
+    return values;
+}
+
+static void testRetransmissionAfterFullBuffer(bool ordered) {
+    Link link(smallBufferConfig());
+
+    // Sequence 1 is lost once; 2..10 arrive but only 4 fit above the gap
+    bool firstLost = false;
+    LossRule loseFirstOnce = [&](const json& datagram) {
+        if (isData(datagram, 1) && !firstLost) {
+            firstLost = true;
+            return true;
+        }
+        return false;
+    };
+    for (int value = 1; value <= 10; value++) {
+        link.send(value, ordered, loseFirstOnce);
+    }
+    CHECK(link.receiver.getStats().overflows == 5);
+    CHECK(link.receiver.getStats().skipped == 0);
+    CHECK(link.values() == (ordered ? std::vector<int>() : range(2, 5)));
+
+    // The retransmission of 1 and of the unacknowledged 6..10 are all delivered
+    for (int i = 0; i < 10 && link.sender.getStats().inFlight > 0; i++) {
+        link.step(250, nullptr);
+    }
+
+    std::vector<int> values = link.values();
+    if (ordered) {
+        CHECK(values == range(1, 10));
+    } else {
+        std::vector<int> expected = range(2, 5);
+        expected.push_back(1);
+        for (int value = 6; value <= 10; value++) {
+            expected.push_back(value);
+        }
+        CHECK(values == expected);
+    }
+
+    ReliableUdpStats sender = link.sender.getStats();
+    ReliableUdpStats receiver = link.receiver.getStats();
+    CHECK(sender.inFlight == 0);
+    CHECK(sender.failed == 0);
+    CHECK(receiver.delivered == 10);
+    CHECK(receiver.skipped == 0);
+}
+
+static void testGapSkippedOnlyAfterSenderGivesUp() {
+    ReliableUdpConfig config = smallBufferConfig();
+    config.maxRetransmits = 2;
+    Link link(config);
+
+    // Every transmission of 2 is lost, and so is the first skip notice
+    bool noticeLost = false;
+    LossRule lose = [&](const json& datagram) {
+        if (isData(datagram, 2)) {
+            return true;
+        }
+        if (datagram.value("action", "") == "skip" && !noticeLost) {
+            noticeLost = true;
+            return true;
+        }
+        return false;
+    };
+    for (int value = 1; value <= 4; value++) {
+        link.send(value, true, lose);
+    }
+    CHECK(link.values() == std::vector<int>{1});
+
+    // Held back while the sender still retransmits 2
+    link.step(150, lose);
+    CHECK(link.values() == std::vector<int>{1});
+    CHECK(link.receiver.getStats().skipped == 0);
+
+    for (int i = 0; i < 20 && link.values().size() < 3; i++) {
+        link.step(250, lose);
+    }
+    CHECK(noticeLost);
+    CHECK(link.sender.getStats().failed == 1);
+    CHECK(link.receiver.getStats().skipped == 1);
+    CHECK(link.values() == (std::vector<int>{1, 3, 4}));
+
+    // The receiver acknowledged past the gap, so the notices stop
+    link.step(5000, lose);
+    CHECK(link.sender.nextDeadline() == Clock::time_point::max());
+
+    // Later messages flow normally
+    link.send(5, true, lose);
+    CHECK(link.values() == (std::vector<int>{1, 3, 4, 5}));
+}
+
+int main() {
+    testRetransmissionAfterFullBuffer(false);
+    testRetransmissionAfterFullBuffer(true);
+    testGapSkippedOnlyAfterSenderGivesUp();
+
+    if (failures > 0) {
+        std::cerr << failures << " check(s) failed" << std::endl;
+        return 1;
+    }
+    std::cout << "reliable_udp_test passed" << std::endl;
+    return 0;
+}
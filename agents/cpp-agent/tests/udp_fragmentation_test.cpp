@@ -0,0 +1,117 @@
+/**
+ * UDP Fragmentation Test
+ * Split datagrams reassemble in any order, and forged fragment headers
+ * cannot make the reassembler hold more than maxBytes
+ */
+
+#include "hmdev/messaging/util/udp_fragmentation.h"
+#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <vector>
+
+using namespace hmdev::messaging;
+
+static std::atomic<int> failures(0);
+
+#define CHECK(condition)                                                        \
+    do {                                                                        \
+        if (!(condition)) {                                                     \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK failed: "      \
+                      << #condition << std::endl;                               \
+            failures++;                                                         \
+        }                                                                       \
+    } while (0)
+
+// Fragment header with an arbitrary index and count followed by payloadLength bytes
+static std::string forge(uint32_t messageId, uint16_t index, uint16_t count, size_t payloadLength) {
+    std::string fragment;
+    fragment.push_back(static_cast<char>(0xF7));
+    fragment.push_back(static_cast<char>(1));
+    for (int shift = 24; shift >= 0; shift -= 8) {
+        fragment.push_back(static_cast<char>((messageId >> shift) & 0xFF));
+    }
+    fragment.push_back(static_cast<char>(index >> 8));
+    fragment.push_back(static_cast<char>(index & 0xFF));
+    fragment.push_back(static_cast<char>(count >> 8));
+    fragment.push_back(static_cast<char>(count & 0xFF));
+    fragment.append(payloadLength, 'x');
+    return fragment;
+}
+
+static bool add(UdpReassembler& reassembler, const std::string& fragment, std::string& message) {
+    return reassembler.add(fragment.data(), fragment.size(), message);
+}
+
+static void testRoundTripInAnyOrder() {
+    std::string datagram;
+    for (int i = 0; i < 5000; i++) {
+        datagram.push_back(static_cast<char>('a' + i % 26));
+    }
+    std::vector<std::string> fragments;
+    CHECK(UdpFragmentation::split(datagram, 1200, 7, fragments) == 5);
+
+    // Final (short) fragment first
+    std::reverse(fragments.begin(), fragments.end());
+    UdpReassembler reassembler;
+    std::string message;
+    for (size_t i = 0; i < fragments.size(); i++) {
+        bool done = add(reassembler, fragments[i], message);
+        CHECK(done == (i + 1 == fragments.size()));
+    }
+    CHECK(message == datagram);
+    CHECK(reassembler.getStats().bufferedBytes == 0);
+    CHECK(reassembler.getStats().rejected == 0);
+}
+
+static void testForgedHeaders() {
+    UdpReassemblyConfig config;
+    config.maxBytes = 256 * 1024;
+    config.maxMessageSize = 64 * 1024;
+    UdpReassembler reassembler(config);
+    std::string message;
+
+    // Header-only fragments are never produced by split()
+    CHECK(!add(reassembler, forge(1, 0, 65535, 0), message));
+    CHECK(!add(reassembler, forge(2, 65534, 65535, 0), message));
+    CHECK(reassembler.getStats().rejected == 2);
+    CHECK(reassembler.getStats().bufferedBytes == 0);
+
+    // A full-size fragment bounds the count by maxMessageSize
+    CHECK(!add(reassembler, forge(3, 0, 65535, 100), message));
+    CHECK(reassembler.getStats().rejected == 3);
+
+    // Short final fragments are charged for the slots they claim: beyond maxBytes they are
+    // rejected outright, below it older partial messages are evicted to make room
+    uint64_t rejected = reassembler.getStats().rejected;
+    CHECK(!add(reassembler, forge(4, 65534, 65535, 1), message));
+    CHECK(reassembler.getStats().rejected == rejected + 1);
+    for (uint32_t id = 100; id < 1100; id++) {
+        add(reassembler, forge(id, 3999, 4000, 1), message);
+        CHECK(reassembler.getStats().bufferedBytes <= config.maxBytes);
+    }
+    CHECK(reassembler.getStats().evictions >= 990);
+
+    // Non-final fragments must all have the chunk size, and the final one must not exceed it
+    UdpReassembler sizes(config);
+    CHECK(!add(sizes, forge(10, 0, 4, 1000), message));
+    CHECK(!add(sizes, forge(10, 1, 4, 999), message));
+    CHECK(sizes.getStats().rejected == 1);
+    CHECK(!add(sizes, forge(11, 3, 4, 1200), message));
+    CHECK(!add(sizes, forge(11, 0, 4, 1000), message));
+    CHECK(sizes.getStats().rejected == 2);
+    CHECK(sizes.getStats().bufferedBytes == 0);
+}
+
+int main() {
+    testRoundTripInAnyOrder();
+    testForgedHeaders();
+
+    if (failures > 0) {
+        std::cerr << failures << " check(s) failed" << std::endl;
+        return 1;
+    }
+    std::cout << "udp_fragmentation_test passed" << std::endl;
+    return 0;
+}
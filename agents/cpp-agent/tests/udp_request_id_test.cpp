@@ -0,0 +1,181 @@
+/**
+ * UDP Request ID Test
+ * Replies are matched to their requests by a string requestId, as sent by
+ * the Java and Python agents, and id-less replies are never taken for pushes
+ */
+
+#include "hmdev/messaging/api/udp_client.h"
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <unistd.h>
+#include <cstring>
+#include <algorithm>
+#include <iostream>
+#include <thread>
+#include <atomic>
+#include <vector>
+
+using namespace hmdev::messaging;
+
+static std::atomic<int> failures(0);
+
+#define CHECK(condition)                                                        \
+    do {                                                                        \
+        if (!(condition)) {                                                     \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK failed: "      \
+                      << #condition << std::endl;                               \
+            failures++;                                                         \
+        }                                                                       \
+    } while (0)
+
+/**
+ * Local reply server; echoes the request ID as a string, or leaves it out
+ * and sends a push datagram before the reply
+ */
+class ReplyServer {
+public:
+    explicit ReplyServer(bool echoRequestId)
+        : echoRequestId_(echoRequestId), running_(true), fd_(socket(AF_INET, SOCK_DGRAM, 0)), port_(0) {
+        struct sockaddr_in addr;
+        std::memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t addrLen = sizeof(addr);
+        if (fd_ >= 0 && bind(fd_, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) == 0 &&
+            getsockname(fd_, reinterpret_cast<struct sockaddr*>(&addr), &addrLen) == 0) {
+            port_ = ntohs(addr.sin_port);
+        }
+        thread_ = std::thread(&ReplyServer::run, this);
+    }
+
+    ~ReplyServer() {
+        running_ = false;
+        thread_.join();
+        if (fd_ >= 0) {
+            ::close(fd_);
+        }
+    }
+
+    int port() const { return port_; }
+
+private:
+    const bool echoRequestId_;
+    std::atomic<bool> running_;
+    int fd_;
+    int port_;
+    std::thread thread_;
+
+    void send(const json& datagram, const struct sockaddr_storage& peer, socklen_t peerLen) {
+        std::string data = datagram.dump();
+        sendto(fd_, data.data(), data.size(), 0, reinterpret_cast<const struct sockaddr*>(&peer), peerLen);
+    }
+
+    void run() {
+        char buffer[65536];
+        while (running_) {
+            struct pollfd pfd = {fd_, POLLIN, 0};
+            if (poll(&pfd, 1, 10) <= 0) {
+                continue;
+            }
+
+            struct sockaddr_storage peer;
+            socklen_t peerLen = sizeof(peer);
+            ssize_t received = recvfrom(fd_, buffer, sizeof(buffer), 0,
+                                        reinterpret_cast<struct sockaddr*>(&peer), &peerLen);
+            json request = json::parse(buffer, buffer + std::max<ssize_t>(received, 0), nullptr, false);
+            if (request.is_discarded() || !request.contains("payload")) {
+                continue;
+            }
+
+            json reply = {{"status", "ok"}, {"result", {{"data", {{"nonce", request["payload"]["nonce"]}}}}}};
+            if (echoRequestId_) {
+                CHECK(request["requestId"].is_string());
+                reply["requestId"] = request["requestId"].is_string()
+                    ? request["requestId"].get<std::string>() : request["requestId"].dump();
+            } else {
+                send(json{{"type", "GAME_STATE"}, {"content", "push"}}, peer, peerLen);
+            }
+            send(reply, peer, peerLen);
+        }
+    }
+};
+
+static void testEnvelopeRequestIdTypes() {
+    UdpEnvelope envelope = UdpEnvelope::fromJson(json{{"action", "pull"}, {"requestId", "42"}});
+    CHECK(envelope.requestId == "42");
+    CHECK(envelope.toJson()["requestId"] == "42");
+
+    envelope = UdpEnvelope::fromJson(json{{"action", "pull"}, {"requestId", 7}});
+    CHECK(envelope.requestId == "7");
+
+    // Unexpected types are ignored instead of thrown on
+    envelope = UdpEnvelope::fromJson(json{{"action", 3}, {"requestId", {{"id", 1}}}});
+    CHECK(envelope.action.empty());
+    CHECK(envelope.requestId.empty());
+    CHECK(!envelope.toJson().contains("requestId"));
+    envelope = UdpEnvelope::fromJson(json::array());
+    CHECK(envelope.action.empty());
+}
+
+static void testStringEchoFromConcurrentPulls() {
+    ReplyServer server(true);
+    UdpClientConfig config;
+    config.addressFamily = AF_INET;
+    UdpClient client("127.0.0.1", server.port(), config);
+
+    std::atomic<int> matched(0);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 4; t++) {
+        workers.emplace_back([&, t]() {
+            for (int i = 0; i < 50; i++) {
+                int nonce = t * 1000 + i;
+                json response = client.sendAndWait(UdpEnvelope("pull", json{{"nonce", nonce}}), 2000);
+                if (!response.is_null() && response["result"]["data"]["nonce"] == nonce) {
+                    matched++;
+                }
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    CHECK(matched == 200);
+    CHECK(client.getStats().staleReplies == 0);
+}
+
+static void testReplyWithoutIdIsNotAPush() {
+    ReplyServer server(false);
+    UdpClientConfig config;
+    config.addressFamily = AF_INET;
+    UdpClient client("127.0.0.1", server.port(), config);
+    CHECK(client.startReceiver());
+
+    for (int nonce = 0; nonce < 10; nonce++) {
+        json response = client.sendAndWait(UdpEnvelope("pull", json{{"nonce", nonce}}), 2000);
+        CHECK(!response.is_null() && response["result"]["data"]["nonce"] == nonce);
+    }
+
+    // Only the server's pushes reach the queue
+    std::vector<json> pushes;
+    client.receiveBatch(pushes, 100);
+    CHECK(pushes.size() == 10);
+    for (const auto& push : pushes) {
+        CHECK(!push.contains("status"));
+    }
+    client.stopReceiver();
+}
+
+int main() {
+    testEnvelopeRequestIdTypes();
+    testStringEchoFromConcurrentPulls();
+    testReplyWithoutIdIsNotAPush();
+
+    if (failures > 0) {
+        std::cerr << failures << " check(s) failed" << std::endl;
+        return 1;
+    }
+    std::cout << "udp_request_id_test passed" << std::endl;
+    return 0;
+}